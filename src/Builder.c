@@ -20,25 +20,8 @@ int Builder_SidesLevel, Builder_EdgeLevel;
 /* Packs an index into the 18x18x18 chunk array. Coordinates range from -1 to 16. */
 #define Builder_PackChunk(xx, yy, zz) (((yy) + 1) * EXTCHUNK_SIZE_2 + ((zz) + 1) * EXTCHUNK_SIZE + ((xx) + 1))
 
-static BlockID* Builder_Chunk;
-static cc_uint8* Builder_Counts;
-static int* Builder_BitFlags;
-static cc_bool Builder_UseBitFlags;
-static int Builder_X, Builder_Y, Builder_Z;
-static BlockID Builder_Block;
-static int Builder_ChunkIndex;
-static cc_bool Builder_FullBright;
-static cc_bool Builder_Tinted;
-static int Builder_ChunkEndX, Builder_ChunkEndZ;
 static int Builder_Offsets[FACE_COUNT] = { -1,1, -EXTCHUNK_SIZE,EXTCHUNK_SIZE, -EXTCHUNK_SIZE_2,EXTCHUNK_SIZE_2 };
 
-static int (*Builder_StretchXLiquid)(int countIndex, int x, int y, int z, int chunkIndex, BlockID block);
-static int (*Builder_StretchX)(int countIndex, int x, int y, int z, int chunkIndex, BlockID block, Face face);
-static int (*Builder_StretchZ)(int countIndex, int x, int y, int z, int chunkIndex, BlockID block, Face face);
-static void (*Builder_RenderBlock)(int countsIndex);
-static void (*Builder_PreStretchTiles)(void);
-static void (*Builder_PostStretchTiles)(void);
-
 /* Contains state for vertices for a portion of a chunk mesh (vertices that are in a 1D atlas) */
 struct Builder1DPart {
 	struct VertexTextured* fVertices[FACE_COUNT];
@@ -46,10 +29,52 @@ struct Builder1DPart {
 	int sCount, sOffset, sAdvance;
 };
 
-/* Part builder data, for both normal and translucent parts.
-The first ATLAS1D_MAX_ATLASES parts are for normal parts, remainder are for translucent parts. */
-static struct Builder1DPart Builder_Parts[ATLAS1D_MAX_ATLASES * 2];
-static struct VertexTextured* Builder_Vertices;
+/* Contains all the state used while building the mesh of a chunk. */
+/* NOTE: Each mesh building thread has its own context, so chunks can be built concurrently. */
+struct BuilderContext {
+	BlockID* Chunk;
+	cc_uint8* Counts;
+	cc_uint8* Rows; /* Number of rows merged into each face (greedy mesh builder only) */
+	int* BitFlags;
+	int X, Y, Z;
+	BlockID Block;
+	int ChunkIndex;
+	cc_bool FullBright;
+	cc_bool Tinted;
+	int ChunkEndX, ChunkEndZ;
+	RNGState SpriteRng;
+	/* Part builder data, for both normal and translucent parts.
+	The first ATLAS1D_MAX_ATLASES parts are for normal parts, remainder are for translucent parts. */
+	struct Builder1DPart Parts[ATLAS1D_MAX_ATLASES * 2];
+	struct VertexTextured* Vertices;
+	/* Cuboid state used by the normal mesh builder */
+	struct _DrawerData Drawer;
+	/* State used by the advanced mesh builder */
+	struct AdvBuilderState {
+		Vec3 minBB, maxBB;
+		int initBitFlags, lightFlags, baseOffset;
+		int* bitFlags;
+		float x1, y1, z1, x2, y2, z2;
+		PackedCol lerp[5], lerpX[5], lerpZ[5], lerpY[5];
+	} adv;
+};
+
+/* A chunk whose mesh is to be built, and the vertices of that mesh once built */
+struct ChunkMesh {
+	struct ChunkInfo* info;
+	struct VertexTextured* vertices; /* NULL when the chunk has no mesh */
+	int verticesCount;
+	cc_bool allAir, hasNorm, hasTran;
+	cc_uint8 connects[FACE_COUNT]; /* see ChunkInfo.Connects */
+};
+
+static int (*Builder_StretchXLiquid)(struct BuilderContext* ctx, int countIndex, int x, int y, int z, int chunkIndex, BlockID block);
+static int (*Builder_StretchX)(struct BuilderContext* ctx, int countIndex, int x, int y, int z, int chunkIndex, BlockID block, Face face);
+static int (*Builder_StretchZ)(struct BuilderContext* ctx, int countIndex, int x, int y, int z, int chunkIndex, BlockID block, Face face);
+static void (*Builder_RenderBlock)(struct BuilderContext* ctx, int countsIndex);
+static void (*Builder_PreStretchTiles)(struct BuilderContext* ctx);
+static void (*Builder_PostStretchTiles)(struct BuilderContext* ctx);
+static void (*Builder_MergeRows)(struct BuilderContext* ctx, int x1, int y1, int z1);
 
 static int Builder1DPart_VerticesCount(struct Builder1DPart* part) {
 	int i, count = part->sCount;
@@ -57,23 +82,23 @@ static int Builder1DPart_VerticesCount(struct Builder1DPart* part) {
 	return count;
 }
 
-static int Builder1DPart_CalcOffsets(struct Builder1DPart* part, int offset) {
+static int Builder1DPart_CalcOffsets(struct Builder1DPart* part, struct VertexTextured* vertices, int offset) {
 	int i;
 	part->sOffset  = offset;
 	part->sAdvance = part->sCount >> 2;
 
 	offset += part->sCount;
 	for (i = 0; i < FACE_COUNT; i++) {
-		part->fVertices[i] = &Builder_Vertices[offset];
+		part->fVertices[i] = &vertices[offset];
 		offset += part->fCount[i];
 	}
 	return offset;
 }
 
-static int Builder_TotalVerticesCount(void) {
+static int Builder_TotalVerticesCount(struct BuilderContext* ctx) {
 	int i, count = 0;
 	for (i = 0; i < ATLAS1D_MAX_ATLASES * 2; i++) {
-		count += Builder1DPart_VerticesCount(&Builder_Parts[i]);
+		count += Builder1DPart_VerticesCount(&ctx->Parts[i]);
 	}
 	return count;
 }
@@ -82,28 +107,35 @@ static int Builder_TotalVerticesCount(void) {
 /*########################################################################################################################*
 *----------------------------------------------------Base mesh builder----------------------------------------------------*
 *#########################################################################################################################*/
-static void AddSpriteVertices(BlockID block) {
+static void AddSpriteVertices(struct BuilderContext* ctx, BlockID block) {
 	int i = Atlas1D_Index(Block_Tex(block, FACE_XMAX));
-	struct Builder1DPart* part = &Builder_Parts[i];
+	struct Builder1DPart* part = &ctx->Parts[i];
 	part->sCount += 4 * 4;
 }
 
-static void AddVertices(BlockID block, Face face) {
+static void AddVertices(struct BuilderContext* ctx, BlockID block, Face face) {
 	int baseOffset = (Blocks.Draw[block] == DRAW_TRANSLUCENT) * ATLAS1D_MAX_ATLASES;
 	int i = Atlas1D_Index(Block_Tex(block, face));
-	struct Builder1DPart* part = &Builder_Parts[baseOffset + i];
+	struct Builder1DPart* part = &ctx->Parts[baseOffset + i];
 	part->fCount[face] += 4;
 }
 
+static void RemoveVertices(struct BuilderContext* ctx, BlockID block, Face face) {
+	int baseOffset = (Blocks.Draw[block] == DRAW_TRANSLUCENT) * ATLAS1D_MAX_ATLASES;
+	int i = Atlas1D_Index(Block_Tex(block, face));
+	struct Builder1DPart* part = &ctx->Parts[baseOffset + i];
+	part->fCount[face] -= 4;
+}
+
 #ifdef CC_BUILD_GL11
-static void BuildPartVbs(struct ChunkPartInfo* info) {
+static void BuildPartVbs(struct ChunkPartInfo* info, struct VertexTextured* vertices) {
 	/* Sprites vertices are stored before chunk face sides */
 	int i, count, offset = info->Offset + info->SpriteCount;
 	for (i = 0; i < FACE_COUNT; i++) {
 		count = info->Counts[i];
 
 		if (count) {
-			info->Vbs[i] = Gfx_CreateVb2(&Builder_Vertices[offset], VERTEX_FORMAT_TEXTURED, count);
+			info->Vbs[i] = Gfx_CreateVb2(&vertices[offset], VERTEX_FORMAT_TEXTURED, count);
 			offset += count;
 		} else {
 			info->Vbs[i] = 0;
@@ -113,7 +145,7 @@ static void BuildPartVbs(struct ChunkPartInfo* info) {
 	count  = info->SpriteCount;
 	offset = info->Offset;
 	if (count) {
-		info->Vbs[i] = Gfx_CreateVb2(&Builder_Vertices[offset], VERTEX_FORMAT_TEXTURED, count);
+		info->Vbs[i] = Gfx_CreateVb2(&vertices[offset], VERTEX_FORMAT_TEXTURED, count);
 	} else {
 		info->Vbs[i] = 0;
 	}
@@ -136,14 +168,10 @@ static void SetPartInfo(struct Builder1DPart* part, int* offset, struct ChunkPar
 	info->Counts[FACE_YMIN] = part->fCount[FACE_YMIN];
 	info->Counts[FACE_YMAX] = part->fCount[FACE_YMAX];
 	info->SpriteCount       = part->sCount;
-
-#ifdef CC_BUILD_GL11
-	BuildPartVbs(info);
-#endif
 }
 
 
-static void Builder_Stretch(int x1, int y1, int z1) {
+static void Builder_Stretch(struct BuilderContext* ctx, int x1, int y1, int z1) {
 	int xMax = min(World.Width,  x1 + CHUNK_SIZE);
 	int yMax = min(World.Height, y1 + CHUNK_SIZE);
 	int zMax = min(World.Length, z1 + CHUNK_SIZE);
@@ -151,90 +179,76 @@ static void Builder_Stretch(int x1, int y1, int z1) {
 	int cIndex, index, tileIdx;
 	BlockID b;
 	int x, y, z, xx, yy, zz;
-
-#ifdef OCCLUSION
-	int flags = ComputeOcclusion();
-#endif
-#ifdef DEBUG_OCCLUSION
-	FastColour col = new FastColour(60, 60, 60, 255);
-	if (flags & 1) col.R = 255; /* x */
-	if (flags & 4) col.G = 255; /* y */
-	if (flags & 2) col.B = 255; /* z */
-	map.Sunlight = map.Shadowlight = col;
-	map.SunlightXSide = map.ShadowlightXSide = col;
-	map.SunlightZSide = map.ShadowlightZSide = col;
-	map.SunlightYBottom = map.ShadowlightYBottom = col;
-#endif
 	
 	for (y = y1, yy = 0; y < yMax; y++, yy++) {
 		for (z = z1, zz = 0; z < zMax; z++, zz++) {
 			cIndex = Builder_PackChunk(0, yy, zz);
 
 			for (x = x1, xx = 0; x < xMax; x++, xx++, cIndex++) {
-				b = Builder_Chunk[cIndex];
+				b = ctx->Chunk[cIndex];
 				if (Blocks.Draw[b] == DRAW_GAS) continue;
 				index = Builder_PackCount(xx, yy, zz);
 
 				/* Sprites can't be stretched, nor can then be they hidden by other blocks. */
 				/* Note sprites are drawn using DrawSprite and not with any of the DrawXFace. */
-				if (Blocks.Draw[b] == DRAW_SPRITE) { AddSpriteVertices(b); continue; }
+				if (Blocks.Draw[b] == DRAW_SPRITE) { AddSpriteVertices(ctx, b); continue; }
 
-				Builder_X = x; Builder_Y = y; Builder_Z = z;
-				Builder_FullBright = Blocks.FullBright[b];
+				ctx->X = x; ctx->Y = y; ctx->Z = z;
+				ctx->FullBright = Blocks.FullBright[b];
 				tileIdx = b * BLOCK_COUNT;
 				/* All of these function calls are inlined as they can be called tens of millions to hundreds of millions of times. */
 
-				if (Builder_Counts[index] == 0 ||
+				if (ctx->Counts[index] == 0 ||
 					(x == 0 && (y < Builder_SidesLevel || (b >= BLOCK_WATER && b <= BLOCK_STILL_LAVA && y < Builder_EdgeLevel))) ||
-					(x != 0 && (Blocks.Hidden[tileIdx + Builder_Chunk[cIndex - 1]] & (1 << FACE_XMIN)) != 0)) {
-					Builder_Counts[index] = 0;
+					(x != 0 && (Blocks.Hidden[tileIdx + ctx->Chunk[cIndex - 1]] & (1 << FACE_XMIN)) != 0)) {
+					ctx->Counts[index] = 0;
 				} else {
-					Builder_Counts[index] = Builder_StretchZ(index, x, y, z, cIndex, b, FACE_XMIN);
+					ctx->Counts[index] = Builder_StretchZ(ctx, index, x, y, z, cIndex, b, FACE_XMIN);
 				}
 
 				index++;
-				if (Builder_Counts[index] == 0 ||
+				if (ctx->Counts[index] == 0 ||
 					(x == World.MaxX && (y < Builder_SidesLevel || (b >= BLOCK_WATER && b <= BLOCK_STILL_LAVA && y < Builder_EdgeLevel))) ||
-					(x != World.MaxX && (Blocks.Hidden[tileIdx + Builder_Chunk[cIndex + 1]] & (1 << FACE_XMAX)) != 0)) {
-					Builder_Counts[index] = 0;
+					(x != World.MaxX && (Blocks.Hidden[tileIdx + ctx->Chunk[cIndex + 1]] & (1 << FACE_XMAX)) != 0)) {
+					ctx->Counts[index] = 0;
 				} else {
-					Builder_Counts[index] = Builder_StretchZ(index, x, y, z, cIndex, b, FACE_XMAX);
+					ctx->Counts[index] = Builder_StretchZ(ctx, index, x, y, z, cIndex, b, FACE_XMAX);
 				}
 
 				index++;
-				if (Builder_Counts[index] == 0 ||
+				if (ctx->Counts[index] == 0 ||
 					(z == 0 && (y < Builder_SidesLevel || (b >= BLOCK_WATER && b <= BLOCK_STILL_LAVA && y < Builder_EdgeLevel))) ||
-					(z != 0 && (Blocks.Hidden[tileIdx + Builder_Chunk[cIndex - EXTCHUNK_SIZE]] & (1 << FACE_ZMIN)) != 0)) {
-					Builder_Counts[index] = 0;
+					(z != 0 && (Blocks.Hidden[tileIdx + ctx->Chunk[cIndex - EXTCHUNK_SIZE]] & (1 << FACE_ZMIN)) != 0)) {
+					ctx->Counts[index] = 0;
 				} else {
-					Builder_Counts[index] = Builder_StretchX(index, Builder_X, Builder_Y, Builder_Z, cIndex, b, FACE_ZMIN);
+					ctx->Counts[index] = Builder_StretchX(ctx, index, ctx->X, ctx->Y, ctx->Z, cIndex, b, FACE_ZMIN);
 				}
 
 				index++;
-				if (Builder_Counts[index] == 0 ||
+				if (ctx->Counts[index] == 0 ||
 					(z == World.MaxZ && (y < Builder_SidesLevel || (b >= BLOCK_WATER && b <= BLOCK_STILL_LAVA && y < Builder_EdgeLevel))) ||
-					(z != World.MaxZ && (Blocks.Hidden[tileIdx + Builder_Chunk[cIndex + EXTCHUNK_SIZE]] & (1 << FACE_ZMAX)) != 0)) {
-					Builder_Counts[index] = 0;
+					(z != World.MaxZ && (Blocks.Hidden[tileIdx + ctx->Chunk[cIndex + EXTCHUNK_SIZE]] & (1 << FACE_ZMAX)) != 0)) {
+					ctx->Counts[index] = 0;
 				} else {
-					Builder_Counts[index] = Builder_StretchX(index, x, y, z, cIndex, b, FACE_ZMAX);
+					ctx->Counts[index] = Builder_StretchX(ctx, index, x, y, z, cIndex, b, FACE_ZMAX);
 				}
 
 				index++;
-				if (Builder_Counts[index] == 0 || y == 0 ||
-					(Blocks.Hidden[tileIdx + Builder_Chunk[cIndex - EXTCHUNK_SIZE_2]] & (1 << FACE_YMIN)) != 0) {
-					Builder_Counts[index] = 0;
+				if (ctx->Counts[index] == 0 || y == 0 ||
+					(Blocks.Hidden[tileIdx + ctx->Chunk[cIndex - EXTCHUNK_SIZE_2]] & (1 << FACE_YMIN)) != 0) {
+					ctx->Counts[index] = 0;
 				} else {
-					Builder_Counts[index] = Builder_StretchX(index, x, y, z, cIndex, b, FACE_YMIN);
+					ctx->Counts[index] = Builder_StretchX(ctx, index, x, y, z, cIndex, b, FACE_YMIN);
 				}
 
 				index++;
-				if (Builder_Counts[index] == 0 ||
-					(Blocks.Hidden[tileIdx + Builder_Chunk[cIndex + EXTCHUNK_SIZE_2]] & (1 << FACE_YMAX)) != 0) {
-					Builder_Counts[index] = 0;
+				if (ctx->Counts[index] == 0 ||
+					(Blocks.Hidden[tileIdx + ctx->Chunk[cIndex + EXTCHUNK_SIZE_2]] & (1 << FACE_YMAX)) != 0) {
+					ctx->Counts[index] = 0;
 				} else if (b < BLOCK_WATER || b > BLOCK_STILL_LAVA) {
-					Builder_Counts[index] = Builder_StretchX(index, x, y, z, cIndex, b, FACE_YMAX);
+					ctx->Counts[index] = Builder_StretchX(ctx, index, x, y, z, cIndex, b, FACE_YMAX);
 				} else {
-					Builder_Counts[index] = Builder_StretchXLiquid(index, x, y, z, cIndex, b);
+					ctx->Counts[index] = Builder_StretchXLiquid(ctx, index, x, y, z, cIndex, b);
 				}
 			}
 		}
@@ -253,12 +267,12 @@ for (yy = -1; yy < 17; ++yy) {\
 			block    = get_block;\
 			allAir   = allAir   && Blocks.Draw[block] == DRAW_GAS;\
 			allSolid = allSolid && Blocks.FullOpaque[block];\
-			Builder_Chunk[cIndex] = block;\
+			ctx->Chunk[cIndex] = block;\
 		}\
 	}\
 }
 
-static cc_bool ReadChunkData(int x1, int y1, int z1, cc_bool* outAllAir) {
+static cc_bool ReadChunkData(struct BuilderContext* ctx, int x1, int y1, int z1, cc_bool* outAllAir) {
 	BlockRaw* blocks = World.Blocks;
 	BlockRaw* blocks2;
 	cc_bool allAir = true, allSolid = true;
@@ -302,12 +316,12 @@ for (yy = -1; yy < 17; ++yy) {\
 \
 			block  = get_block;\
 			allAir = allAir && Blocks.Draw[block] == DRAW_GAS;\
-			Builder_Chunk[cIndex] = block;\
+			ctx->Chunk[cIndex] = block;\
 		}\
 	}\
 }
 
-static cc_bool ReadBorderChunkData(int x1, int y1, int z1, cc_bool* outAllAir) {
+static cc_bool ReadBorderChunkData(struct BuilderContext* ctx, int x1, int y1, int z1, cc_bool* outAllAir) {
 	BlockRaw* blocks = World.Blocks;
 	BlockRaw* blocks2;
 	cc_bool allAir = true;
@@ -330,9 +344,59 @@ static cc_bool ReadBorderChunkData(int x1, int y1, int z1, cc_bool* outAllAir) {
 	return false;
 }
 
-static cc_bool BuildChunk(int x1, int y1, int z1, struct ChunkInfo* info) {
+#define Connectivity_Visit(cond, idx, xx, yy, zz)\
+if ((cond) && !visited[idx]) {\
+	visited[idx] = true;\
+	if (!Blocks.FullOpaque[ctx->Chunk[Builder_PackChunk(xx, yy, zz)]]) stack[count++] = idx;\
+}
+
+/* Calculates which faces of the chunk can be seen from each face of the chunk, */
+/*  by flood filling through the blocks in the chunk that are not fully opaque. */
+static void Builder_CalcConnectivity(struct BuilderContext* ctx, cc_uint8* connects) {
+	cc_bool visited[CHUNK_SIZE_3];
+	cc_uint16 stack[CHUNK_SIZE_3];
+	int i, idx, count, faces, face;
+	int x, y, z;
+
+	Mem_Set(connects, 0, FACE_COUNT);
+	Mem_Set(visited,  0, sizeof(visited));
+
+	for (i = 0; i < CHUNK_SIZE_3; i++) {
+		if (visited[i]) continue;
+		visited[i] = true;
+		x = i & CHUNK_MASK; z = (i >> CHUNK_SHIFT) & CHUNK_MASK; y = i >> (CHUNK_SHIFT * 2);
+		if (Blocks.FullOpaque[ctx->Chunk[Builder_PackChunk(x, y, z)]]) continue;
+
+		stack[0] = i; count = 1; faces = 0;
+		while (count) {
+			idx = stack[--count];
+			x = idx & CHUNK_MASK; z = (idx >> CHUNK_SHIFT) & CHUNK_MASK; y = idx >> (CHUNK_SHIFT * 2);
+
+			if (x == 0)         faces |= 1 << FACE_XMIN;
+			if (x == CHUNK_MAX) faces |= 1 << FACE_XMAX;
+			if (z == 0)         faces |= 1 << FACE_ZMIN;
+			if (z == CHUNK_MAX) faces |= 1 << FACE_ZMAX;
+			if (y == 0)         faces |= 1 << FACE_YMIN;
+			if (y == CHUNK_MAX) faces |= 1 << FACE_YMAX;
+
+			Connectivity_Visit(x > 0,         idx - 1,            x - 1, y, z);
+			Connectivity_Visit(x < CHUNK_MAX, idx + 1,            x + 1, y, z);
+			Connectivity_Visit(z > 0,         idx - CHUNK_SIZE,   x, y, z - 1);
+			Connectivity_Visit(z < CHUNK_MAX, idx + CHUNK_SIZE,   x, y, z + 1);
+			Connectivity_Visit(y > 0,         idx - CHUNK_SIZE_2, x, y - 1, z);
+			Connectivity_Visit(y < CHUNK_MAX, idx + CHUNK_SIZE_2, x, y + 1, z);
+		}
+
+		for (face = 0; face < FACE_COUNT; face++) {
+			if (faces & (1 << face)) connects[face] |= faces;
+		}
+	}
+}
+
+static cc_bool BuildChunk(struct BuilderContext* ctx, int x1, int y1, int z1, struct ChunkMesh* mesh) {
 	BlockID chunk[EXTCHUNK_SIZE_3]; 
 	cc_uint8 counts[CHUNK_SIZE_3 * FACE_COUNT]; 
+	cc_uint8 rows[CHUNK_SIZE_3 * FACE_COUNT];
 	int bitFlags[EXTCHUNK_SIZE_3];
 
 	cc_bool allAir, allSolid, onBorder;
@@ -340,10 +404,11 @@ static cc_bool BuildChunk(int x1, int y1, int z1, struct ChunkInfo* info) {
 	int cIndex, index;
 	int x, y, z, xx, yy, zz;
 
-	Builder_Chunk  = chunk;
-	Builder_Counts = counts;
-	Builder_BitFlags = bitFlags;
-	Builder_PreStretchTiles();
+	ctx->Chunk  = chunk;
+	ctx->Counts = counts;
+	ctx->Rows   = rows;
+	ctx->BitFlags = bitFlags;
+	Builder_PreStretchTiles(ctx);
 	
 	onBorder = 
 		x1 == 0 || y1 == 0 || z1 == 0   || x1 + CHUNK_SIZE >= World.Width ||
@@ -352,121 +417,209 @@ static cc_bool BuildChunk(int x1, int y1, int z1, struct ChunkInfo* info) {
 	if (onBorder) {
 		/* less optimal case here */
 		Mem_Set(chunk, BLOCK_AIR, EXTCHUNK_SIZE_3 * sizeof(BlockID));
-		allSolid = ReadBorderChunkData(x1, y1, z1, &allAir);
+		allSolid = ReadBorderChunkData(ctx, x1, y1, z1, &allAir);
 	} else {
-		allSolid = ReadChunkData(x1, y1, z1, &allAir);
+		allSolid = ReadChunkData(ctx, x1, y1, z1, &allAir);
 	}
 
-	info->AllAir = allAir;
-	if (allAir || allSolid) return false;
-	Lighting_LightHint(x1 - 1, z1 - 1);
+	mesh->allAir = allAir;
+	if (allAir || allSolid) {
+		Mem_Set(mesh->connects, allAir ? CHUNK_CONNECTS_ALL : 0, FACE_COUNT);
+		return false;
+	}
+
+	Builder_CalcConnectivity(ctx, mesh->connects);
 
 	Mem_Set(counts, 1, CHUNK_SIZE_3 * FACE_COUNT);
 	xMax = min(World.Width,  x1 + CHUNK_SIZE);
 	yMax = min(World.Height, y1 + CHUNK_SIZE);
 	zMax = min(World.Length, z1 + CHUNK_SIZE);
 
-	Builder_ChunkEndX = xMax; Builder_ChunkEndZ = zMax;
-	Builder_Stretch(x1, y1, z1);
+	ctx->ChunkEndX = xMax; ctx->ChunkEndZ = zMax;
+	Builder_Stretch(ctx, x1, y1, z1);
+
+	if (Builder_MergeRows) {
+		Mem_Set(rows, 1, CHUNK_SIZE_3 * FACE_COUNT);
+		Builder_MergeRows(ctx, x1, y1, z1);
+	}
 
-	totalVerts = Builder_TotalVerticesCount();
+	totalVerts = Builder_TotalVerticesCount(ctx);
 	if (!totalVerts) return false;
 
-#ifndef CC_BUILD_GL11
-	/* add an extra element to fix crashing on some GPUs */
-	Builder_Vertices = (struct VertexTextured*)Gfx_RecreateAndLockVb(&info->Vb,
-													VERTEX_FORMAT_TEXTURED, totalVerts + 1);
-#else
-	/* NOTE: Relies on assumption vb is ignored by GL11 Gfx_LockVb implementation */
-	Builder_Vertices = (struct VertexTextured*)Gfx_LockVb(0, 
-													VERTEX_FORMAT_TEXTURED, totalVerts + 1);
-#endif
-	Builder_PostStretchTiles();
+	/* Vertices can't be written directly into the vertex buffer, as this may not be the main thread */
+	ctx->Vertices = (struct VertexTextured*)Mem_Alloc(totalVerts, sizeof(struct VertexTextured), "chunk vertices");
+	mesh->vertices      = ctx->Vertices;
+	mesh->verticesCount = totalVerts;
+	Builder_PostStretchTiles(ctx);
 
 	for (y = y1, yy = 0; y < yMax; y++, yy++) {
 		for (z = z1, zz = 0; z < zMax; z++, zz++) {
 			cIndex = Builder_PackChunk(0, yy, zz);
 
 			for (x = x1, xx = 0; x < xMax; x++, xx++, cIndex++) {
-				Builder_Block = chunk[cIndex];
-				if (Blocks.Draw[Builder_Block] == DRAW_GAS) continue;
+				ctx->Block = chunk[cIndex];
+				if (Blocks.Draw[ctx->Block] == DRAW_GAS) continue;
 
 				index = Builder_PackCount(xx, yy, zz);
-				Builder_X = x; Builder_Y = y; Builder_Z = z;
-				Builder_ChunkIndex = cIndex;
-				Builder_RenderBlock(index);
+				ctx->X = x; ctx->Y = y; ctx->Z = z;
+				ctx->ChunkIndex = cIndex;
+				Builder_RenderBlock(ctx, index);
 			}
 		}
 	}
-
-#ifndef CC_BUILD_GL11
-	Gfx_UnlockVb(info->Vb);
-#endif
 	return true;
 }
 
-void Builder_MakeChunk(struct ChunkInfo* info) {
+/* Size in bytes of each vertex in built chunk meshes */
+#define MESH_VERTEX_SIZE (Builder_PackedVertices ? SIZEOF_VERTEX_PACKED : SIZEOF_VERTEX_TEXTURED)
+
+/* Converts the built vertices of the given chunk into VERTEX_FORMAT_PACKED vertices, in place */
+/* NOTE: Vertices are converted a quad at a time, as all 4 vertices of a quad are in the same 1D atlas row */
+static void PackVertices(struct ChunkMesh* mesh, int x1, int y1, int z1) {
+	struct VertexTextured* src = mesh->vertices;
+	struct VertexPacked* dst   = (struct VertexPacked*)mesh->vertices;
+	struct VertexTextured quad[4];
+	struct VertexTextured* v;
+	cc_bool tileRepeat;
+	float rowU, rowV;
+	int i, j, row;
+	void* mem;
+
+	for (i = 0; i < mesh->verticesCount; i += 4) {
+		/* Packed vertices are smaller, so this never overwrites vertices which haven't been read yet */
+		Mem_Copy(quad, &src[i], sizeof(quad));
+
+		tileRepeat = quad[0].U >= GFX_TILE_REPEAT_STRIDE - 8;
+
+		if (tileRepeat) {
+			/* Undo the U = u + (row + 1) * GFX_TILE_REPEAT_STRIDE encoding (see Gfx_EnableTileRepeat) */
+			row  = (int)(quad[0].U / GFX_TILE_REPEAT_STRIDE + 0.125f) - 1;
+			rowU = (float)((row + 1) * GFX_TILE_REPEAT_STRIDE);
+			rowV = 0.0f;
+		} else {
+			/* V is relative to the whole atlas, and never spans more than one tile within a quad */
+			rowV = min(min(quad[0].V, quad[1].V), min(quad[2].V, quad[3].V)) * Atlas1D.TilesPerAtlas;
+			row  = (int)(rowV + 0.001f);
+			rowU = 0.0f;
+			rowV = (float)row;
+		}
+
+		for (j = 0; j < 4; j++, dst++) {
+			v = &quad[j];
+			dst->X   = (cc_int16)Math_Floor((v->X - x1) * PACKED_POS_SCALE + 0.5f);
+			dst->Y   = (cc_int16)Math_Floor((v->Y - y1) * PACKED_POS_SCALE + 0.5f);
+			dst->Z   = (cc_int16)Math_Floor((v->Z - z1) * PACKED_POS_SCALE + 0.5f);
+			dst->Row = (cc_uint16)row;
+			dst->Col = v->Col;
+
+			dst->U = (cc_uint16)Math_Floor((v->U - rowU) * PACKED_UV_SCALE + 0.5f);
+			/* Tile repeat V is already in units of tiles within the row */
+			if (tileRepeat) {
+				dst->V = (cc_uint16)Math_Floor(v->V * PACKED_UV_SCALE + 0.5f);
+			} else {
+				dst->V = (cc_uint16)Math_Floor((v->V * Atlas1D.TilesPerAtlas - rowV) * PACKED_UV_SCALE + 0.5f);
+			}
+		}
+	}
+
+	/* Give back the memory that is no longer needed */
+	mem = Mem_TryRealloc(mesh->vertices, mesh->verticesCount, SIZEOF_VERTEX_PACKED);
+	if (mem) mesh->vertices = (struct VertexTextured*)mem;
+}
+
+/* Builds the mesh of vertices for the given chunk */
+/* NOTE: This can be called from any thread, and so must not use the graphics API */
+static void BuildMesh(struct BuilderContext* ctx, struct ChunkMesh* mesh) {
+	struct ChunkInfo* info = mesh->info;
 	int x = info->CentreX - 8, y = info->CentreY - 8, z = info->CentreZ - 8;
-	cc_bool hasMesh, hasNorm, hasTran;
 	int partsIndex;
 	int i, j, curIdx, offset;
 
-	hasMesh = BuildChunk(x, y, z, info);
-	if (!hasMesh) return;
+	mesh->vertices = NULL;
+	mesh->hasNorm  = false;
+	mesh->hasTran  = false;
+	if (!BuildChunk(ctx, x, y, z, mesh)) return;
 
+	if (Builder_PackedVertices) PackVertices(mesh, x, y, z);
 	partsIndex = MapRenderer_Pack(x >> CHUNK_SHIFT, y >> CHUNK_SHIFT, z >> CHUNK_SHIFT);
-	offset  = 0;
-	hasNorm = false;
-	hasTran = false;
+	offset = 0;
 
+	/* Each chunk has its own part infos, so different threads never write to the same part info */
 	for (i = 0; i < MapRenderer_1DUsedCount; i++) {
 		j = i + ATLAS1D_MAX_ATLASES;
 		curIdx = partsIndex + i * MapRenderer_ChunksCount;
 
-		SetPartInfo(&Builder_Parts[i], &offset, &MapRenderer_PartsNormal[curIdx],      &hasNorm);
-		SetPartInfo(&Builder_Parts[j], &offset, &MapRenderer_PartsTranslucent[curIdx], &hasTran);
+		SetPartInfo(&ctx->Parts[i], &offset, &MapRenderer_PartsNormal[curIdx],      &mesh->hasNorm);
+		SetPartInfo(&ctx->Parts[j], &offset, &MapRenderer_PartsTranslucent[curIdx], &mesh->hasTran);
+	}
+}
+
+/* Uploads the built vertices of the given chunk to the GPU */
+/* NOTE: This must only be called from the main thread */
+static void UploadMesh(struct ChunkMesh* mesh) {
+	struct ChunkInfo* info = mesh->info;
+	int x = info->CentreX - 8, y = info->CentreY - 8, z = info->CentreZ - 8;
+	int partsIndex;
+#ifdef CC_BUILD_GL11
+	int i, curIdx;
+#endif
+
+	info->AllAir = mesh->allAir;
+	Mem_Copy(info->Connects, mesh->connects, FACE_COUNT);
+	if (!mesh->vertices) return;
+	partsIndex = MapRenderer_Pack(x >> CHUNK_SHIFT, y >> CHUNK_SHIFT, z >> CHUNK_SHIFT);
+
+#ifndef CC_BUILD_GL11
+	MapRenderer_UploadVertices(info, mesh->vertices, mesh->verticesCount);
+#else
+	for (i = 0; i < MapRenderer_1DUsedCount; i++) {
+		curIdx = partsIndex + i * MapRenderer_ChunksCount;
+
+		if (MapRenderer_PartsNormal[curIdx].Offset >= 0) {
+			BuildPartVbs(&MapRenderer_PartsNormal[curIdx], mesh->vertices);
+		}
+		if (MapRenderer_PartsTranslucent[curIdx].Offset >= 0) {
+			BuildPartVbs(&MapRenderer_PartsTranslucent[curIdx], mesh->vertices);
+		}
 	}
+#endif
+	Mem_Free(mesh->vertices);
+	mesh->vertices = NULL;
 
-	if (hasNorm) {
+	if (mesh->hasNorm) {
 		info->NormalParts      = &MapRenderer_PartsNormal[partsIndex];
 	}
-	if (hasTran) {
+	if (mesh->hasTran) {
 		info->TranslucentParts = &MapRenderer_PartsTranslucent[partsIndex];
 	}
-
-#ifdef OCCLUSION
-	if (info.NormalParts != null || info.TranslucentParts != null)
-		info.occlusionFlags = (cc_uint8)ComputeOcclusion();
-#endif
 }
 
-static cc_bool Builder_OccludedLiquid(int chunkIndex) {
+static cc_bool Builder_OccludedLiquid(struct BuilderContext* ctx, int chunkIndex) {
 	chunkIndex += EXTCHUNK_SIZE_2; /* Checking y above */
 	return
-		Blocks.FullOpaque[Builder_Chunk[chunkIndex]]
-		&& Blocks.Draw[Builder_Chunk[chunkIndex - EXTCHUNK_SIZE]] != DRAW_GAS
-		&& Blocks.Draw[Builder_Chunk[chunkIndex - 1]] != DRAW_GAS
-		&& Blocks.Draw[Builder_Chunk[chunkIndex + 1]] != DRAW_GAS
-		&& Blocks.Draw[Builder_Chunk[chunkIndex + EXTCHUNK_SIZE]] != DRAW_GAS;
+		Blocks.FullOpaque[ctx->Chunk[chunkIndex]]
+		&& Blocks.Draw[ctx->Chunk[chunkIndex - EXTCHUNK_SIZE]] != DRAW_GAS
+		&& Blocks.Draw[ctx->Chunk[chunkIndex - 1]] != DRAW_GAS
+		&& Blocks.Draw[ctx->Chunk[chunkIndex + 1]] != DRAW_GAS
+		&& Blocks.Draw[ctx->Chunk[chunkIndex + EXTCHUNK_SIZE]] != DRAW_GAS;
 }
 
-static void DefaultPreStretchTiles(void) {
-	Mem_Set(Builder_Parts, 0, sizeof(Builder_Parts));
+static void DefaultPreStretchTiles(struct BuilderContext* ctx) {
+	Mem_Set(ctx->Parts, 0, sizeof(ctx->Parts));
 }
 
-static void DefaultPostStretchTiles(void) {
+static void DefaultPostStretchTiles(struct BuilderContext* ctx) {
 	int i, j, offset;
 	offset = 0;
 	for (i = 0; i < ATLAS1D_MAX_ATLASES; i++) {
 		j = i + ATLAS1D_MAX_ATLASES;
 
-		offset = Builder1DPart_CalcOffsets(&Builder_Parts[i], offset);
-		offset = Builder1DPart_CalcOffsets(&Builder_Parts[j], offset);
+		offset = Builder1DPart_CalcOffsets(&ctx->Parts[i], ctx->Vertices, offset);
+		offset = Builder1DPart_CalcOffsets(&ctx->Parts[j], ctx->Vertices, offset);
 	}
 }
 
-static RNGState spriteRng;
-static void Builder_DrawSprite(void) {
+static void Builder_DrawSprite(struct BuilderContext* ctx) {
 	struct Builder1DPart* part;
 	struct VertexTextured v;
 	PackedCol white = PACKEDCOL_WHITE;
@@ -480,59 +633,59 @@ static void Builder_DrawSprite(void) {
 	float valX, valY, valZ;
 	float x1,y1,z1, x2,y2,z2;
 	
-	X  = (float)Builder_X; Y = (float)Builder_Y; Z = (float)Builder_Z;
+	X  = (float)ctx->X; Y = (float)ctx->Y; Z = (float)ctx->Z;
 	x1 = X + 2.50f/16.0f; y1 = Y;        z1 = Z + 2.50f/16.0f;
 	x2 = X + 13.5f/16.0f; y2 = Y + 1.0f; z2 = Z + 13.5f/16.0f;
 
 #define s_u1 0.0f
 #define s_u2 UV2_Scale
-	loc = Block_Tex(Builder_Block, FACE_XMAX);
+	loc = Block_Tex(ctx->Block, FACE_XMAX);
 	v1  = Atlas1D_RowId(loc) * Atlas1D.InvTileSize;
 	v2  = v1 + Atlas1D.InvTileSize * UV2_Scale;
 
-	offsetType = Blocks.SpriteOffset[Builder_Block];
+	offsetType = Blocks.SpriteOffset[ctx->Block];
 	if (offsetType >= 6 && offsetType <= 7) {
-		Random_Seed(&spriteRng, (Builder_X + 1217 * Builder_Z) & 0x7fffffff);
-		valX = Random_Range(&spriteRng, -3, 3 + 1) / 16.0f;
-		valY = Random_Range(&spriteRng, 0,  3 + 1) / 16.0f;
-		valZ = Random_Range(&spriteRng, -3, 3 + 1) / 16.0f;
+		Random_Seed(&ctx->SpriteRng, (ctx->X + 1217 * ctx->Z) & 0x7fffffff);
+		valX = Random_Range(&ctx->SpriteRng, -3, 3 + 1) / 16.0f;
+		valY = Random_Range(&ctx->SpriteRng, 0,  3 + 1) / 16.0f;
+		valZ = Random_Range(&ctx->SpriteRng, -3, 3 + 1) / 16.0f;
 
 		x1 += valX - 1.7f/16.0f; x2 += valX + 1.7f/16.0f;
 		z1 += valZ - 1.7f/16.0f; z2 += valZ + 1.7f/16.0f;
 		if (offsetType == 7) { y1 -= valY; y2 -= valY; }
 	}
 	
-	part  = &Builder_Parts[Atlas1D_Index(loc)];
-	v.Col = Builder_FullBright ? white : Lighting_Col_Sprite_Fast(Builder_X, Builder_Y, Builder_Z);
-	Block_Tint(v.Col, Builder_Block);
+	part  = &ctx->Parts[Atlas1D_Index(loc)];
+	v.Col = ctx->FullBright ? white : Lighting_Col_Sprite_Fast(ctx->X, ctx->Y, ctx->Z);
+	Block_Tint(v.Col, ctx->Block);
 
 	/* Draw Z axis */
 	index = part->sOffset;
-	v.X = x1; v.Y = y1; v.Z = z1; v.U = s_u2; v.V = v2; Builder_Vertices[index + 0] = v;
-	          v.Y = y2;                       v.V = v1; Builder_Vertices[index + 1] = v;
-	v.X = x2;           v.Z = z2; v.U = s_u1;           Builder_Vertices[index + 2] = v;
-	          v.Y = y1;                       v.V = v2; Builder_Vertices[index + 3] = v;
+	v.X = x1; v.Y = y1; v.Z = z1; v.U = s_u2; v.V = v2; ctx->Vertices[index + 0] = v;
+	          v.Y = y2;                       v.V = v1; ctx->Vertices[index + 1] = v;
+	v.X = x2;           v.Z = z2; v.U = s_u1;           ctx->Vertices[index + 2] = v;
+	          v.Y = y1;                       v.V = v2; ctx->Vertices[index + 3] = v;
 
 	/* Draw Z axis mirrored */
 	index += part->sAdvance;
-	v.X = x2; v.Y = y1; v.Z = z2; v.U = s_u2;           Builder_Vertices[index + 0] = v;
-	          v.Y = y2;                       v.V = v1; Builder_Vertices[index + 1] = v;
-	v.X = x1;           v.Z = z1; v.U = s_u1;           Builder_Vertices[index + 2] = v;
-	          v.Y = y1;                       v.V = v2; Builder_Vertices[index + 3] = v;
+	v.X = x2; v.Y = y1; v.Z = z2; v.U = s_u2;           ctx->Vertices[index + 0] = v;
+	          v.Y = y2;                       v.V = v1; ctx->Vertices[index + 1] = v;
+	v.X = x1;           v.Z = z1; v.U = s_u1;           ctx->Vertices[index + 2] = v;
+	          v.Y = y1;                       v.V = v2; ctx->Vertices[index + 3] = v;
 
 	/* Draw X axis */
 	index += part->sAdvance;
-	v.X = x1; v.Y = y1; v.Z = z2; v.U = s_u2;           Builder_Vertices[index + 0] = v;
-	          v.Y = y2;                       v.V = v1; Builder_Vertices[index + 1] = v;
-	v.X = x2;           v.Z = z1; v.U = s_u1;           Builder_Vertices[index + 2] = v;
-	          v.Y = y1;                       v.V = v2; Builder_Vertices[index + 3] = v;
+	v.X = x1; v.Y = y1; v.Z = z2; v.U = s_u2;           ctx->Vertices[index + 0] = v;
+	          v.Y = y2;                       v.V = v1; ctx->Vertices[index + 1] = v;
+	v.X = x2;           v.Z = z1; v.U = s_u1;           ctx->Vertices[index + 2] = v;
+	          v.Y = y1;                       v.V = v2; ctx->Vertices[index + 3] = v;
 
 	/* Draw X axis mirrored */
 	index += part->sAdvance;
-	v.X = x2; v.Y = y1; v.Z = z1; v.U = s_u2;           Builder_Vertices[index + 0] = v;
-	          v.Y = y2;                       v.V = v1; Builder_Vertices[index + 1] = v;
-	v.X = x1;           v.Z = z2; v.U = s_u1;           Builder_Vertices[index + 2] = v;
-	          v.Y = y1;                       v.V = v2; Builder_Vertices[index + 3] = v;
+	v.X = x2; v.Y = y1; v.Z = z1; v.U = s_u2;           ctx->Vertices[index + 0] = v;
+	          v.Y = y2;                       v.V = v1; ctx->Vertices[index + 1] = v;
+	v.X = x1;           v.Z = z2; v.U = s_u1;           ctx->Vertices[index + 2] = v;
+	          v.Y = y1;                       v.V = v2; ctx->Vertices[index + 3] = v;
 
 	part->sOffset += 4;
 }
@@ -561,72 +714,72 @@ static PackedCol Normal_LightCol(int x, int y, int z, Face face, BlockID block)
 	return 0; /* should never happen */
 }
 
-static cc_bool Normal_CanStretch(BlockID initial, int chunkIndex, int x, int y, int z, Face face) {
-	BlockID cur = Builder_Chunk[chunkIndex];
+static cc_bool Normal_CanStretch(struct BuilderContext* ctx, BlockID initial, int chunkIndex, int x, int y, int z, Face face) {
+	BlockID cur = ctx->Chunk[chunkIndex];
 
-	if (cur != initial || Block_IsFaceHidden(cur, Builder_Chunk[chunkIndex + Builder_Offsets[face]], face)) return false;
-	if (Builder_FullBright) return true;
+	if (cur != initial || Block_IsFaceHidden(cur, ctx->Chunk[chunkIndex + Builder_Offsets[face]], face)) return false;
+	if (ctx->FullBright) return true;
 
-	return Normal_LightCol(Builder_X, Builder_Y, Builder_Z, face, initial) == Normal_LightCol(x, y, z, face, cur);
+	return Normal_LightCol(ctx->X, ctx->Y, ctx->Z, face, initial) == Normal_LightCol(x, y, z, face, cur);
 }
 
-static int NormalBuilder_StretchXLiquid(int countIndex, int x, int y, int z, int chunkIndex, BlockID block) {
+static int NormalBuilder_StretchXLiquid(struct BuilderContext* ctx, int countIndex, int x, int y, int z, int chunkIndex, BlockID block) {
 	int count = 1; cc_bool stretchTile;
-	if (Builder_OccludedLiquid(chunkIndex)) return 0;
+	if (Builder_OccludedLiquid(ctx, chunkIndex)) return 0;
 	
 	x++;
 	chunkIndex++;
 	countIndex += FACE_COUNT;
 	stretchTile = (Blocks.CanStretch[block] & (1 << FACE_YMAX)) != 0;
 
-	while (x < Builder_ChunkEndX && stretchTile && Normal_CanStretch(block, chunkIndex, x, y, z, FACE_YMAX) && !Builder_OccludedLiquid(chunkIndex)) {
-		Builder_Counts[countIndex] = 0;
+	while (x < ctx->ChunkEndX && stretchTile && Normal_CanStretch(ctx, block, chunkIndex, x, y, z, FACE_YMAX) && !Builder_OccludedLiquid(ctx, chunkIndex)) {
+		ctx->Counts[countIndex] = 0;
 		count++;
 		x++;
 		chunkIndex++;
 		countIndex += FACE_COUNT;
 	}
-	AddVertices(block, FACE_YMAX);
+	AddVertices(ctx, block, FACE_YMAX);
 	return count;
 }
 
-static int NormalBuilder_StretchX(int countIndex, int x, int y, int z, int chunkIndex, BlockID block, Face face) {
+static int NormalBuilder_StretchX(struct BuilderContext* ctx, int countIndex, int x, int y, int z, int chunkIndex, BlockID block, Face face) {
 	int count = 1; cc_bool stretchTile;
 	x++;
 	chunkIndex++;
 	countIndex += FACE_COUNT;
 	stretchTile = (Blocks.CanStretch[block] & (1 << face)) != 0;
 
-	while (x < Builder_ChunkEndX && stretchTile && Normal_CanStretch(block, chunkIndex, x, y, z, face)) {
-		Builder_Counts[countIndex] = 0;
+	while (x < ctx->ChunkEndX && stretchTile && Normal_CanStretch(ctx, block, chunkIndex, x, y, z, face)) {
+		ctx->Counts[countIndex] = 0;
 		count++;
 		x++;
 		chunkIndex++;
 		countIndex += FACE_COUNT;
 	}
-	AddVertices(block, face);
+	AddVertices(ctx, block, face);
 	return count;
 }
 
-static int NormalBuilder_StretchZ(int countIndex, int x, int y, int z, int chunkIndex, BlockID block, Face face) {
+static int NormalBuilder_StretchZ(struct BuilderContext* ctx, int countIndex, int x, int y, int z, int chunkIndex, BlockID block, Face face) {
 	int count = 1; cc_bool stretchTile;
 	z++;
 	chunkIndex += EXTCHUNK_SIZE;
 	countIndex += CHUNK_SIZE * FACE_COUNT;
 	stretchTile = (Blocks.CanStretch[block] & (1 << face)) != 0;
 
-	while (z < Builder_ChunkEndZ && stretchTile && Normal_CanStretch(block, chunkIndex, x, y, z, face)) {
-		Builder_Counts[countIndex] = 0;
+	while (z < ctx->ChunkEndZ && stretchTile && Normal_CanStretch(ctx, block, chunkIndex, x, y, z, face)) {
+		ctx->Counts[countIndex] = 0;
 		count++;
 		z++;
 		chunkIndex += EXTCHUNK_SIZE;
 		countIndex += CHUNK_SIZE * FACE_COUNT;
 	}
-	AddVertices(block, face);
+	AddVertices(ctx, block, face);
 	return count;
 }
 
-static void NormalBuilder_RenderBlock(int index) {	
+static void NormalBuilder_RenderBlock(struct BuilderContext* ctx, int index) {	
 	/* counters */
 	int count_XMin, count_XMax, count_ZMin;
 	int count_ZMax, count_YMin, count_YMax;
@@ -643,93 +796,93 @@ static void NormalBuilder_RenderBlock(int index) {
 	PackedCol col;
 	int offset;
 
-	if (Blocks.Draw[Builder_Block] == DRAW_SPRITE) {
-		Builder_FullBright = Blocks.FullBright[Builder_Block];
-		Builder_Tinted     = Blocks.Tinted[Builder_Block];
-		Builder_DrawSprite();
+	if (Blocks.Draw[ctx->Block] == DRAW_SPRITE) {
+		ctx->FullBright = Blocks.FullBright[ctx->Block];
+		ctx->Tinted     = Blocks.Tinted[ctx->Block];
+		Builder_DrawSprite(ctx);
 		return;
 	}
 
-	count_XMin = Builder_Counts[index + FACE_XMIN];
-	count_XMax = Builder_Counts[index + FACE_XMAX];
-	count_ZMin = Builder_Counts[index + FACE_ZMIN];
-	count_ZMax = Builder_Counts[index + FACE_ZMAX];
-	count_YMin = Builder_Counts[index + FACE_YMIN];
-	count_YMax = Builder_Counts[index + FACE_YMAX];
+	count_XMin = ctx->Counts[index + FACE_XMIN];
+	count_XMax = ctx->Counts[index + FACE_XMAX];
+	count_ZMin = ctx->Counts[index + FACE_ZMIN];
+	count_ZMax = ctx->Counts[index + FACE_ZMAX];
+	count_YMin = ctx->Counts[index + FACE_YMIN];
+	count_YMax = ctx->Counts[index + FACE_YMAX];
 
 	if (!count_XMin && !count_XMax && !count_ZMin &&
 		!count_ZMax && !count_YMin && !count_YMax) return;
 
-	fullBright = Blocks.FullBright[Builder_Block];
-	baseOffset = (Blocks.Draw[Builder_Block] == DRAW_TRANSLUCENT) * ATLAS1D_MAX_ATLASES;
-	lightFlags = Blocks.LightOffset[Builder_Block];
+	fullBright = Blocks.FullBright[ctx->Block];
+	baseOffset = (Blocks.Draw[ctx->Block] == DRAW_TRANSLUCENT) * ATLAS1D_MAX_ATLASES;
+	lightFlags = Blocks.LightOffset[ctx->Block];
 
-	Drawer.MinBB = Blocks.MinBB[Builder_Block]; Drawer.MinBB.Y = 1.0f - Drawer.MinBB.Y;
-	Drawer.MaxBB = Blocks.MaxBB[Builder_Block]; Drawer.MaxBB.Y = 1.0f - Drawer.MaxBB.Y;
+	ctx->Drawer.MinBB = Blocks.MinBB[ctx->Block]; ctx->Drawer.MinBB.Y = 1.0f - ctx->Drawer.MinBB.Y;
+	ctx->Drawer.MaxBB = Blocks.MaxBB[ctx->Block]; ctx->Drawer.MaxBB.Y = 1.0f - ctx->Drawer.MaxBB.Y;
 
-	min = Blocks.RenderMinBB[Builder_Block]; max = Blocks.RenderMaxBB[Builder_Block];
-	Drawer.X1 = Builder_X + min.X; Drawer.Y1 = Builder_Y + min.Y; Drawer.Z1 = Builder_Z + min.Z;
-	Drawer.X2 = Builder_X + max.X; Drawer.Y2 = Builder_Y + max.Y; Drawer.Z2 = Builder_Z + max.Z;
+	min = Blocks.RenderMinBB[ctx->Block]; max = Blocks.RenderMaxBB[ctx->Block];
+	ctx->Drawer.X1 = ctx->X + min.X; ctx->Drawer.Y1 = ctx->Y + min.Y; ctx->Drawer.Z1 = ctx->Z + min.Z;
+	ctx->Drawer.X2 = ctx->X + max.X; ctx->Drawer.Y2 = ctx->Y + max.Y; ctx->Drawer.Z2 = ctx->Z + max.Z;
 
-	Drawer.Tinted  = Blocks.Tinted[Builder_Block];
-	Drawer.TintCol = Blocks.FogCol[Builder_Block];
+	ctx->Drawer.Tinted  = Blocks.Tinted[ctx->Block];
+	ctx->Drawer.TintCol = Blocks.FogCol[ctx->Block];
 
 	if (count_XMin) {
-		loc    = Block_Tex(Builder_Block, FACE_XMIN);
+		loc    = Block_Tex(ctx->Block, FACE_XMIN);
 		offset = (lightFlags >> FACE_XMIN) & 1;
-		part   = &Builder_Parts[baseOffset + Atlas1D_Index(loc)];
+		part   = &ctx->Parts[baseOffset + Atlas1D_Index(loc)];
 
 		col = fullBright ? white :
-			Builder_X >= offset ? Lighting_Col_XSide_Fast(Builder_X - offset, Builder_Y, Builder_Z) : Env.SunXSide;
-		Drawer_XMin(count_XMin, col, loc, &part->fVertices[FACE_XMIN]);
+			ctx->X >= offset ? Lighting_Col_XSide_Fast(ctx->X - offset, ctx->Y, ctx->Z) : Env.SunXSide;
+		Drawer_XMinEx(&ctx->Drawer, count_XMin, col, loc, &part->fVertices[FACE_XMIN]);
 	}
 
 	if (count_XMax) {
-		loc    = Block_Tex(Builder_Block, FACE_XMAX);
+		loc    = Block_Tex(ctx->Block, FACE_XMAX);
 		offset = (lightFlags >> FACE_XMAX) & 1;
-		part   = &Builder_Parts[baseOffset + Atlas1D_Index(loc)];
+		part   = &ctx->Parts[baseOffset + Atlas1D_Index(loc)];
 
 		col = fullBright ? white :
-			Builder_X <= (World.MaxX - offset) ? Lighting_Col_XSide_Fast(Builder_X + offset, Builder_Y, Builder_Z) : Env.SunXSide;
-		Drawer_XMax(count_XMax, col, loc, &part->fVertices[FACE_XMAX]);
+			ctx->X <= (World.MaxX - offset) ? Lighting_Col_XSide_Fast(ctx->X + offset, ctx->Y, ctx->Z) : Env.SunXSide;
+		Drawer_XMaxEx(&ctx->Drawer, count_XMax, col, loc, &part->fVertices[FACE_XMAX]);
 	}
 
 	if (count_ZMin) {
-		loc    = Block_Tex(Builder_Block, FACE_ZMIN);
+		loc    = Block_Tex(ctx->Block, FACE_ZMIN);
 		offset = (lightFlags >> FACE_ZMIN) & 1;
-		part   = &Builder_Parts[baseOffset + Atlas1D_Index(loc)];
+		part   = &ctx->Parts[baseOffset + Atlas1D_Index(loc)];
 
 		col = fullBright ? white :
-			Builder_Z >= offset ? Lighting_Col_ZSide_Fast(Builder_X, Builder_Y, Builder_Z - offset) : Env.SunZSide;
-		Drawer_ZMin(count_ZMin, col, loc, &part->fVertices[FACE_ZMIN]);
+			ctx->Z >= offset ? Lighting_Col_ZSide_Fast(ctx->X, ctx->Y, ctx->Z - offset) : Env.SunZSide;
+		Drawer_ZMinEx(&ctx->Drawer, count_ZMin, col, loc, &part->fVertices[FACE_ZMIN]);
 	}
 
 	if (count_ZMax) {
-		loc    = Block_Tex(Builder_Block, FACE_ZMAX);
+		loc    = Block_Tex(ctx->Block, FACE_ZMAX);
 		offset = (lightFlags >> FACE_ZMAX) & 1;
-		part   = &Builder_Parts[baseOffset + Atlas1D_Index(loc)];
+		part   = &ctx->Parts[baseOffset + Atlas1D_Index(loc)];
 
 		col = fullBright ? white :
-			Builder_Z <= (World.MaxZ - offset) ? Lighting_Col_ZSide_Fast(Builder_X, Builder_Y, Builder_Z + offset) : Env.SunZSide;
-		Drawer_ZMax(count_ZMax, col, loc, &part->fVertices[FACE_ZMAX]);
+			ctx->Z <= (World.MaxZ - offset) ? Lighting_Col_ZSide_Fast(ctx->X, ctx->Y, ctx->Z + offset) : Env.SunZSide;
+		Drawer_ZMaxEx(&ctx->Drawer, count_ZMax, col, loc, &part->fVertices[FACE_ZMAX]);
 	}
 
 	if (count_YMin) {
-		loc    = Block_Tex(Builder_Block, FACE_YMIN);
+		loc    = Block_Tex(ctx->Block, FACE_YMIN);
 		offset = (lightFlags >> FACE_YMIN) & 1;
-		part   = &Builder_Parts[baseOffset + Atlas1D_Index(loc)];
+		part   = &ctx->Parts[baseOffset + Atlas1D_Index(loc)];
 
-		col = fullBright ? white : Lighting_Col_YMin_Fast(Builder_X, Builder_Y - offset, Builder_Z);
-		Drawer_YMin(count_YMin, col, loc, &part->fVertices[FACE_YMIN]);
+		col = fullBright ? white : Lighting_Col_YMin_Fast(ctx->X, ctx->Y - offset, ctx->Z);
+		Drawer_YMinEx(&ctx->Drawer, count_YMin, col, loc, &part->fVertices[FACE_YMIN]);
 	}
 
 	if (count_YMax) {
-		loc    = Block_Tex(Builder_Block, FACE_YMAX);
+		loc    = Block_Tex(ctx->Block, FACE_YMAX);
 		offset = (lightFlags >> FACE_YMAX) & 1;
-		part   = &Builder_Parts[baseOffset + Atlas1D_Index(loc)];
+		part   = &ctx->Parts[baseOffset + Atlas1D_Index(loc)];
 
-		col = fullBright ? white : Lighting_Col_YMax_Fast(Builder_X, (Builder_Y + 1) - offset, Builder_Z);
-		Drawer_YMax(count_YMax, col, loc, &part->fVertices[FACE_YMAX]);
+		col = fullBright ? white : Lighting_Col_YMax_Fast(ctx->X, (ctx->Y + 1) - offset, ctx->Z);
+		Drawer_YMaxEx(&ctx->Drawer, count_YMax, col, loc, &part->fVertices[FACE_YMAX]);
 	}
 }
 
@@ -739,9 +892,9 @@ static void Builder_SetDefault(void) {
 	Builder_StretchZ       = NULL;
 	Builder_RenderBlock    = NULL;
 
-	Builder_UseBitFlags      = false;
 	Builder_PreStretchTiles  = DefaultPreStretchTiles;
 	Builder_PostStretchTiles = DefaultPostStretchTiles;
+	Builder_MergeRows        = NULL;
 }
 
 static void NormalBuilder_SetActive(void) {
@@ -754,14 +907,135 @@ static void NormalBuilder_SetActive(void) {
 
 
 /*########################################################################################################################*
-*-------------------------------------------------Advanced mesh builder---------------------------------------------------*
+*--------------------------------------------------Greedy mesh builder----------------------------------------------------*
 *#########################################################################################################################*/
-static Vec3 adv_minBB, adv_maxBB;
-static int adv_initBitFlags, adv_lightFlags, adv_baseOffset;
-static int* adv_bitFlags;
-static float adv_x1, adv_y1, adv_z1, adv_x2, adv_y2, adv_z2;
-static PackedCol adv_lerp[5], adv_lerpX[5], adv_lerpZ[5], adv_lerpY[5];
+/* The normal builder only stretches faces into runs along one axis (U texture axis), because */
+/*  the 1D terrain atlas can only repeat textures horizontally. The greedy builder additionally */
+/*  merges identical runs in consecutive rows into one rectangle, and then relies on the */
+/*  graphics backend to repeat the texture vertically within the tile. (see Gfx_EnableTileRepeat) */
+
+/* Whether the given face of a block spans the entire block along the axis its rows are merged on */
+static cc_bool GreedyBuilder_SpansRow(BlockID block, Face face) {
+	if (face >= FACE_YMIN) {
+		return Blocks.MinBB[block].Z       == 0.0f && Blocks.MaxBB[block].Z       == 1.0f
+			&& Blocks.RenderMinBB[block].Z == 0.0f && Blocks.RenderMaxBB[block].Z == 1.0f;
+	}
+	return Blocks.MinBB[block].Y       == 0.0f && Blocks.MaxBB[block].Y       == 1.0f
+		&& Blocks.RenderMinBB[block].Y == 0.0f && Blocks.RenderMaxBB[block].Y == 1.0f;
+}
+
+/* Merges each stretched face with faces in the following rows that have the same block, */
+/*  light colour, start and length. Rows of Y faces are along Z axis, side faces along Y axis */
+static void GreedyBuilder_MergeRows(struct BuilderContext* ctx, int x1, int y1, int z1) {
+	int xMax = min(World.Width,  x1 + CHUNK_SIZE) - x1;
+	int yMax = min(World.Height, y1 + CHUNK_SIZE) - y1;
+	int zMax = min(World.Length, z1 + CHUNK_SIZE) - z1;
+
+	int cIndex, index, next, nextC, step, stepC;
+	int count, rows, maxRows, dy, dz;
+	cc_bool fullBright;
+	PackedCol col;
+	BlockID b;
+	Face face;
+	int x, y, z, xx, yy, zz;
+
+	for (yy = 0; yy < yMax; yy++) {
+		for (zz = 0; zz < zMax; zz++) {
+			cIndex = Builder_PackChunk(0, yy, zz);
+
+			for (xx = 0; xx < xMax; xx++, cIndex++) {
+				b = ctx->Chunk[cIndex];
+				if (Blocks.Draw[b] == DRAW_GAS || Blocks.Draw[b] == DRAW_SPRITE) continue;
+
+				index = Builder_PackCount(xx, yy, zz);
+				x = x1 + xx; y = y1 + yy; z = z1 + zz;
+				fullBright = Blocks.FullBright[b];
+
+				for (face = 0; face < FACE_COUNT; face++) {
+					count = ctx->Counts[index + face];
+					if (!count || !GreedyBuilder_SpansRow(b, face)) continue;
+
+					if (face >= FACE_YMIN) {
+						dy = 0; dz = 1; maxRows = zMax - zz;
+						step = CHUNK_SIZE   * FACE_COUNT; stepC = EXTCHUNK_SIZE;
+					} else {
+						dy = 1; dz = 0; maxRows = yMax - yy;
+						step = CHUNK_SIZE_2 * FACE_COUNT; stepC = EXTCHUNK_SIZE_2;
+					}
+
+					/* Every face in a stretched run has the same light colour as the run's first face */
+					col   = fullBright ? 0 : Normal_LightCol(x, y, z, face, b);
+					next  = index + face + step;
+					nextC = cIndex + stepC;
+
+					for (rows = 1; rows < maxRows; rows++, next += step, nextC += stepC) {
+						if (ctx->Counts[next] != count || ctx->Chunk[nextC] != b) break;
+						if (!fullBright && Normal_LightCol(x, y + rows * dy, z + rows * dz, face, b) != col) break;
+
+						ctx->Counts[next] = 0;
+						RemoveVertices(ctx, b, face);
+					}
+					ctx->Rows[index + face] = rows;
+				}
+			}
+		}
+	}
+}
+
+/* Extends the quad of a face to cover all of its merged rows, then converts */
+/*  its texture coordinates to the encoding used by Gfx_EnableTileRepeat */
+static void GreedyBuilder_ExtendFace(struct BuilderContext* ctx, Face face, int rows, TextureLoc loc, struct VertexTextured* v) {
+	float row    = (float)Atlas1D_RowId(loc);
+	float extent = (float)(rows - 1);
+	int i;
 
+	for (i = 0; i < 4; i++, v++) {
+		v->U += (row + 1.0f) * GFX_TILE_REPEAT_STRIDE;
+		v->V  = v->V * Atlas1D.TilesPerAtlas - row;
+
+		if (face >= FACE_YMIN) {
+			/* V increases along Z axis for Y faces */
+			if (v->Z == ctx->Drawer.Z2) { v->Z += extent; v->V += extent; }
+		} else {
+			/* V decreases along Y axis for side faces, so keep V of the top */
+			/*  vertices and shift the others down by whole tiles instead. */
+			/* (as packed vertices can't have negative texture coordinates) */
+			if (v->Y == ctx->Drawer.Y2) { v->Y += extent; } else { v->V += extent; }
+		}
+	}
+}
+
+static void GreedyBuilder_RenderBlock(struct BuilderContext* ctx, int index) {
+	struct Builder1DPart* part;
+	TextureLoc loc;
+	int baseOffset, rows;
+	Face face;
+
+	NormalBuilder_RenderBlock(ctx, index);
+	if (Blocks.Draw[ctx->Block] == DRAW_SPRITE) return;
+	baseOffset = (Blocks.Draw[ctx->Block] == DRAW_TRANSLUCENT) * ATLAS1D_MAX_ATLASES;
+
+	for (face = 0; face < FACE_COUNT; face++) {
+		rows = ctx->Rows[index + face];
+		if (!ctx->Counts[index + face] || rows <= 1) continue;
+
+		loc  = Block_Tex(ctx->Block, face);
+		part = &ctx->Parts[baseOffset + Atlas1D_Index(loc)];
+		/* The face's quad was just drawn by NormalBuilder_RenderBlock */
+		GreedyBuilder_ExtendFace(ctx, face, rows, loc, part->fVertices[face] - 4);
+	}
+}
+
+static void GreedyBuilder_SetActive(void) {
+	NormalBuilder_SetActive();
+	Builder_RenderBlock = GreedyBuilder_RenderBlock;
+	Builder_MergeRows   = GreedyBuilder_MergeRows;
+}
+
+
+/*########################################################################################################################*
+*-------------------------------------------------Advanced mesh builder---------------------------------------------------*
+*#########################################################################################################################*/
 enum ADV_MASK {
 	/* z-1 cube points */
 	xM1_yM1_zM1, xM1_yCC_zM1, xM1_yP1_zM1,
@@ -777,7 +1051,7 @@ enum ADV_MASK {
 	xP1_yM1_zP1, xP1_yCC_zP1, xP1_yP1_zP1,
 };
 
-static int Adv_Lit(int x, int y, int z, int cIndex) {
+static int Adv_Lit(struct BuilderContext* ctx, int x, int y, int z, int cIndex) {
 	int flags, offset, lightHeight;
 	BlockID block;
 	if (y < 0 || y >= World.Height) return 7; /* all faces lit */
@@ -788,41 +1062,41 @@ static int Adv_Lit(int x, int y, int z, int cIndex) {
 	}
 
 	flags = 0;
-	block = Builder_Chunk[cIndex];
+	block = ctx->Chunk[cIndex];
 	lightHeight    = Lighting_Heightmap[Lighting_Pack(x, z)];
-	adv_lightFlags = Blocks.LightOffset[block];
+	ctx->adv.lightFlags = Blocks.LightOffset[block];
 
 	/* Use fact Light(Y.YMin) == Light((Y-1).YMax) */
-	offset = (adv_lightFlags >> FACE_YMIN) & 1;
+	offset = (ctx->adv.lightFlags >> FACE_YMIN) & 1;
 	flags |= ((y - offset) > lightHeight ? 1 : 0);
 
 	/* Light is same for all the horizontal faces */
 	flags |= (y > lightHeight ? 2 : 0);
 
 	/* Use fact Light((Y+1).YMin) == Light(Y.YMax) */
-	offset = (adv_lightFlags >> FACE_YMAX) & 1;
+	offset = (ctx->adv.lightFlags >> FACE_YMAX) & 1;
 	flags |= ((y - offset) >= lightHeight ? 4 : 0);
 
 	/* Dynamic lighting */
 	if (Blocks.FullBright[block])                       flags |= 5;
-	if (Blocks.FullBright[Builder_Chunk[cIndex + 324]]) flags |= 4;
-	if (Blocks.FullBright[Builder_Chunk[cIndex - 324]]) flags |= 1;
+	if (Blocks.FullBright[ctx->Chunk[cIndex + 324]]) flags |= 4;
+	if (Blocks.FullBright[ctx->Chunk[cIndex - 324]]) flags |= 1;
 	return flags;
 }
 
-static int Adv_ComputeLightFlags(int x, int y, int z, int cIndex) {
-	if (Builder_FullBright) return (1 << xP1_yP1_zP1) - 1; /* all faces fully bright */
+static int Adv_ComputeLightFlags(struct BuilderContext* ctx, int x, int y, int z, int cIndex) {
+	if (ctx->FullBright) return (1 << xP1_yP1_zP1) - 1; /* all faces fully bright */
 
 	return
-		Adv_Lit(x - 1, y, z - 1, cIndex - 1 - 18) << xM1_yM1_zM1 |
-		Adv_Lit(x - 1, y, z,     cIndex - 1)      << xM1_yM1_zCC |
-		Adv_Lit(x - 1, y, z + 1, cIndex - 1 + 18) << xM1_yM1_zP1 |
-		Adv_Lit(x,     y, z - 1, cIndex + 0 - 18) << xCC_yM1_zM1 |
-		Adv_Lit(x,     y, z,     cIndex + 0)      << xCC_yM1_zCC |
-		Adv_Lit(x,     y, z + 1, cIndex + 0 + 18) << xCC_yM1_zP1 |
-		Adv_Lit(x + 1, y, z - 1, cIndex + 1 - 18) << xP1_yM1_zM1 |
-		Adv_Lit(x + 1, y, z,     cIndex + 1)      << xP1_yM1_zCC |
-		Adv_Lit(x + 1, y, z + 1, cIndex + 1 + 18) << xP1_yM1_zP1;
+		Adv_Lit(ctx, x - 1, y, z - 1, cIndex - 1 - 18) << xM1_yM1_zM1 |
+		Adv_Lit(ctx, x - 1, y, z,     cIndex - 1)      << xM1_yM1_zCC |
+		Adv_Lit(ctx, x - 1, y, z + 1, cIndex - 1 + 18) << xM1_yM1_zP1 |
+		Adv_Lit(ctx, x,     y, z - 1, cIndex + 0 - 18) << xCC_yM1_zM1 |
+		Adv_Lit(ctx, x,     y, z,     cIndex + 0)      << xCC_yM1_zCC |
+		Adv_Lit(ctx, x,     y, z + 1, cIndex + 0 + 18) << xCC_yM1_zP1 |
+		Adv_Lit(ctx, x + 1, y, z - 1, cIndex + 1 - 18) << xP1_yM1_zM1 |
+		Adv_Lit(ctx, x + 1, y, z,     cIndex + 1)      << xP1_yM1_zCC |
+		Adv_Lit(ctx, x + 1, y, z + 1, cIndex + 1 + 18) << xP1_yM1_zP1;
 }
 
 static int adv_masks[FACE_COUNT] = {
@@ -853,388 +1127,388 @@ static int adv_masks[FACE_COUNT] = {
 };
 
 
-static cc_bool Adv_CanStretch(BlockID initial, int chunkIndex, int x, int y, int z, Face face) {
-	BlockID cur = Builder_Chunk[chunkIndex];
-	adv_bitFlags[chunkIndex] = Adv_ComputeLightFlags(x, y, z, chunkIndex);
+static cc_bool Adv_CanStretch(struct BuilderContext* ctx, BlockID initial, int chunkIndex, int x, int y, int z, Face face) {
+	BlockID cur = ctx->Chunk[chunkIndex];
+	ctx->adv.bitFlags[chunkIndex] = Adv_ComputeLightFlags(ctx, x, y, z, chunkIndex);
 
 	return cur == initial
-		&& !Block_IsFaceHidden(cur, Builder_Chunk[chunkIndex + Builder_Offsets[face]], face)
-		&& (adv_initBitFlags == adv_bitFlags[chunkIndex]
+		&& !Block_IsFaceHidden(cur, ctx->Chunk[chunkIndex + Builder_Offsets[face]], face)
+		&& (ctx->adv.initBitFlags == ctx->adv.bitFlags[chunkIndex]
 		/* Check that this face is either fully bright or fully in shadow */
-		&& (adv_initBitFlags == 0 || (adv_initBitFlags & adv_masks[face]) == adv_masks[face]));
+		&& (ctx->adv.initBitFlags == 0 || (ctx->adv.initBitFlags & adv_masks[face]) == adv_masks[face]));
 }
 
-static int Adv_StretchXLiquid(int countIndex, int x, int y, int z, int chunkIndex, BlockID block) {
+static int Adv_StretchXLiquid(struct BuilderContext* ctx, int countIndex, int x, int y, int z, int chunkIndex, BlockID block) {
 	int count = 1; cc_bool stretchTile;
-	if (Builder_OccludedLiquid(chunkIndex)) return 0;
-	adv_initBitFlags = Adv_ComputeLightFlags(x, y, z, chunkIndex);
-	adv_bitFlags[chunkIndex] = adv_initBitFlags;
+	if (Builder_OccludedLiquid(ctx, chunkIndex)) return 0;
+	ctx->adv.initBitFlags = Adv_ComputeLightFlags(ctx, x, y, z, chunkIndex);
+	ctx->adv.bitFlags[chunkIndex] = ctx->adv.initBitFlags;
 
 	x++;
 	chunkIndex++;
 	countIndex += FACE_COUNT;
 	stretchTile = (Blocks.CanStretch[block] & (1 << FACE_YMAX)) != 0;
 
-	while (x < Builder_ChunkEndX && stretchTile && Adv_CanStretch(block, chunkIndex, x, y, z, FACE_YMAX) && !Builder_OccludedLiquid(chunkIndex)) {
-		Builder_Counts[countIndex] = 0;
+	while (x < ctx->ChunkEndX && stretchTile && Adv_CanStretch(ctx, block, chunkIndex, x, y, z, FACE_YMAX) && !Builder_OccludedLiquid(ctx, chunkIndex)) {
+		ctx->Counts[countIndex] = 0;
 		count++;
 		x++;
 		chunkIndex++;
 		countIndex += FACE_COUNT;
 	}
-	AddVertices(block, FACE_YMAX);
+	AddVertices(ctx, block, FACE_YMAX);
 	return count;
 }
 
-static int Adv_StretchX(int countIndex, int x, int y, int z, int chunkIndex, BlockID block, Face face) {
+static int Adv_StretchX(struct BuilderContext* ctx, int countIndex, int x, int y, int z, int chunkIndex, BlockID block, Face face) {
 	int count = 1; cc_bool stretchTile;
-	adv_initBitFlags = Adv_ComputeLightFlags(x, y, z, chunkIndex);
-	adv_bitFlags[chunkIndex] = adv_initBitFlags;
+	ctx->adv.initBitFlags = Adv_ComputeLightFlags(ctx, x, y, z, chunkIndex);
+	ctx->adv.bitFlags[chunkIndex] = ctx->adv.initBitFlags;
 	
 	x++;
 	chunkIndex++;
 	countIndex += FACE_COUNT;
 	stretchTile = (Blocks.CanStretch[block] & (1 << face)) != 0;
 
-	while (x < Builder_ChunkEndX && stretchTile && Adv_CanStretch(block, chunkIndex, x, y, z, face)) {
-		Builder_Counts[countIndex] = 0;
+	while (x < ctx->ChunkEndX && stretchTile && Adv_CanStretch(ctx, block, chunkIndex, x, y, z, face)) {
+		ctx->Counts[countIndex] = 0;
 		count++;
 		x++;
 		chunkIndex++;
 		countIndex += FACE_COUNT;
 	}
-	AddVertices(block, face);
+	AddVertices(ctx, block, face);
 	return count;
 }
 
-static int Adv_StretchZ(int countIndex, int x, int y, int z, int chunkIndex, BlockID block, Face face) {
+static int Adv_StretchZ(struct BuilderContext* ctx, int countIndex, int x, int y, int z, int chunkIndex, BlockID block, Face face) {
 	int count = 1; cc_bool stretchTile;
-	adv_initBitFlags = Adv_ComputeLightFlags(x, y, z, chunkIndex);
-	adv_bitFlags[chunkIndex] = adv_initBitFlags;
+	ctx->adv.initBitFlags = Adv_ComputeLightFlags(ctx, x, y, z, chunkIndex);
+	ctx->adv.bitFlags[chunkIndex] = ctx->adv.initBitFlags;
 
 	z++;
 	chunkIndex += EXTCHUNK_SIZE;
 	countIndex += CHUNK_SIZE * FACE_COUNT;
 	stretchTile = (Blocks.CanStretch[block] & (1 << face)) != 0;
 
-	while (z < Builder_ChunkEndZ && stretchTile && Adv_CanStretch(block, chunkIndex, x, y, z, face)) {
-		Builder_Counts[countIndex] = 0;
+	while (z < ctx->ChunkEndZ && stretchTile && Adv_CanStretch(ctx, block, chunkIndex, x, y, z, face)) {
+		ctx->Counts[countIndex] = 0;
 		count++;
 		z++;
 		chunkIndex += EXTCHUNK_SIZE;
 		countIndex += CHUNK_SIZE * FACE_COUNT;
 	}
-	AddVertices(block, face);
+	AddVertices(ctx, block, face);
 	return count;
 }
 
 
 #define Adv_CountBits(F, a, b, c, d) (((F >> a) & 1) + ((F >> b) & 1) + ((F >> c) & 1) + ((F >> d) & 1))
 
-static void Adv_DrawXMin(int count) {
-	TextureLoc texLoc = Block_Tex(Builder_Block, FACE_XMIN);
+static void Adv_DrawXMin(struct BuilderContext* ctx, int count) {
+	TextureLoc texLoc = Block_Tex(ctx->Block, FACE_XMIN);
 	float vOrigin = Atlas1D_RowId(texLoc) * Atlas1D.InvTileSize;
 
-	float u1 = adv_minBB.Z, u2 = (count - 1) + adv_maxBB.Z * UV2_Scale;
-	float v1 = vOrigin + adv_maxBB.Y * Atlas1D.InvTileSize;
-	float v2 = vOrigin + adv_minBB.Y * Atlas1D.InvTileSize * UV2_Scale;
-	struct Builder1DPart* part = &Builder_Parts[adv_baseOffset + Atlas1D_Index(texLoc)];
+	float u1 = ctx->adv.minBB.Z, u2 = (count - 1) + ctx->adv.maxBB.Z * UV2_Scale;
+	float v1 = vOrigin + ctx->adv.maxBB.Y * Atlas1D.InvTileSize;
+	float v2 = vOrigin + ctx->adv.minBB.Y * Atlas1D.InvTileSize * UV2_Scale;
+	struct Builder1DPart* part = &ctx->Parts[ctx->adv.baseOffset + Atlas1D_Index(texLoc)];
 
-	int F = adv_bitFlags[Builder_ChunkIndex];
+	int F = ctx->adv.bitFlags[ctx->ChunkIndex];
 	int aY0_Z0 = Adv_CountBits(F, xM1_yM1_zM1, xM1_yCC_zM1, xM1_yM1_zCC, xM1_yCC_zCC);
 	int aY0_Z1 = Adv_CountBits(F, xM1_yM1_zP1, xM1_yCC_zP1, xM1_yM1_zCC, xM1_yCC_zCC);
 	int aY1_Z0 = Adv_CountBits(F, xM1_yP1_zM1, xM1_yCC_zM1, xM1_yP1_zCC, xM1_yCC_zCC);
 	int aY1_Z1 = Adv_CountBits(F, xM1_yP1_zP1, xM1_yCC_zP1, xM1_yP1_zCC, xM1_yCC_zCC);
 
 	PackedCol tint, white = PACKEDCOL_WHITE;
-	PackedCol col0_0 = Builder_FullBright ? white : adv_lerpX[aY0_Z0], col1_0 = Builder_FullBright ? white : adv_lerpX[aY1_Z0];
-	PackedCol col1_1 = Builder_FullBright ? white : adv_lerpX[aY1_Z1], col0_1 = Builder_FullBright ? white : adv_lerpX[aY0_Z1];
+	PackedCol col0_0 = ctx->FullBright ? white : ctx->adv.lerpX[aY0_Z0], col1_0 = ctx->FullBright ? white : ctx->adv.lerpX[aY1_Z0];
+	PackedCol col1_1 = ctx->FullBright ? white : ctx->adv.lerpX[aY1_Z1], col0_1 = ctx->FullBright ? white : ctx->adv.lerpX[aY0_Z1];
 	struct VertexTextured* vertices, v;
 
-	if (Builder_Tinted) {
-		tint   = Blocks.FogCol[Builder_Block];
+	if (ctx->Tinted) {
+		tint   = Blocks.FogCol[ctx->Block];
 		col0_0 = PackedCol_Tint(col0_0, tint); col1_0 = PackedCol_Tint(col1_0, tint);
 		col1_1 = PackedCol_Tint(col1_1, tint); col0_1 = PackedCol_Tint(col0_1, tint);
 	}
 
 	vertices = part->fVertices[FACE_XMIN];
-	v.X = adv_x1;
+	v.X = ctx->adv.x1;
 	if (aY0_Z0 + aY1_Z1 > aY0_Z1 + aY1_Z0) {
-		v.Y = adv_y2; v.Z = adv_z1;               v.U = u1; v.V = v1; v.Col = col1_0; *vertices++ = v;
-		v.Y = adv_y1;                                       v.V = v2; v.Col = col0_0; *vertices++ = v;
-		              v.Z = adv_z2 + (count - 1); v.U = u2;           v.Col = col0_1; *vertices++ = v;
-		v.Y = adv_y2;                                       v.V = v1; v.Col = col1_1; *vertices++ = v;
+		v.Y = ctx->adv.y2; v.Z = ctx->adv.z1;               v.U = u1; v.V = v1; v.Col = col1_0; *vertices++ = v;
+		v.Y = ctx->adv.y1;                                       v.V = v2; v.Col = col0_0; *vertices++ = v;
+		              v.Z = ctx->adv.z2 + (count - 1); v.U = u2;           v.Col = col0_1; *vertices++ = v;
+		v.Y = ctx->adv.y2;                                       v.V = v1; v.Col = col1_1; *vertices++ = v;
 	} else {
-		v.Y = adv_y2; v.Z = adv_z2 + (count - 1); v.U = u2; v.V = v1; v.Col = col1_1; *vertices++ = v;
-		              v.Z = adv_z1;               v.U = u1;           v.Col = col1_0; *vertices++ = v;
-		v.Y = adv_y1;                                       v.V = v2; v.Col = col0_0; *vertices++ = v;
-		              v.Z = adv_z2 + (count - 1); v.U = u2;           v.Col = col0_1; *vertices++ = v;
+		v.Y = ctx->adv.y2; v.Z = ctx->adv.z2 + (count - 1); v.U = u2; v.V = v1; v.Col = col1_1; *vertices++ = v;
+		              v.Z = ctx->adv.z1;               v.U = u1;           v.Col = col1_0; *vertices++ = v;
+		v.Y = ctx->adv.y1;                                       v.V = v2; v.Col = col0_0; *vertices++ = v;
+		              v.Z = ctx->adv.z2 + (count - 1); v.U = u2;           v.Col = col0_1; *vertices++ = v;
 	}
 	part->fVertices[FACE_XMIN] = vertices;
 }
 
-static void Adv_DrawXMax(int count) {
-	TextureLoc texLoc = Block_Tex(Builder_Block, FACE_XMAX);
+static void Adv_DrawXMax(struct BuilderContext* ctx, int count) {
+	TextureLoc texLoc = Block_Tex(ctx->Block, FACE_XMAX);
 	float vOrigin = Atlas1D_RowId(texLoc) * Atlas1D.InvTileSize;
 
-	float u1 = (count - adv_minBB.Z), u2 = (1 - adv_maxBB.Z) * UV2_Scale;
-	float v1 = vOrigin + adv_maxBB.Y * Atlas1D.InvTileSize;
-	float v2 = vOrigin + adv_minBB.Y * Atlas1D.InvTileSize * UV2_Scale;
-	struct Builder1DPart* part = &Builder_Parts[adv_baseOffset + Atlas1D_Index(texLoc)];
+	float u1 = (count - ctx->adv.minBB.Z), u2 = (1 - ctx->adv.maxBB.Z) * UV2_Scale;
+	float v1 = vOrigin + ctx->adv.maxBB.Y * Atlas1D.InvTileSize;
+	float v2 = vOrigin + ctx->adv.minBB.Y * Atlas1D.InvTileSize * UV2_Scale;
+	struct Builder1DPart* part = &ctx->Parts[ctx->adv.baseOffset + Atlas1D_Index(texLoc)];
 
-	int F = adv_bitFlags[Builder_ChunkIndex];
+	int F = ctx->adv.bitFlags[ctx->ChunkIndex];
 	int aY0_Z0 = Adv_CountBits(F, xP1_yM1_zM1, xP1_yCC_zM1, xP1_yM1_zCC, xP1_yCC_zCC);
 	int aY0_Z1 = Adv_CountBits(F, xP1_yM1_zP1, xP1_yCC_zP1, xP1_yM1_zCC, xP1_yCC_zCC);
 	int aY1_Z0 = Adv_CountBits(F, xP1_yP1_zM1, xP1_yCC_zM1, xP1_yP1_zCC, xP1_yCC_zCC);
 	int aY1_Z1 = Adv_CountBits(F, xP1_yP1_zP1, xP1_yCC_zP1, xP1_yP1_zCC, xP1_yCC_zCC);
 
 	PackedCol tint, white = PACKEDCOL_WHITE;
-	PackedCol col0_0 = Builder_FullBright ? white : adv_lerpX[aY0_Z0], col1_0 = Builder_FullBright ? white : adv_lerpX[aY1_Z0];
-	PackedCol col1_1 = Builder_FullBright ? white : adv_lerpX[aY1_Z1], col0_1 = Builder_FullBright ? white : adv_lerpX[aY0_Z1];
+	PackedCol col0_0 = ctx->FullBright ? white : ctx->adv.lerpX[aY0_Z0], col1_0 = ctx->FullBright ? white : ctx->adv.lerpX[aY1_Z0];
+	PackedCol col1_1 = ctx->FullBright ? white : ctx->adv.lerpX[aY1_Z1], col0_1 = ctx->FullBright ? white : ctx->adv.lerpX[aY0_Z1];
 	struct VertexTextured* vertices, v;
 
-	if (Builder_Tinted) {
-		tint   = Blocks.FogCol[Builder_Block];
+	if (ctx->Tinted) {
+		tint   = Blocks.FogCol[ctx->Block];
 		col0_0 = PackedCol_Tint(col0_0, tint); col1_0 = PackedCol_Tint(col1_0, tint);
 		col1_1 = PackedCol_Tint(col1_1, tint); col0_1 = PackedCol_Tint(col0_1, tint);
 	}
 
 	vertices = part->fVertices[FACE_XMAX];
-	v.X = adv_x2;
+	v.X = ctx->adv.x2;
 	if (aY0_Z0 + aY1_Z1 > aY0_Z1 + aY1_Z0) {
-		v.Y = adv_y2; v.Z = adv_z1;               v.U = u1; v.V = v1; v.Col = col1_0; *vertices++ = v;
-		              v.Z = adv_z2 + (count - 1); v.U = u2;           v.Col = col1_1; *vertices++ = v;
-		v.Y = adv_y1;                                       v.V = v2; v.Col = col0_1; *vertices++ = v;
-		              v.Z = adv_z1;               v.U = u1;           v.Col = col0_0; *vertices++ = v;
+		v.Y = ctx->adv.y2; v.Z = ctx->adv.z1;               v.U = u1; v.V = v1; v.Col = col1_0; *vertices++ = v;
+		              v.Z = ctx->adv.z2 + (count - 1); v.U = u2;           v.Col = col1_1; *vertices++ = v;
+		v.Y = ctx->adv.y1;                                       v.V = v2; v.Col = col0_1; *vertices++ = v;
+		              v.Z = ctx->adv.z1;               v.U = u1;           v.Col = col0_0; *vertices++ = v;
 	} else {
-		v.Y = adv_y2; v.Z = adv_z2 + (count - 1); v.U = u2; v.V = v1; v.Col = col1_1; *vertices++ = v;
-		v.Y = adv_y1;                                       v.V = v2; v.Col = col0_1; *vertices++ = v;
-		              v.Z = adv_z1;               v.U = u1;           v.Col = col0_0; *vertices++ = v;
-		v.Y = adv_y2;                                       v.V = v1; v.Col = col1_0; *vertices++ = v;
+		v.Y = ctx->adv.y2; v.Z = ctx->adv.z2 + (count - 1); v.U = u2; v.V = v1; v.Col = col1_1; *vertices++ = v;
+		v.Y = ctx->adv.y1;                                       v.V = v2; v.Col = col0_1; *vertices++ = v;
+		              v.Z = ctx->adv.z1;               v.U = u1;           v.Col = col0_0; *vertices++ = v;
+		v.Y = ctx->adv.y2;                                       v.V = v1; v.Col = col1_0; *vertices++ = v;
 	}
 	part->fVertices[FACE_XMAX] = vertices;
 }
 
-static void Adv_DrawZMin(int count) {
-	TextureLoc texLoc = Block_Tex(Builder_Block, FACE_ZMIN);
+static void Adv_DrawZMin(struct BuilderContext* ctx, int count) {
+	TextureLoc texLoc = Block_Tex(ctx->Block, FACE_ZMIN);
 	float vOrigin = Atlas1D_RowId(texLoc) * Atlas1D.InvTileSize;
 
-	float u1 = (count - adv_minBB.X), u2 = (1 - adv_maxBB.X) * UV2_Scale;
-	float v1 = vOrigin + adv_maxBB.Y * Atlas1D.InvTileSize;
-	float v2 = vOrigin + adv_minBB.Y * Atlas1D.InvTileSize * UV2_Scale;
-	struct Builder1DPart* part = &Builder_Parts[adv_baseOffset + Atlas1D_Index(texLoc)];
+	float u1 = (count - ctx->adv.minBB.X), u2 = (1 - ctx->adv.maxBB.X) * UV2_Scale;
+	float v1 = vOrigin + ctx->adv.maxBB.Y * Atlas1D.InvTileSize;
+	float v2 = vOrigin + ctx->adv.minBB.Y * Atlas1D.InvTileSize * UV2_Scale;
+	struct Builder1DPart* part = &ctx->Parts[ctx->adv.baseOffset + Atlas1D_Index(texLoc)];
 
-	int F = adv_bitFlags[Builder_ChunkIndex];
+	int F = ctx->adv.bitFlags[ctx->ChunkIndex];
 	int aX0_Y0 = Adv_CountBits(F, xM1_yM1_zM1, xM1_yCC_zM1, xCC_yM1_zM1, xCC_yCC_zM1);
 	int aX0_Y1 = Adv_CountBits(F, xM1_yP1_zM1, xM1_yCC_zM1, xCC_yP1_zM1, xCC_yCC_zM1);
 	int aX1_Y0 = Adv_CountBits(F, xP1_yM1_zM1, xP1_yCC_zM1, xCC_yM1_zM1, xCC_yCC_zM1);
 	int aX1_Y1 = Adv_CountBits(F, xP1_yP1_zM1, xP1_yCC_zM1, xCC_yP1_zM1, xCC_yCC_zM1);
 
 	PackedCol tint, white = PACKEDCOL_WHITE;
-	PackedCol col0_0 = Builder_FullBright ? white : adv_lerpZ[aX0_Y0], col1_0 = Builder_FullBright ? white : adv_lerpZ[aX1_Y0];
-	PackedCol col1_1 = Builder_FullBright ? white : adv_lerpZ[aX1_Y1], col0_1 = Builder_FullBright ? white : adv_lerpZ[aX0_Y1];
+	PackedCol col0_0 = ctx->FullBright ? white : ctx->adv.lerpZ[aX0_Y0], col1_0 = ctx->FullBright ? white : ctx->adv.lerpZ[aX1_Y0];
+	PackedCol col1_1 = ctx->FullBright ? white : ctx->adv.lerpZ[aX1_Y1], col0_1 = ctx->FullBright ? white : ctx->adv.lerpZ[aX0_Y1];
 	struct VertexTextured* vertices, v;
 
-	if (Builder_Tinted) {
-		tint   = Blocks.FogCol[Builder_Block];
+	if (ctx->Tinted) {
+		tint   = Blocks.FogCol[ctx->Block];
 		col0_0 = PackedCol_Tint(col0_0, tint); col1_0 = PackedCol_Tint(col1_0, tint);
 		col1_1 = PackedCol_Tint(col1_1, tint); col0_1 = PackedCol_Tint(col0_1, tint);
 	}
 
 	vertices = part->fVertices[FACE_ZMIN];
-	v.Z = adv_z1;
+	v.Z = ctx->adv.z1;
 	if (aX1_Y1 + aX0_Y0 > aX0_Y1 + aX1_Y0) {
-		v.X = adv_x2 + (count - 1); v.Y = adv_y1; v.U = u2; v.V = v2; v.Col = col1_0; *vertices++ = v;
-		v.X = adv_x1;                             v.U = u1;           v.Col = col0_0; *vertices++ = v;
-		                            v.Y = adv_y2;           v.V = v1; v.Col = col0_1; *vertices++ = v;
-		v.X = adv_x2 + (count - 1);               v.U = u2;           v.Col = col1_1; *vertices++ = v;
+		v.X = ctx->adv.x2 + (count - 1); v.Y = ctx->adv.y1; v.U = u2; v.V = v2; v.Col = col1_0; *vertices++ = v;
+		v.X = ctx->adv.x1;                             v.U = u1;           v.Col = col0_0; *vertices++ = v;
+		                            v.Y = ctx->adv.y2;           v.V = v1; v.Col = col0_1; *vertices++ = v;
+		v.X = ctx->adv.x2 + (count - 1);               v.U = u2;           v.Col = col1_1; *vertices++ = v;
 	} else {
-		v.X = adv_x1;               v.Y = adv_y1; v.U = u1; v.V = v2; v.Col = col0_0; *vertices++ = v;
-		                            v.Y = adv_y2;           v.V = v1; v.Col = col0_1; *vertices++ = v;
-		v.X = adv_x2 + (count - 1);               v.U = u2;           v.Col = col1_1; *vertices++ = v;
-		                            v.Y = adv_y1;           v.V = v2; v.Col = col1_0; *vertices++ = v;
+		v.X = ctx->adv.x1;               v.Y = ctx->adv.y1; v.U = u1; v.V = v2; v.Col = col0_0; *vertices++ = v;
+		                            v.Y = ctx->adv.y2;           v.V = v1; v.Col = col0_1; *vertices++ = v;
+		v.X = ctx->adv.x2 + (count - 1);               v.U = u2;           v.Col = col1_1; *vertices++ = v;
+		                            v.Y = ctx->adv.y1;           v.V = v2; v.Col = col1_0; *vertices++ = v;
 	}
 	part->fVertices[FACE_ZMIN] = vertices;
 }
 
-static void Adv_DrawZMax(int count) {
-	TextureLoc texLoc = Block_Tex(Builder_Block, FACE_ZMAX);
+static void Adv_DrawZMax(struct BuilderContext* ctx, int count) {
+	TextureLoc texLoc = Block_Tex(ctx->Block, FACE_ZMAX);
 	float vOrigin = Atlas1D_RowId(texLoc) * Atlas1D.InvTileSize;
 
-	float u1 = adv_minBB.X, u2 = (count - 1) + adv_maxBB.X * UV2_Scale;
-	float v1 = vOrigin + adv_maxBB.Y * Atlas1D.InvTileSize;
-	float v2 = vOrigin + adv_minBB.Y * Atlas1D.InvTileSize * UV2_Scale;
-	struct Builder1DPart* part = &Builder_Parts[adv_baseOffset + Atlas1D_Index(texLoc)];
+	float u1 = ctx->adv.minBB.X, u2 = (count - 1) + ctx->adv.maxBB.X * UV2_Scale;
+	float v1 = vOrigin + ctx->adv.maxBB.Y * Atlas1D.InvTileSize;
+	float v2 = vOrigin + ctx->adv.minBB.Y * Atlas1D.InvTileSize * UV2_Scale;
+	struct Builder1DPart* part = &ctx->Parts[ctx->adv.baseOffset + Atlas1D_Index(texLoc)];
 
-	int F = adv_bitFlags[Builder_ChunkIndex];
+	int F = ctx->adv.bitFlags[ctx->ChunkIndex];
 	int aX0_Y0 = Adv_CountBits(F, xM1_yM1_zP1, xM1_yCC_zP1, xCC_yM1_zP1, xCC_yCC_zP1);
 	int aX1_Y0 = Adv_CountBits(F, xP1_yM1_zP1, xP1_yCC_zP1, xCC_yM1_zP1, xCC_yCC_zP1);
 	int aX0_Y1 = Adv_CountBits(F, xM1_yP1_zP1, xM1_yCC_zP1, xCC_yP1_zP1, xCC_yCC_zP1);
 	int aX1_Y1 = Adv_CountBits(F, xP1_yP1_zP1, xP1_yCC_zP1, xCC_yP1_zP1, xCC_yCC_zP1);
 
 	PackedCol tint, white = PACKEDCOL_WHITE;
-	PackedCol col1_1 = Builder_FullBright ? white : adv_lerpZ[aX1_Y1], col1_0 = Builder_FullBright ? white : adv_lerpZ[aX1_Y0];
-	PackedCol col0_0 = Builder_FullBright ? white : adv_lerpZ[aX0_Y0], col0_1 = Builder_FullBright ? white : adv_lerpZ[aX0_Y1];
+	PackedCol col1_1 = ctx->FullBright ? white : ctx->adv.lerpZ[aX1_Y1], col1_0 = ctx->FullBright ? white : ctx->adv.lerpZ[aX1_Y0];
+	PackedCol col0_0 = ctx->FullBright ? white : ctx->adv.lerpZ[aX0_Y0], col0_1 = ctx->FullBright ? white : ctx->adv.lerpZ[aX0_Y1];
 	struct VertexTextured* vertices, v;
 
-	if (Builder_Tinted) {
-		tint   = Blocks.FogCol[Builder_Block];
+	if (ctx->Tinted) {
+		tint   = Blocks.FogCol[ctx->Block];
 		col0_0 = PackedCol_Tint(col0_0, tint); col1_0 = PackedCol_Tint(col1_0, tint);
 		col1_1 = PackedCol_Tint(col1_1, tint); col0_1 = PackedCol_Tint(col0_1, tint);
 	}
 
 	vertices = part->fVertices[FACE_ZMAX];
-	v.Z = adv_z2;
+	v.Z = ctx->adv.z2;
 	if (aX1_Y1 + aX0_Y0 > aX0_Y1 + aX1_Y0) {
-		v.X = adv_x1;               v.Y = adv_y2; v.U = u1; v.V = v1; v.Col = col0_1; *vertices++ = v;
-		                            v.Y = adv_y1;           v.V = v2; v.Col = col0_0; *vertices++ = v;
-		v.X = adv_x2 + (count - 1);               v.U = u2;           v.Col = col1_0; *vertices++ = v;
-		                            v.Y = adv_y2;           v.V = v1; v.Col = col1_1; *vertices++ = v;
+		v.X = ctx->adv.x1;               v.Y = ctx->adv.y2; v.U = u1; v.V = v1; v.Col = col0_1; *vertices++ = v;
+		                            v.Y = ctx->adv.y1;           v.V = v2; v.Col = col0_0; *vertices++ = v;
+		v.X = ctx->adv.x2 + (count - 1);               v.U = u2;           v.Col = col1_0; *vertices++ = v;
+		                            v.Y = ctx->adv.y2;           v.V = v1; v.Col = col1_1; *vertices++ = v;
 	} else {
-		v.X = adv_x2 + (count - 1); v.Y = adv_y2; v.U = u2; v.V = v1; v.Col = col1_1; *vertices++ = v;
-		v.X = adv_x1;                             v.U = u1;           v.Col = col0_1; *vertices++ = v;
-		                            v.Y = adv_y1;           v.V = v2; v.Col = col0_0; *vertices++ = v;
-		v.X = adv_x2 + (count - 1);               v.U = u2;           v.Col = col1_0; *vertices++ = v;
+		v.X = ctx->adv.x2 + (count - 1); v.Y = ctx->adv.y2; v.U = u2; v.V = v1; v.Col = col1_1; *vertices++ = v;
+		v.X = ctx->adv.x1;                             v.U = u1;           v.Col = col0_1; *vertices++ = v;
+		                            v.Y = ctx->adv.y1;           v.V = v2; v.Col = col0_0; *vertices++ = v;
+		v.X = ctx->adv.x2 + (count - 1);               v.U = u2;           v.Col = col1_0; *vertices++ = v;
 	}
 	part->fVertices[FACE_ZMAX] = vertices;
 }
 
-static void Adv_DrawYMin(int count) {
-	TextureLoc texLoc = Block_Tex(Builder_Block, FACE_YMIN);
+static void Adv_DrawYMin(struct BuilderContext* ctx, int count) {
+	TextureLoc texLoc = Block_Tex(ctx->Block, FACE_YMIN);
 	float vOrigin = Atlas1D_RowId(texLoc) * Atlas1D.InvTileSize;
 
-	float u1 = adv_minBB.X, u2 = (count - 1) + adv_maxBB.X * UV2_Scale;
-	float v1 = vOrigin + adv_minBB.Z * Atlas1D.InvTileSize;
-	float v2 = vOrigin + adv_maxBB.Z * Atlas1D.InvTileSize * UV2_Scale;
-	struct Builder1DPart* part = &Builder_Parts[adv_baseOffset + Atlas1D_Index(texLoc)];
+	float u1 = ctx->adv.minBB.X, u2 = (count - 1) + ctx->adv.maxBB.X * UV2_Scale;
+	float v1 = vOrigin + ctx->adv.minBB.Z * Atlas1D.InvTileSize;
+	float v2 = vOrigin + ctx->adv.maxBB.Z * Atlas1D.InvTileSize * UV2_Scale;
+	struct Builder1DPart* part = &ctx->Parts[ctx->adv.baseOffset + Atlas1D_Index(texLoc)];
 
-	int F = adv_bitFlags[Builder_ChunkIndex];
+	int F = ctx->adv.bitFlags[ctx->ChunkIndex];
 	int aX0_Z0 = Adv_CountBits(F, xM1_yM1_zM1, xM1_yM1_zCC, xCC_yM1_zM1, xCC_yM1_zCC);
 	int aX1_Z0 = Adv_CountBits(F, xP1_yM1_zM1, xP1_yM1_zCC, xCC_yM1_zM1, xCC_yM1_zCC);
 	int aX0_Z1 = Adv_CountBits(F, xM1_yM1_zP1, xM1_yM1_zCC, xCC_yM1_zP1, xCC_yM1_zCC);
 	int aX1_Z1 = Adv_CountBits(F, xP1_yM1_zP1, xP1_yM1_zCC, xCC_yM1_zP1, xCC_yM1_zCC);
 
 	PackedCol tint, white = PACKEDCOL_WHITE;
-	PackedCol col0_1 = Builder_FullBright ? white : adv_lerpY[aX0_Z1], col1_1 = Builder_FullBright ? white : adv_lerpY[aX1_Z1];
-	PackedCol col1_0 = Builder_FullBright ? white : adv_lerpY[aX1_Z0], col0_0 = Builder_FullBright ? white : adv_lerpY[aX0_Z0];
+	PackedCol col0_1 = ctx->FullBright ? white : ctx->adv.lerpY[aX0_Z1], col1_1 = ctx->FullBright ? white : ctx->adv.lerpY[aX1_Z1];
+	PackedCol col1_0 = ctx->FullBright ? white : ctx->adv.lerpY[aX1_Z0], col0_0 = ctx->FullBright ? white : ctx->adv.lerpY[aX0_Z0];
 	struct VertexTextured* vertices, v;
 
-	if (Builder_Tinted) {
-		tint   = Blocks.FogCol[Builder_Block];
+	if (ctx->Tinted) {
+		tint   = Blocks.FogCol[ctx->Block];
 		col0_0 = PackedCol_Tint(col0_0, tint); col1_0 = PackedCol_Tint(col1_0, tint);
 		col1_1 = PackedCol_Tint(col1_1, tint); col0_1 = PackedCol_Tint(col0_1, tint);
 	}
 
 	vertices = part->fVertices[FACE_YMIN];
-	v.Y = adv_y1;
+	v.Y = ctx->adv.y1;
 	if (aX0_Z1 + aX1_Z0 > aX0_Z0 + aX1_Z1) {
-		v.X = adv_x2 + (count - 1); v.Z = adv_z2; v.U = u2; v.V = v2; v.Col = col1_1; *vertices++ = v;
-		v.X = adv_x1;                             v.U = u1;           v.Col = col0_1; *vertices++ = v;
-		                            v.Z = adv_z1;           v.V = v1; v.Col = col0_0; *vertices++ = v;
-		v.X = adv_x2 + (count - 1);               v.U = u2;           v.Col = col1_0; *vertices++ = v;
+		v.X = ctx->adv.x2 + (count - 1); v.Z = ctx->adv.z2; v.U = u2; v.V = v2; v.Col = col1_1; *vertices++ = v;
+		v.X = ctx->adv.x1;                             v.U = u1;           v.Col = col0_1; *vertices++ = v;
+		                            v.Z = ctx->adv.z1;           v.V = v1; v.Col = col0_0; *vertices++ = v;
+		v.X = ctx->adv.x2 + (count - 1);               v.U = u2;           v.Col = col1_0; *vertices++ = v;
 	} else {
-		v.X = adv_x1;               v.Z = adv_z2; v.U = u1; v.V = v2; v.Col = col0_1; *vertices++ = v;
-		                            v.Z = adv_z1;           v.V = v1; v.Col = col0_0; *vertices++ = v;
-		v.X = adv_x2 + (count - 1);               v.U = u2;           v.Col = col1_0; *vertices++ = v;
-		                            v.Z = adv_z2;           v.V = v2; v.Col = col1_1; *vertices++ = v;
+		v.X = ctx->adv.x1;               v.Z = ctx->adv.z2; v.U = u1; v.V = v2; v.Col = col0_1; *vertices++ = v;
+		                            v.Z = ctx->adv.z1;           v.V = v1; v.Col = col0_0; *vertices++ = v;
+		v.X = ctx->adv.x2 + (count - 1);               v.U = u2;           v.Col = col1_0; *vertices++ = v;
+		                            v.Z = ctx->adv.z2;           v.V = v2; v.Col = col1_1; *vertices++ = v;
 	}
 	part->fVertices[FACE_YMIN] = vertices;
 }
 
-static void Adv_DrawYMax(int count) {
-	TextureLoc texLoc = Block_Tex(Builder_Block, FACE_YMAX);
+static void Adv_DrawYMax(struct BuilderContext* ctx, int count) {
+	TextureLoc texLoc = Block_Tex(ctx->Block, FACE_YMAX);
 	float vOrigin = Atlas1D_RowId(texLoc) * Atlas1D.InvTileSize;
 
-	float u1 = adv_minBB.X, u2 = (count - 1) + adv_maxBB.X * UV2_Scale;
-	float v1 = vOrigin + adv_minBB.Z * Atlas1D.InvTileSize;
-	float v2 = vOrigin + adv_maxBB.Z * Atlas1D.InvTileSize * UV2_Scale;
-	struct Builder1DPart* part = &Builder_Parts[adv_baseOffset + Atlas1D_Index(texLoc)];
+	float u1 = ctx->adv.minBB.X, u2 = (count - 1) + ctx->adv.maxBB.X * UV2_Scale;
+	float v1 = vOrigin + ctx->adv.minBB.Z * Atlas1D.InvTileSize;
+	float v2 = vOrigin + ctx->adv.maxBB.Z * Atlas1D.InvTileSize * UV2_Scale;
+	struct Builder1DPart* part = &ctx->Parts[ctx->adv.baseOffset + Atlas1D_Index(texLoc)];
 
-	int F = adv_bitFlags[Builder_ChunkIndex];
+	int F = ctx->adv.bitFlags[ctx->ChunkIndex];
 	int aX0_Z0 = Adv_CountBits(F, xM1_yP1_zM1, xM1_yP1_zCC, xCC_yP1_zM1, xCC_yP1_zCC);
 	int aX1_Z0 = Adv_CountBits(F, xP1_yP1_zM1, xP1_yP1_zCC, xCC_yP1_zM1, xCC_yP1_zCC);
 	int aX0_Z1 = Adv_CountBits(F, xM1_yP1_zP1, xM1_yP1_zCC, xCC_yP1_zP1, xCC_yP1_zCC);
 	int aX1_Z1 = Adv_CountBits(F, xP1_yP1_zP1, xP1_yP1_zCC, xCC_yP1_zP1, xCC_yP1_zCC);
 
 	PackedCol tint, white = PACKEDCOL_WHITE;
-	PackedCol col0_0 = Builder_FullBright ? white : adv_lerp[aX0_Z0], col1_0 = Builder_FullBright ? white : adv_lerp[aX1_Z0];
-	PackedCol col1_1 = Builder_FullBright ? white : adv_lerp[aX1_Z1], col0_1 = Builder_FullBright ? white : adv_lerp[aX0_Z1];
+	PackedCol col0_0 = ctx->FullBright ? white : ctx->adv.lerp[aX0_Z0], col1_0 = ctx->FullBright ? white : ctx->adv.lerp[aX1_Z0];
+	PackedCol col1_1 = ctx->FullBright ? white : ctx->adv.lerp[aX1_Z1], col0_1 = ctx->FullBright ? white : ctx->adv.lerp[aX0_Z1];
 	struct VertexTextured* vertices, v;
 
-	if (Builder_Tinted) {
-		tint   = Blocks.FogCol[Builder_Block];
+	if (ctx->Tinted) {
+		tint   = Blocks.FogCol[ctx->Block];
 		col0_0 = PackedCol_Tint(col0_0, tint); col1_0 = PackedCol_Tint(col1_0, tint);
 		col1_1 = PackedCol_Tint(col1_1, tint); col0_1 = PackedCol_Tint(col0_1, tint);
 	}
 
 	vertices = part->fVertices[FACE_YMAX];
-	v.Y = adv_y2;
+	v.Y = ctx->adv.y2;
 	if (aX0_Z0 + aX1_Z1 > aX0_Z1 + aX1_Z0) {
-		v.X = adv_x2 + (count - 1); v.Z = adv_z1; v.U = u2; v.V = v1; v.Col = col1_0; *vertices++ = v;
-		v.X = adv_x1;                             v.U = u1;           v.Col = col0_0; *vertices++ = v;
-		                            v.Z = adv_z2;           v.V = v2; v.Col = col0_1; *vertices++ = v;
-		v.X = adv_x2 + (count - 1);               v.U = u2;           v.Col = col1_1; *vertices++ = v;
+		v.X = ctx->adv.x2 + (count - 1); v.Z = ctx->adv.z1; v.U = u2; v.V = v1; v.Col = col1_0; *vertices++ = v;
+		v.X = ctx->adv.x1;                             v.U = u1;           v.Col = col0_0; *vertices++ = v;
+		                            v.Z = ctx->adv.z2;           v.V = v2; v.Col = col0_1; *vertices++ = v;
+		v.X = ctx->adv.x2 + (count - 1);               v.U = u2;           v.Col = col1_1; *vertices++ = v;
 	} else {
-		v.X = adv_x1;               v.Z = adv_z1; v.U = u1; v.V = v1; v.Col = col0_0; *vertices++ = v;
-		                            v.Z = adv_z2;           v.V = v2; v.Col = col0_1; *vertices++ = v;
-		v.X = adv_x2 + (count - 1);               v.U = u2;           v.Col = col1_1; *vertices++ = v;
-		                            v.Z = adv_z1;           v.V = v1; v.Col = col1_0; *vertices++ = v;
+		v.X = ctx->adv.x1;               v.Z = ctx->adv.z1; v.U = u1; v.V = v1; v.Col = col0_0; *vertices++ = v;
+		                            v.Z = ctx->adv.z2;           v.V = v2; v.Col = col0_1; *vertices++ = v;
+		v.X = ctx->adv.x2 + (count - 1);               v.U = u2;           v.Col = col1_1; *vertices++ = v;
+		                            v.Z = ctx->adv.z1;           v.V = v1; v.Col = col1_0; *vertices++ = v;
 	}
 	part->fVertices[FACE_YMAX] = vertices;
 }
 
-static void Adv_RenderBlock(int index) {
+static void Adv_RenderBlock(struct BuilderContext* ctx, int index) {
 	Vec3 min, max;
 	int count_XMin, count_XMax, count_ZMin;
 	int count_ZMax, count_YMin, count_YMax;
 
-	if (Blocks.Draw[Builder_Block] == DRAW_SPRITE) {
-		Builder_FullBright = Blocks.FullBright[Builder_Block];
-		Builder_Tinted     = Blocks.Tinted[Builder_Block];
-		Builder_DrawSprite();
+	if (Blocks.Draw[ctx->Block] == DRAW_SPRITE) {
+		ctx->FullBright = Blocks.FullBright[ctx->Block];
+		ctx->Tinted     = Blocks.Tinted[ctx->Block];
+		Builder_DrawSprite(ctx);
 		return;
 	}
 
-	count_XMin = Builder_Counts[index + FACE_XMIN];
-	count_XMax = Builder_Counts[index + FACE_XMAX];
-	count_ZMin = Builder_Counts[index + FACE_ZMIN];
-	count_ZMax = Builder_Counts[index + FACE_ZMAX];
-	count_YMin = Builder_Counts[index + FACE_YMIN];
-	count_YMax = Builder_Counts[index + FACE_YMAX];
+	count_XMin = ctx->Counts[index + FACE_XMIN];
+	count_XMax = ctx->Counts[index + FACE_XMAX];
+	count_ZMin = ctx->Counts[index + FACE_ZMIN];
+	count_ZMax = ctx->Counts[index + FACE_ZMAX];
+	count_YMin = ctx->Counts[index + FACE_YMIN];
+	count_YMax = ctx->Counts[index + FACE_YMAX];
 
 	if (!count_XMin && !count_XMax && !count_ZMin &&
 		!count_ZMax && !count_YMin && !count_YMax) return;
 
-	Builder_FullBright = Blocks.FullBright[Builder_Block];
-	adv_baseOffset = (Blocks.Draw[Builder_Block] == DRAW_TRANSLUCENT) * ATLAS1D_MAX_ATLASES;
-	adv_lightFlags = Blocks.LightOffset[Builder_Block];
-	Builder_Tinted = Blocks.Tinted[Builder_Block];
+	ctx->FullBright = Blocks.FullBright[ctx->Block];
+	ctx->adv.baseOffset = (Blocks.Draw[ctx->Block] == DRAW_TRANSLUCENT) * ATLAS1D_MAX_ATLASES;
+	ctx->adv.lightFlags = Blocks.LightOffset[ctx->Block];
+	ctx->Tinted = Blocks.Tinted[ctx->Block];
 
-	min = Blocks.RenderMinBB[Builder_Block]; max = Blocks.RenderMaxBB[Builder_Block];
-	adv_x1 = Builder_X + min.X; adv_y1 = Builder_Y + min.Y; adv_z1 = Builder_Z + min.Z;
-	adv_x2 = Builder_X + max.X; adv_y2 = Builder_Y + max.Y; adv_z2 = Builder_Z + max.Z;
+	min = Blocks.RenderMinBB[ctx->Block]; max = Blocks.RenderMaxBB[ctx->Block];
+	ctx->adv.x1 = ctx->X + min.X; ctx->adv.y1 = ctx->Y + min.Y; ctx->adv.z1 = ctx->Z + min.Z;
+	ctx->adv.x2 = ctx->X + max.X; ctx->adv.y2 = ctx->Y + max.Y; ctx->adv.z2 = ctx->Z + max.Z;
 
-	adv_minBB = Blocks.MinBB[Builder_Block]; adv_maxBB = Blocks.MaxBB[Builder_Block];
-	adv_minBB.Y = 1.0f - adv_minBB.Y; adv_maxBB.Y = 1.0f - adv_maxBB.Y;
+	ctx->adv.minBB = Blocks.MinBB[ctx->Block]; ctx->adv.maxBB = Blocks.MaxBB[ctx->Block];
+	ctx->adv.minBB.Y = 1.0f - ctx->adv.minBB.Y; ctx->adv.maxBB.Y = 1.0f - ctx->adv.maxBB.Y;
 
-	if (count_XMin) Adv_DrawXMin(count_XMin);
-	if (count_XMax) Adv_DrawXMax(count_XMax);
-	if (count_ZMin) Adv_DrawZMin(count_ZMin);
-	if (count_ZMax) Adv_DrawZMax(count_ZMax);
-	if (count_YMin) Adv_DrawYMin(count_YMin);
-	if (count_YMax) Adv_DrawYMax(count_YMax);
+	if (count_XMin) Adv_DrawXMin(ctx, count_XMin);
+	if (count_XMax) Adv_DrawXMax(ctx, count_XMax);
+	if (count_ZMin) Adv_DrawZMin(ctx, count_ZMin);
+	if (count_ZMax) Adv_DrawZMax(ctx, count_ZMax);
+	if (count_YMin) Adv_DrawYMin(ctx, count_YMin);
+	if (count_YMax) Adv_DrawYMax(ctx, count_YMax);
 }
 
-static void Adv_PreStretchTiles(void) {
+static void Adv_PreStretchTiles(struct BuilderContext* ctx) {
 	int i;
-	DefaultPreStretchTiles();
-	adv_bitFlags = Builder_BitFlags;
+	DefaultPreStretchTiles(ctx);
+	ctx->adv.bitFlags = ctx->BitFlags;
 
 	for (i = 0; i <= 4; i++) {
-		adv_lerp[i]  = PackedCol_Lerp(Env.ShadowCol,   Env.SunCol,   i / 4.0f);
-		adv_lerpX[i] = PackedCol_Lerp(Env.ShadowXSide, Env.SunXSide, i / 4.0f);
-		adv_lerpZ[i] = PackedCol_Lerp(Env.ShadowZSide, Env.SunZSide, i / 4.0f);
-		adv_lerpY[i] = PackedCol_Lerp(Env.ShadowYMin,  Env.SunYMin,  i / 4.0f);
+		ctx->adv.lerp[i]  = PackedCol_Lerp(Env.ShadowCol,   Env.SunCol,   i / 4.0f);
+		ctx->adv.lerpX[i] = PackedCol_Lerp(Env.ShadowXSide, Env.SunXSide, i / 4.0f);
+		ctx->adv.lerpZ[i] = PackedCol_Lerp(Env.ShadowZSide, Env.SunZSide, i / 4.0f);
+		ctx->adv.lerpY[i] = PackedCol_Lerp(Env.ShadowYMin,  Env.SunYMin,  i / 4.0f);
 	}
 }
 
@@ -1248,19 +1522,261 @@ static void AdvBuilder_SetActive(void) {
 }
 
 
+/*########################################################################################################################*
+*--------------------------------------------------Mesh builder threads---------------------------------------------------*
+*#########################################################################################################################*/
+/* Chunk meshes are built by a fork-join pool of worker threads. The main thread hands out a batch of */
+/*  chunks, then uploads each chunk's mesh as soon as it is built (building chunks itself when idle). */
+/* Since the main thread doesn't return until the whole batch is done, the world and lighting are */
+/*  never modified while worker threads are reading them. */
+#define BUILDER_MAX_WORKERS 16
+static struct BuilderContext* contexts; /* contexts[0] is used by the main thread */
+static void* workerThreads[BUILDER_MAX_WORKERS];
+static int workersCount, workersStarted;
+static cc_bool workersTerminate;
+
+static void* jobsMutex;
+static void* jobsAvailable; /* Signalled when there are chunks waiting to be built */
+static void* jobsFinished;  /* Signalled when a worker thread has finished building a chunk */
+
+static struct ChunkMesh jobs[BUILDER_MAX_CHUNKS];
+static int jobsCount, jobsNext;
+/* Indices of jobs that have been built, but not yet uploaded */
+static int builtJobs[BUILDER_MAX_CHUNKS];
+static int builtCount;
+/* Bytes of vertices that have been built, but not yet uploaded */
+static cc_uint32 meshesMemory, peakMeshesMemory;
+
+/* NOTE: Must be called with jobsMutex locked */
+static void TrackBuiltMesh(struct ChunkMesh* mesh) {
+	if (!mesh->vertices) return;
+	meshesMemory    += mesh->verticesCount * MESH_VERTEX_SIZE;
+	peakMeshesMemory = max(peakMeshesMemory, meshesMemory);
+}
+
+static void WorkerLoop(void) {
+	struct BuilderContext* ctx;
+	cc_bool stop, more;
+	int job;
+
+	Mutex_Lock(jobsMutex);
+	{
+		ctx = &contexts[++workersStarted];
+	}
+	Mutex_Unlock(jobsMutex);
+
+	for (;;) {
+		Mutex_Lock(jobsMutex);
+		{
+			stop = workersTerminate;
+			job  = jobsNext < jobsCount ? jobsNext++ : -1;
+			more = jobsNext < jobsCount;
+		}
+		Mutex_Unlock(jobsMutex);
+
+		/* Wake up another worker thread, so that it also stops/starts building a chunk */
+		if (stop) { Waitable_Signal(jobsAvailable); return; }
+		if (job == -1) { Waitable_Wait(jobsAvailable); continue; }
+		if (more) Waitable_Signal(jobsAvailable);
+
+		BuildMesh(ctx, &jobs[job]);
+		Mutex_Lock(jobsMutex);
+		{
+			builtJobs[builtCount++] = job;
+			TrackBuiltMesh(&jobs[job]);
+		}
+		Mutex_Unlock(jobsMutex);
+		Waitable_Signal(jobsFinished);
+	}
+}
+
+static void Builder_StartWorkers(void) {
+	/* Leave one processor free for the main thread */
+	int i, count = Thread_ProcessorsCount() - 1;
+	workersCount = min(count, BUILDER_MAX_WORKERS);
+
+	contexts = (struct BuilderContext*)Mem_Alloc(workersCount + 1, sizeof(struct BuilderContext), "builder contexts");
+	jobsMutex     = Mutex_Create();
+	jobsAvailable = Waitable_Create();
+	jobsFinished  = Waitable_Create();
+
+	workersTerminate = false;
+	workersStarted   = 0;
+	for (i = 0; i < workersCount; i++) {
+		workerThreads[i] = Thread_Start(WorkerLoop);
+	}
+}
+
+static void Builder_StopWorkers(void) {
+	int i;
+	Mutex_Lock(jobsMutex);
+	{
+		workersTerminate = true;
+	}
+	Mutex_Unlock(jobsMutex);
+
+	Waitable_Signal(jobsAvailable);
+	for (i = 0; i < workersCount; i++) {
+		Thread_Join(workerThreads[i]);
+	}
+
+	Mutex_Free(jobsMutex);
+	Waitable_Free(jobsAvailable);
+	Waitable_Free(jobsFinished);
+	Mem_Free(contexts);
+	contexts = NULL;
+}
+
+/* Builds the meshes of the given chunks, calling finish on this thread for each built mesh */
+static void RunJobs(struct ChunkInfo** chunks, int count, void (*finish)(struct ChunkMesh* mesh)) {
+	int i, job, finished = 0;
+	cc_bool built;
+	if (!count) return;
+	/* Worker threads only read the heightmap, so any stale light heights must be calculated first */
+	Lighting_Update();
+
+	Mutex_Lock(jobsMutex);
+	{
+		for (i = 0; i < count; i++) { jobs[i].info = chunks[i]; }
+		jobsCount  = count;
+		jobsNext   = 0;
+		builtCount = 0;
+	}
+	Mutex_Unlock(jobsMutex);
+	if (workersCount) Waitable_Signal(jobsAvailable);
+
+	while (finished < count) {
+		Mutex_Lock(jobsMutex);
+		{
+			built = builtCount > 0;
+			if (built) {
+				job = builtJobs[--builtCount];
+			} else {
+				job = jobsNext < jobsCount ? jobsNext++ : -1;
+			}
+		}
+		Mutex_Unlock(jobsMutex);
+		if (job == -1) { Waitable_Wait(jobsFinished); continue; }
+
+		/* Build chunks on this thread too, rather than sitting idle */
+		if (!built) {
+			BuildMesh(&contexts[0], &jobs[job]);
+			Mutex_Lock(jobsMutex);
+			{
+				TrackBuiltMesh(&jobs[job]);
+			}
+			Mutex_Unlock(jobsMutex);
+		}
+
+		Mutex_Lock(jobsMutex);
+		{
+			if (jobs[job].vertices) meshesMemory -= jobs[job].verticesCount * MESH_VERTEX_SIZE;
+		}
+		Mutex_Unlock(jobsMutex);
+		finish(&jobs[job]);
+		finished++;
+	}
+}
+
+static Builder_ChunkBuilt chunkBuilt;
+static void FinishUpload(struct ChunkMesh* mesh) {
+	UploadMesh(mesh);
+	chunkBuilt(mesh->info);
+}
+
+void Builder_MakeChunks(struct ChunkInfo** chunks, int count, Builder_ChunkBuilt onBuilt) {
+	chunkBuilt = onBuilt;
+	RunJobs(chunks, count, FinishUpload);
+}
+
+
+/*########################################################################################################################*
+*----------------------------------------------------Mesh benchmarking----------------------------------------------------*
+*#########################################################################################################################*/
+static struct BuilderBenchmark* bench;
+static void FinishBenchmark(struct ChunkMesh* mesh) {
+	bench->chunks++;
+	if (!mesh->vertices) return;
+
+	bench->vertices += mesh->verticesCount;
+	Mem_Free(mesh->vertices);
+	mesh->vertices = NULL;
+}
+
+static void Builder_SetActive(cc_bool smoothLighting);
+
+cc_bool Builder_Benchmark(cc_bool smoothLighting, struct BuilderBenchmark* result) {
+	struct ChunkInfo* chunks;
+	struct ChunkInfo** ptrs;
+	int x, y, z, i, count;
+	cc_uint64 beg, end;
+
+	count = MapRenderer_ChunksCount;
+	if (!World.Blocks || !count) return false;
+	chunks = (struct ChunkInfo*)Mem_TryAlloc(count, sizeof(struct ChunkInfo));
+	ptrs   = (struct ChunkInfo**)Mem_TryAlloc(count, sizeof(struct ChunkInfo*));
+	if (!chunks || !ptrs) { Mem_Free(chunks); Mem_Free(ptrs); return false; }
+
+	/* Building chunk meshes overwrites the renderer's chunk part infos */
+	MapRenderer_Refresh();
+	for (z = 0, i = 0; z < MapRenderer_ChunksZ; z++) {
+		for (y = 0; y < MapRenderer_ChunksY; y++) {
+			for (x = 0; x < MapRenderer_ChunksX; x++, i++) {
+				chunks[i].CentreX = (x << CHUNK_SHIFT) + HALF_CHUNK_SIZE;
+				chunks[i].CentreY = (y << CHUNK_SHIFT) + HALF_CHUNK_SIZE;
+				chunks[i].CentreZ = (z << CHUNK_SHIFT) + HALF_CHUNK_SIZE;
+				ptrs[i] = &chunks[i];
+			}
+		}
+	}
+
+	Builder_SetActive(smoothLighting);
+	Mem_Set(result, 0, sizeof(struct BuilderBenchmark));
+	bench = result;
+	peakMeshesMemory = 0;
+
+	beg = Stopwatch_Measure();
+	for (i = 0; i < count; i += BUILDER_MAX_CHUNKS) {
+		RunJobs(ptrs + i, min(count - i, BUILDER_MAX_CHUNKS), FinishBenchmark);
+	}
+	end = Stopwatch_Measure();
+
+	result->elapsed    = Stopwatch_ElapsedMicroseconds(beg, end);
+	result->threads    = workersCount + 1;
+	result->peakMemory = peakMeshesMemory + (workersCount + 1) * sizeof(struct BuilderContext);
+
+	Builder_ApplyActive();
+	Mem_Free(chunks);
+	Mem_Free(ptrs);
+	return true;
+}
+
+
 /*########################################################################################################################*
 *---------------------------------------------------Builder interface-----------------------------------------------------*
 *#########################################################################################################################*/
-cc_bool Builder_SmoothLighting;
-void Builder_ApplyActive(void) {
-	if (Builder_SmoothLighting) {
+cc_bool Builder_SmoothLighting, Builder_GreedyMeshing, Builder_TileRepeat;
+cc_bool Builder_PackedVertices;
+static cc_bool usePackedVertices;
+static void Builder_SetActive(cc_bool smoothLighting) {
+	cc_bool greedy = !smoothLighting && Builder_GreedyMeshing && Gfx.TileRepeat;
+	Builder_PackedVertices = usePackedVertices && Gfx.PackedVertices;
+	/* Rows of packed vertices are always decoded using the tile size */
+	Builder_TileRepeat     = greedy || Builder_PackedVertices;
+
+	if (smoothLighting) {
 		AdvBuilder_SetActive();
+	} else if (greedy) {
+		GreedyBuilder_SetActive();
 	} else {
 		NormalBuilder_SetActive();
 	}
 }
 
+void Builder_ApplyActive(void) { Builder_SetActive(Builder_SmoothLighting); }
+
 static void OnInit(void) {
+	Builder_StartWorkers();
 	Builder_Offsets[FACE_XMIN] = -1;
 	Builder_Offsets[FACE_XMAX] =  1;
 	Builder_Offsets[FACE_ZMIN] = -EXTCHUNK_SIZE;
@@ -1269,6 +1785,8 @@ static void OnInit(void) {
 	Builder_Offsets[FACE_YMAX] =  EXTCHUNK_SIZE_2;
 
 	if (!Game_ClassicMode) Builder_SmoothLighting = Options_GetBool(OPT_SMOOTH_LIGHTING, false);
+	Builder_GreedyMeshing = Options_GetBool(OPT_GREEDY_MESHING, false);
+	usePackedVertices     = Options_GetBool(OPT_PACKED_VERTICES, true);
 	Builder_ApplyActive();
 }
 
@@ -1277,9 +1795,13 @@ static void OnNewMapLoaded(void) {
 	Builder_EdgeLevel  = max(0, Env.EdgeHeight);
 }
 
+static void OnFree(void) {
+	Builder_StopWorkers();
+}
+
 struct IGameComponent Builder_Component = {
 	OnInit, /* Init */
-	NULL, /* Free */
+	OnFree, /* Free */
 	NULL, /* Reset */
 	NULL, /* OnNewMap */
 	OnNewMapLoaded /* OnNewMapLoaded */
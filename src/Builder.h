@@ -5,6 +5,8 @@
 NormalMeshBuilder:
    Implements a simple chunk mesh builder, where each block face is a single colour.
    (whatever lighting engine returns as light colour for given block face at given coordinates)
+GreedyMeshBuilder:
+   Variant of NormalMeshBuilder that also merges rows of stretched faces into rectangles.
 
 Copyright 2014-2021 ClassiCube | Licensed under BSD-3
 */
@@ -15,9 +17,36 @@ extern struct IGameComponent Builder_Component;
 extern int Builder_SidesLevel, Builder_EdgeLevel;
 /* Whether smooth/advanced lighting mesh builder is used. */
 extern cc_bool Builder_SmoothLighting;
+/* Whether coplanar faces are merged into rectangles along both axes. (instead of just runs along one axis) */
+/* NOTE: Only used with the normal mesh builder, and when Gfx.TileRepeat is supported. */
+extern cc_bool Builder_GreedyMeshing;
+/* Whether built chunk meshes must be drawn with Gfx_EnableTileRepeat enabled. */
+extern cc_bool Builder_TileRepeat;
+/* Whether built chunk meshes use VERTEX_FORMAT_PACKED instead of VERTEX_FORMAT_TEXTURED. */
+/* NOTE: Only used when Gfx.PackedVertices is supported. */
+extern cc_bool Builder_PackedVertices;
 
-/* Builds the mesh of vertices for the given chunk. */
-void Builder_MakeChunk(struct ChunkInfo* info);
+/* Maximum number of chunks that can be built in one call to Builder_MakeChunks. */
+#define BUILDER_MAX_CHUNKS 1024
+typedef void (*Builder_ChunkBuilt)(struct ChunkInfo* info);
+/* Builds the meshes of vertices for the given chunks, then uploads them to the GPU. */
+/* Meshes are built concurrently using worker threads, but are uploaded on the calling thread. */
+/* onBuilt is called (on the calling thread) for each chunk after its mesh has been uploaded. */
+/* NOTE: The world must not be modified until this method returns. */
+void Builder_MakeChunks(struct ChunkInfo** chunks, int count, Builder_ChunkBuilt onBuilt);
 
 void Builder_ApplyActive(void);
+
+/* Results of benchmarking the mesh builder. */
+struct BuilderBenchmark {
+	int chunks;           /* Number of chunks meshed */
+	int vertices;         /* Total number of vertices in the meshes */
+	int threads;          /* Number of threads used to build meshes (including main thread) */
+	cc_uint64 elapsed;    /* Time taken to mesh all the chunks, in microseconds */
+	cc_uint32 peakMemory; /* Peak memory used by mesh builder state and built vertices, in bytes */
+};
+/* Builds (but doesn't upload) the mesh of every chunk in the world, and measures how long it takes. */
+/* NOTE: All of the map renderer's chunks are refreshed, as building overwrites their part infos. */
+/* Returns false if there is no world loaded, or not enough memory. */
+cc_bool Builder_Benchmark(cc_bool smoothLighting, struct BuilderBenchmark* result);
 #endif
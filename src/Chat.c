@@ -18,6 +18,9 @@
 #include "TexturePack.h"
 #include "Options.h"
 #include "Drawer2D.h"
+#include "Builder.h"
+#include "MapRenderer.h"
+#include "Menus.h"
 
 static char msgs[10][STRING_SIZE];
 cc_string Chat_Status[4]       = { String_FromArray(msgs[0]), String_FromArray(msgs[1]), String_FromArray(msgs[2]), String_FromArray(msgs[3]) };
@@ -467,6 +470,101 @@ static struct ChatCommand ClearDeniedCommand = {
 	}
 };
 
+static void MeshBenchCommand_Report(const char* mode, struct BuilderBenchmark* b) {
+	float secs = b->elapsed ? b->elapsed / 1000000.0f : 1.0f;
+	float chunksPerSec   = b->chunks   / secs;
+	float verticesPerSec = b->vertices / secs;
+	int ms = (int)(b->elapsed / 1000), kb = (int)(b->peakMemory / 1024);
+
+	Chat_Add4("&e%c lighting: &f%i chunks in %i ms, using %i threads", mode, &b->chunks, &ms, &b->threads);
+	Chat_Add3("&f  %f0 chunks/s, %f0 vertices/s, %i KB peak memory", &chunksPerSec, &verticesPerSec, &kb);
+}
+
+static void MeshBenchCommand_Execute(const cc_string* args, int argsCount) {
+	struct BuilderBenchmark b;
+	if (!Builder_Benchmark(false, &b)) {
+		Chat_AddRaw("&e/client meshbench: &cNo map loaded, or not enough memory."); return;
+	}
+	MeshBenchCommand_Report("Normal", &b);
+
+	Builder_Benchmark(true, &b);
+	MeshBenchCommand_Report("Smooth", &b);
+}
+
+static struct ChatCommand MeshBenchCommand = {
+	"MeshBench", MeshBenchCommand_Execute, false,
+	{
+		"&a/client meshbench",
+		"&eMeshes every chunk in the map, using both the normal and",
+		"&e  smooth lighting mesh builders, and reports how fast it was.",
+		"&eUse a map generated with a fixed seed for comparable results.",
+	}
+};
+
+static void VbStatsCommand_Execute(const cc_string* args, int argsCount) {
+#ifndef CC_BUILD_GL11
+	struct TerrainVbStats s;
+	int usedKB, totalKB, largestKB;
+	cc_uint32 unused;
+	float fragmented;
+
+	MapRenderer_GetVbStats(&s);
+	usedKB    = (int)((s.used        * (cc_uint64)s.vertexSize) / 1024);
+	totalKB   = (int)((s.capacity    * (cc_uint64)s.vertexSize) / 1024);
+	largestKB = (int)((s.largestFree * (cc_uint64)s.vertexSize) / 1024);
+	/* How much of the unused space can't be allocated as one range */
+	unused     = s.capacity - s.used;
+	fragmented = unused ? 100.0f * (unused - s.largestFree) / unused : 0.0f;
+
+	Chat_Add4("&eTerrain VBs: &f%i buffers, %i chunk meshes, %i of %i KB used", 
+		&s.arenas, &s.allocations, &usedKB, &totalKB);
+	Chat_Add3("&f  %i free ranges, largest is %i KB, %f1%% fragmented", 
+		&s.freeRanges, &largestKB, &fragmented);
+	Chat_Add3("&f  %i buffers created, %i released, %i compactions", 
+		&s.arenasCreated, &s.arenasReleased, &s.compactions);
+#else
+	Chat_AddRaw("&e/client vbstats: &cNot supported by the OpenGL 1.1 backend.");
+#endif
+}
+
+static struct ChatCommand VbStatsCommand = {
+	"VbStats", VbStatsCommand_Execute, false,
+	{
+		"&a/client vbstats",
+		"&eReports how much of the vertex buffers that chunk meshes",
+		"&e  are allocated from is used, and how fragmented they are.",
+	}
+};
+
+static void SaveMapCommand_Execute(const cc_string* args, int argsCount) {
+	cc_string path; char pathBuffer[FILENAME_SIZE];
+
+	if (!argsCount) {
+		Chat_AddRaw("&e/client savemap: &cYou didn't specify a file name."); return;
+	}
+	if (!World.Blocks) {
+		Chat_AddRaw("&e/client savemap: &cNo map loaded."); return;
+	}
+
+	if (!Utils_EnsureDirectory("maps")) return;
+
+	String_InitArray(path, pathBuffer);
+	String_Format1(&path, "maps/%s.ccr", &args[0]);
+	/* Saved in the background the same way as the save menu, which prints a message once done */
+	if (!SaveLevelScreen_SaveMap(&path)) {
+		Chat_AddRaw("&e/client savemap: &cAnother map is still being saved.");
+	}
+}
+
+static struct ChatCommand SaveMapCommand = {
+	"SaveMap", SaveMapCommand_Execute, false,
+	{
+		"&a/client savemap [name]",
+		"&eSaves the map to maps/[name].ccr, which is split into",
+		"&e  regions that are compressed and loaded in parallel.",
+	}
+};
+
 
 /*########################################################################################################################*
 *-------------------------------------------------------CuboidCommand-----------------------------------------------------*
@@ -628,6 +726,9 @@ static void OnInit(void) {
 	Commands_Register(&CuboidCommand);
 	Commands_Register(&TeleportCommand);
 	Commands_Register(&ClearDeniedCommand);
+	Commands_Register(&MeshBenchCommand);
+	Commands_Register(&VbStatsCommand);
+	Commands_Register(&SaveMapCommand);
 
 #if defined CC_BUILD_MINFILES 
 #elif defined CC_BUILD_ANDROID
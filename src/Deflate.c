@@ -788,8 +788,6 @@ static const cc_uint16 deflate_dist[31] = {
 #define Deflate_PushBits(state, value, bits) state->Bits |= (value) << state->NumBits; state->NumBits += (bits);
 /* Pushes bits of the huffman codeword bits for the given literal, but does not write them */
 #define Deflate_PushLit(state, value) Deflate_PushBits(state, state->LitsCodewords[value], state->LitsLens[value])
-/* Pushes given bits (reversing for huffman code), but does not write them */
-#define Deflate_PushHuff(state, value, bits) Deflate_PushBits(state, Huffman_ReverseBits(value, bits), bits)
 /* Writes given byte to output */
 #define Deflate_WriteByte(state) *state->NextOut++ = state->Bits; state->AvailOut--; state->Bits >>= 8; state->NumBits -= 8;
 /* Flushes bits in buffer to output buffer */
@@ -797,6 +795,21 @@ static const cc_uint16 deflate_dist[31] = {
 
 #define MIN_MATCH_LEN 3
 #define MAX_MATCH_LEN 258
+#define DEFLATE_NUM_LITS  286
+#define DEFLATE_NUM_DISTS 30
+#define DEFLATE_MAX_CODE_BITS    15
+#define DEFLATE_MAX_CODELEN_BITS 7
+
+static const struct DeflateLevel {
+	cc_uint16 maxChain; /* Maximum number of previous matches to check */
+	cc_uint16 niceLen;  /* Stop searching once a match of at least this length is found */
+	cc_bool lazy;       /* Whether to check if a longer match starts at the next byte */
+	cc_bool dynamic;    /* Whether to use dynamic huffman codes when smaller than fixed codes */
+} deflate_levels[3] = {
+	{   4,  32, false, false }, /* DEFLATE_LEVEL_FAST */
+	{  16, 128, true,  true  }, /* DEFLATE_LEVEL_DEFAULT */
+	{ 128, 258, true,  true  }, /* DEFLATE_LEVEL_BEST */
+};
 
 /* Number of bytes that match (are the same) from a and b */
 static int Deflate_MatchLen(cc_uint8* a, cc_uint8* b, int maxLen) {
@@ -807,9 +820,279 @@ static int Deflate_MatchLen(cc_uint8* a, cc_uint8* b, int maxLen) {
 
 /* Hashes 3 bytes of data */
 static cc_uint32 Deflate_Hash(cc_uint8* src) {
-	return (cc_uint32)((src[0] << 8) ^ (src[1] << 4) ^ (src[2])) & DEFLATE_HASH_MASK;
+	return (cc_uint32)((src[0] << 10) ^ (src[1] << 5) ^ (src[2])) & DEFLATE_HASH_MASK;
+}
+
+/* Inserts the given position into the hash chain for the 3 bytes starting there */
+static void Deflate_Insert(struct DeflateState* state, int pos) {
+	cc_uint32 hash = Deflate_Hash(&state->Input[pos]);
+	state->Prev[pos]  = state->Head[hash];
+	state->Head[hash] = pos;
+}
+
+/* Finds the longest previous match for the data starting at the given position */
+/* Only explores up to maxChain previous matches, to avoid slow performance */
+static int Deflate_LongestMatch(struct DeflateState* state, const struct DeflateLevel* level, 
+								int pos, int maxLen, int* bestPos) {
+	cc_uint8* input = state->Input;
+	cc_uint8* cur   = input + pos;
+	int bestLen = MIN_MATCH_LEN - 1; /* Match must be at least 3 bytes */
+	int matchLen, depth, prev;
+
+	prev = state->Head[Deflate_Hash(cur)];
+	for (depth = 0; prev != 0 && depth < level->maxChain; depth++) {
+		/* Can't be a longer match if the byte just past best match length differs */
+		if (input[prev + bestLen] == cur[bestLen]) {
+			matchLen = Deflate_MatchLen(&input[prev], cur, maxLen);
+
+			if (matchLen > bestLen) {
+				bestLen  = matchLen;
+				*bestPos = prev;
+				if (matchLen >= level->niceLen || matchLen >= maxLen) break;
+			}
+		}
+		prev = state->Prev[prev];
+	}
+	return bestLen;
+}
+
+/* Adds a literal to the symbols of the current block */
+static void Deflate_AddLit(struct DeflateState* state, int lit) {
+	state->SymLits[state->NumSyms]  = lit;
+	state->SymDists[state->NumSyms] = 0;
+	state->NumSyms++;
+}
+
+/* Adds a length-distance pair to the symbols of the current block */
+static void Deflate_AddMatch(struct DeflateState* state, int len, int dist) {
+	state->SymLits[state->NumSyms]  = len - MIN_MATCH_LEN;
+	state->SymDists[state->NumSyms] = dist;
+	state->NumSyms++;
+}
+
+/* Converts the current block of data into literal and length-distance symbols */
+static void Deflate_Compress(struct DeflateState* state, int len) {
+	const struct DeflateLevel* level = &deflate_levels[state->Level - DEFLATE_LEVEL_FAST];
+	cc_uint8* input = state->Input;
+	int pos = DEFLATE_BLOCK_SIZE, end = DEFLATE_BLOCK_SIZE + len;
+	int curLen, curPos = 0, prevLen = 0, prevDist = 0;
+	cc_bool pending = false;
+
+	/* Based off descriptions from http://www.gzip.org/algorithm.txt and
+	https://github.com/nothings/stb/blob/master/stb_image_write.h */
+	state->NumSyms = 0;
+
+	/* Use > instead of >=, because also try match at one byte after current */
+	while (end - pos > MIN_MATCH_LEN) {
+		/* Previous byte's match is already long enough, so don't bother searching */
+		if (pending && prevLen >= level->niceLen) {
+			curLen = 0;
+		} else {
+			curLen = Deflate_LongestMatch(state, level, pos, min(end - pos, MAX_MATCH_LEN), &curPos);
+		}
+		Deflate_Insert(state, pos);
+
+		/* Greedy: Always use the match starting at current byte */
+		/* (i.e prefer quickly saving maps/screenshots to completely optimal filesize) */
+		if (!level->lazy) {
+			if (curLen >= MIN_MATCH_LEN) {
+				Deflate_AddMatch(state, curLen, pos - curPos);
+				pos += curLen;
+			} else {
+				Deflate_AddLit(state, input[pos]);
+				pos++;
+			}
+			continue;
+		}
+
+		/* Lazy evaluation: Only use the match starting at previous byte */
+		/* if the match starting at current byte isn't any longer */
+		if (pending && prevLen >= MIN_MATCH_LEN && prevLen >= curLen) {
+			Deflate_AddMatch(state, prevLen, prevDist);
+
+			/* Add rest of the matched bytes into the hash chains */
+			for (pos++, prevLen -= 2; prevLen > 0 && end - pos >= MIN_MATCH_LEN; prevLen--, pos++) {
+				Deflate_Insert(state, pos);
+			}
+			pos    += prevLen;
+			pending = false;
+		} else {
+			if (pending) Deflate_AddLit(state, input[pos - 1]);
+			prevLen  = curLen;
+			prevDist = pos - curPos;
+			pending  = true;
+			pos++;
+		}
+	}
+
+	if (pending && prevLen >= MIN_MATCH_LEN) {
+		Deflate_AddMatch(state, prevLen, prevDist);
+		pos += prevLen - 1;
+	} else if (pending) {
+		Deflate_AddLit(state, input[pos - 1]);
+	}
+
+	/* literals for last few bytes */
+	for (; pos < end; pos++) {
+		Deflate_AddLit(state, input[pos]);
+	}
+}
+
+
+/*########################################################################################################################*
+*-------------------------------------------------Deflate (huffman codes)-------------------------------------------------*
+*#########################################################################################################################*/
+/* Constructs a huffman encoding table (for values to codewords) */
+static void Deflate_BuildTable(const cc_uint8* lens, int count, cc_uint16* codewords, cc_uint8* bitlens) {
+	int i, j, offset, codeword;
+	struct HuffmanTable table;
+
+	/* NOTE: Can ignore since lens table is always valid */
+	(void)Huffman_Build(&table, lens, count);
+	for (i = 0; i < INFLATE_MAX_BITS; i++) {
+		if (!table.EndCodewords[i]) continue;
+		count = table.EndCodewords[i] - table.FirstCodewords[i];
+
+		for (j = 0; j < count; j++) {
+			offset   = table.Values[table.FirstOffsets[i] + j];
+			codeword = table.FirstCodewords[i] + j;
+			bitlens[offset]   = i;
+			codewords[offset] = Huffman_ReverseBits(codeword, i);
+		}
+	}
+}
+
+/* Replaces frequencies (sorted in ascending order) with optimal codeword lengths */
+/* Based off 'In-Place Calculation of Minimum-Redundancy Codes' by Moffat and Katajainen */
+static void Deflate_CalcLengths(cc_uint32* A, int n) {
+	int root, leaf, next, avail, used, depth;
+
+	/* First pass: Build tree from left to right, internal nodes store index of parent */
+	A[0] += A[1]; root = 0; leaf = 2;
+	for (next = 1; next < n - 1; next++) {
+		if (leaf >= n || A[root] < A[leaf]) {
+			A[next] = A[root]; A[root++] = next;
+		} else {
+			A[next] = A[leaf++];
+		}
+
+		if (leaf >= n || (root < next && A[root] < A[leaf])) {
+			A[next] += A[root]; A[root++] = next;
+		} else {
+			A[next] += A[leaf++];
+		}
+	}
+
+	/* Second pass: Convert parent indices into depths of internal nodes, from right to left */
+	A[n - 2] = 0;
+	for (next = n - 3; next >= 0; next--) { A[next] = A[A[next]] + 1; }
+
+	/* Third pass: Convert depths of internal nodes into depths of leaves */
+	avail = 1; used = 0; depth = 0;
+	root  = n - 2; next = n - 1;
+	while (avail > 0) {
+		while (root >= 0 && (int)A[root] == depth) { used++; root--; }
+		while (avail > used) { A[next--] = depth; avail--; }
+		avail = 2 * used; depth++; used = 0;
+	}
+}
+
+/* Computes length of each codeword, with no codeword being longer than maxBits */
+static void Deflate_BuildLens(const cc_uint32* freqs, int count, int maxBits, cc_uint8* lens) {
+	cc_uint32 keys[DEFLATE_NUM_LITS], key, total;
+	cc_uint16 values[DEFLATE_NUM_LITS], value;
+	int bl_count[DEFLATE_MAX_CODE_BITS + 1];
+	int i, j, n = 0;
+
+	for (i = 0; i < count; i++) {
+		lens[i] = 0;
+		if (!freqs[i]) continue;
+		keys[n] = freqs[i]; values[n] = i; n++;
+	}
+	/* Huffman tree must have at least two codewords */
+	for (i = 0; n < 2; i++) {
+		if (freqs[i]) continue;
+		keys[n] = 1; values[n] = i; n++;
+	}
+
+	/* Sort by ascending frequency (insertion sort is fine for so few values) */
+	for (i = 1; i < n; i++) {
+		key = keys[i]; value = values[i];
+
+		for (j = i - 1; j >= 0 && keys[j] > key; j--) {
+			keys[j + 1] = keys[j]; values[j + 1] = values[j];
+		}
+		keys[j + 1] = key; values[j + 1] = value;
+	}
+	Deflate_CalcLengths(keys, n);
+
+	/* Clamp lengths to maxBits, then lengthen shorter codewords until the code is no longer oversubscribed */
+	for (i = 0; i <= maxBits; i++) bl_count[i] = 0;
+	for (i = 0; i < n; i++) {
+		bl_count[keys[i] > (cc_uint32)maxBits ? maxBits : keys[i]]++;
+	}
+
+	total = 0;
+	for (i = 1; i <= maxBits; i++) {
+		total += (cc_uint32)bl_count[i] << (maxBits - i);
+	}
+
+	for (; total > (1UL << maxBits); total--) {
+		bl_count[maxBits]--;
+		for (i = maxBits - 1; i > 0; i--) {
+			if (!bl_count[i]) continue;
+			bl_count[i]--; bl_count[i + 1] += 2; break;
+		}
+	}
+
+	/* Least frequent values get the longest codewords */
+	for (i = maxBits, j = 0; i > 0; i--) {
+		for (n = bl_count[i]; n > 0; n--) { lens[values[j++]] = i; }
+	}
+}
+
+/* Run length encodes the codeword lengths of the lits and dists huffman codes */
+static int Deflate_EncodeLens(const cc_uint8* lens, int count, cc_uint8* codes, cc_uint8* extra) {
+	int i, n, run;
+
+	for (i = 0, n = 0; i < count; i += run, n++) {
+		for (run = 1; i + run < count && lens[i + run] == lens[i]; run++);
+
+		if (!lens[i] && run >= 3) {
+			/* 17 = repeat zero 3-10 times, 18 = repeat zero 11-138 times */
+			run = min(run, 138);
+			codes[n] = run <= 10 ? 17 : 18;
+			extra[n] = run <= 10 ? run - 3 : run - 11;
+		} else if (lens[i] && run >= 4) {
+			/* 16 = repeat previous length 3-6 times */
+			codes[n] = lens[i]; extra[n] = 0; n++;
+			run = min(run - 1, 6);
+			codes[n] = 16; extra[n] = run - 3;
+			run++;
+		} else {
+			codes[n] = lens[i]; extra[n] = 0;
+			run = 1;
+		}
+	}
+	return n;
+}
+
+static int Deflate_LenCode(int len) {
+	int j;
+	for (j = 0; len >= deflate_len[j + 1]; j++);
+	return j;
+}
+
+static int Deflate_DistCode(int dist) {
+	int j;
+	for (j = 0; dist >= deflate_dist[j + 1]; j++);
+	return j;
 }
 
+
+/*########################################################################################################################*
+*----------------------------------------------------Deflate (blocks)-----------------------------------------------------*
+*#########################################################################################################################*/
 /* Writes a literal to state->Output */
 static void Deflate_Lit(struct DeflateState* state, int lit) {
 	Deflate_PushLit(state, lit);
@@ -818,115 +1101,170 @@ static void Deflate_Lit(struct DeflateState* state, int lit) {
 
 /* Writes a length-distance pair to state->Output */
 static void Deflate_LenDist(struct DeflateState* state, int len, int dist) {
-	int j;
-	/* TODO: Do we actually need the if (len_bits[j]) ????????? does writing 0 bits matter??? */
-
-	for (j = 0; len >= deflate_len[j + 1]; j++);
+	int j = Deflate_LenCode(len);
 	Deflate_PushLit(state, j + 257);
 	if (len_bits[j]) { Deflate_PushBits(state, len - deflate_len[j], len_bits[j]); }
 	Deflate_FlushBits(state);
 
-	for (j = 0; dist >= deflate_dist[j + 1]; j++);
-	Deflate_PushHuff(state, j, 5);
+	j = Deflate_DistCode(dist);
+	Deflate_PushBits(state, state->DistsCodewords[j], state->DistsLens[j]);
+	Deflate_FlushBits(state);
 	if (dist_bits[j]) { Deflate_PushBits(state, dist - deflate_dist[j], dist_bits[j]); }
 	Deflate_FlushBits(state);
 }
 
-/* Moves "current block" to "previous block", adjusting state if needed. */
-static void Deflate_MoveBlock(struct DeflateState* state) {
-	int i;
-	Mem_Copy(state->Input, state->Input + DEFLATE_BLOCK_SIZE, DEFLATE_BLOCK_SIZE);
-	state->InputPosition = DEFLATE_BLOCK_SIZE;
+/* Writes Output buffer to destination stream, if it is nearly full */
+static cc_result Deflate_CheckOutput(struct DeflateState* state) {
+	cc_result res;
+	/* leave room for a few bytes and literals at end */
+	if (state->AvailOut >= 20) return 0;
 
-	/* adjust hash table offsets, removing offsets that are no longer in data at all */
-	for (i = 0; i < Array_Elems(state->Head); i++) {
-		state->Head[i] = state->Head[i] < DEFLATE_BLOCK_SIZE ? 0 : (state->Head[i] - DEFLATE_BLOCK_SIZE);
-	}
-	for (i = 0; i < Array_Elems(state->Prev); i++) {
-		state->Prev[i] = state->Prev[i] < DEFLATE_BLOCK_SIZE ? 0 : (state->Prev[i] - DEFLATE_BLOCK_SIZE);
-	}
+	res = Stream_Write(state->Dest, state->Output, DEFLATE_OUT_SIZE - state->AvailOut);
+	state->NextOut  = state->Output;
+	state->AvailOut = DEFLATE_OUT_SIZE;
+	return res;
 }
 
-/* Compresses current block of data */
-static cc_result Deflate_FlushBlock(struct DeflateState* state, int len) {
-	cc_uint32 hash, nextHash;
-	int bestLen, maxLen, matchLen, depth;
-	int bestPos, pos, nextPos;
-	cc_uint16 oldHead;
-	cc_uint8* input;
-	cc_uint8* cur;
+/* Writes header and huffman codes for a block using dynamic huffman codes */
+static cc_result Deflate_WriteDynamicHeader(struct DeflateState* state, const cc_uint8* lens, int numLits, int numDists,
+											const cc_uint8* codes, const cc_uint8* extra, int numCodes, 
+											const cc_uint8* codeLens, int numCodeLens, cc_bool final) {
+	static const cc_uint8 codeExtraBits[3] = { 2, 3, 7 };
+	cc_uint16 codewords[INFLATE_MAX_CODELENS];
+	cc_uint8 bitlens[INFLATE_MAX_CODELENS];
+	int i, code;
 	cc_result res;
 
-	if (!state->WroteHeader) {
-		state->WroteHeader = true;
-		Deflate_PushBits(state, 3, 3); /* final block TRUE, block type FIXED */
+	Deflate_PushBits(state, final | (2 << 1), 3); /* block type DYNAMIC */
+	Deflate_PushBits(state, numLits  - 257, 5);
+	Deflate_PushBits(state, numDists - 1,   5);
+	Deflate_FlushBits(state);
+	Deflate_PushBits(state, numCodeLens - 4, 4);
+	Deflate_FlushBits(state);
+
+	for (i = 0; i < numCodeLens; i++) {
+		Deflate_PushBits(state, codeLens[codelens_order[i]], 3);
+		Deflate_FlushBits(state);
+		if ((res = Deflate_CheckOutput(state))) return res;
 	}
 
-	/* Based off descriptions from http://www.gzip.org/algorithm.txt and
-	https://github.com/nothings/stb/blob/master/stb_image_write.h */
-	input = state->Input;
-	cur   = input + DEFLATE_BLOCK_SIZE;
+	Deflate_BuildTable(codeLens, INFLATE_MAX_CODELENS, codewords, bitlens);
+	for (i = 0; i < numCodes; i++) {
+		code = codes[i];
+		Deflate_PushBits(state, codewords[code], bitlens[code]);
+		if (code >= 16) { Deflate_PushBits(state, extra[i], codeExtraBits[code - 16]); }
+		Deflate_FlushBits(state);
+		if ((res = Deflate_CheckOutput(state))) return res;
+	}
 
-	/* Compress current block of data */
-	/* Use > instead of >=, because also try match at one byte after current */
-	while (len > MIN_MATCH_LEN) {
-		hash   = Deflate_Hash(cur);
-		maxLen = min(len, MAX_MATCH_LEN);
+	Deflate_BuildTable(lens,           numLits,  state->LitsCodewords,  state->LitsLens);
+	Deflate_BuildTable(lens + numLits, numDists, state->DistsCodewords, state->DistsLens);
+	return 0;
+}
 
-		bestLen = MIN_MATCH_LEN - 1; /* Match must be at least 3 bytes */
-		bestPos = 0;
+/* Writes the symbols of the current block, using fixed or dynamic huffman codes (whichever is smaller) */
+static cc_result Deflate_WriteBlock(struct DeflateState* state, cc_bool final) {
+	const struct DeflateLevel* level = &deflate_levels[state->Level - DEFLATE_LEVEL_FAST];
+	cc_uint32 litFreqs[DEFLATE_NUM_LITS], distFreqs[DEFLATE_NUM_DISTS], codeFreqs[INFLATE_MAX_CODELENS];
+	cc_uint8 lens[DEFLATE_NUM_LITS + DEFLATE_NUM_DISTS], codeLens[INFLATE_MAX_CODELENS];
+	cc_uint8 codes[DEFLATE_NUM_LITS + DEFLATE_NUM_DISTS], extra[DEFLATE_NUM_LITS + DEFLATE_NUM_DISTS];
+	cc_uint32 fixedBits, dynamicBits;
+	int numLits, numDists, numCodeLens, numCodes;
+	int i, dist;
+	cc_result res;
 
-		/* Find longest match starting at this byte */
-		/* Only explore up to 5 previous matches, to avoid slow performance */
-		/* (i.e prefer quickly saving maps/screenshots to completely optimal filesize) */
-		pos = state->Head[hash];
-		for (depth = 0; pos != 0 && depth < 5; depth++) {
-			matchLen = Deflate_MatchLen(&input[pos], cur, maxLen);
-			if (matchLen > bestLen) { bestLen = matchLen; bestPos = pos; }
-			pos = state->Prev[pos];
-		}
+	if (level->dynamic) {
+		Mem_Set(litFreqs,  0, sizeof(litFreqs));
+		Mem_Set(distFreqs, 0, sizeof(distFreqs));
+		Mem_Set(codeFreqs, 0, sizeof(codeFreqs));
 
-		/* Insert this entry into the hash chain */
-		pos = (int)(cur - input);
-		oldHead = state->Head[hash];
-		state->Head[hash] = pos;
-		state->Prev[pos]  = oldHead;
-
-		/* Lazy evaluation: Find longest match starting at next byte */
-		/* If that's longer than the longest match at current byte, throwaway this match */
-		if (bestPos) {
-			nextHash = Deflate_Hash(cur + 1);
-			nextPos  = state->Head[nextHash];
-			maxLen   = min(len - 1, MAX_MATCH_LEN);
-
-			for (depth = 0; nextPos != 0 && depth < 5; depth++) {
-				matchLen = Deflate_MatchLen(&input[nextPos], cur + 1, maxLen);
-				if (matchLen > bestLen) { bestPos = 0; break; }
-				nextPos = state->Prev[nextPos];
+		for (i = 0; i < state->NumSyms; i++) {
+			dist = state->SymDists[i];
+			if (!dist) {
+				litFreqs[state->SymLits[i]]++;
+			} else {
+				litFreqs[Deflate_LenCode(state->SymLits[i] + MIN_MATCH_LEN) + 257]++;
+				distFreqs[Deflate_DistCode(dist)]++;
 			}
 		}
+		litFreqs[256] = 1; /* end of block */
+
+		/* Dists lengths immediately follow lits lengths */
+		Deflate_BuildLens(litFreqs, DEFLATE_NUM_LITS, DEFLATE_MAX_CODE_BITS, lens);
+		for (numLits = DEFLATE_NUM_LITS; numLits > 257 && !lens[numLits - 1]; numLits--);
+		Deflate_BuildLens(distFreqs, DEFLATE_NUM_DISTS, DEFLATE_MAX_CODE_BITS, lens + numLits);
+		for (numDists = DEFLATE_NUM_DISTS; numDists > 1 && !lens[numLits + numDists - 1]; numDists--);
+
+		numCodes = Deflate_EncodeLens(lens, numLits + numDists, codes, extra);
+		for (i = 0; i < numCodes; i++) { codeFreqs[codes[i]]++; }
+		Deflate_BuildLens(codeFreqs, INFLATE_MAX_CODELENS, DEFLATE_MAX_CODELEN_BITS, codeLens);
+		for (numCodeLens = INFLATE_MAX_CODELENS; numCodeLens > 4 && !codeLens[codelens_order[numCodeLens - 1]]; numCodeLens--);
+
+		/* Extra bits of lengths and distances are the same for both, so can be ignored */
+		fixedBits   = 3;
+		dynamicBits = 3 + 14 + numCodeLens * 3;
+		for (i = 0; i < DEFLATE_NUM_LITS; i++) {
+			fixedBits   += litFreqs[i] * fixed_lits[i];
+			dynamicBits += litFreqs[i] * (i < numLits ? lens[i] : 0);
+		}
+		for (i = 0; i < numDists; i++) {
+			fixedBits   += distFreqs[i] * 5;
+			dynamicBits += distFreqs[i] * lens[numLits + i];
+		}
+		for (i = 0; i < numCodes; i++) {
+			dynamicBits += codeLens[codes[i]] + (codes[i] == 16 ? 2 : codes[i] == 17 ? 3 : codes[i] == 18 ? 7 : 0);
+		}
 
-		if (bestPos) {
-			Deflate_LenDist(state, bestLen, pos - bestPos);
-			len -= bestLen; cur += bestLen;
-		} else {
-			Deflate_Lit(state, *cur);
-			len--; cur++;
+		if (dynamicBits < fixedBits) {
+			res = Deflate_WriteDynamicHeader(state, lens, numLits, numDists, 
+						codes, extra, numCodes, codeLens, numCodeLens, final);
+			if (res) return res;
+			goto writeSymbols;
 		}
+	}
 
-		/* leave room for a few bytes and literals at end */
-		if (state->AvailOut >= 20) continue;
-		res = Stream_Write(state->Dest, state->Output, DEFLATE_OUT_SIZE - state->AvailOut);
-		state->NextOut  = state->Output;
-		state->AvailOut = DEFLATE_OUT_SIZE;
-		if (res) return res;
+	Deflate_PushBits(state, final | (1 << 1), 3); /* block type FIXED */
+	Deflate_BuildTable(fixed_lits,  INFLATE_MAX_LITS,  state->LitsCodewords,  state->LitsLens);
+	Deflate_BuildTable(fixed_dists, INFLATE_MAX_DISTS, state->DistsCodewords, state->DistsLens);
+
+writeSymbols:
+	for (i = 0; i < state->NumSyms; i++) {
+		dist = state->SymDists[i];
+		if (!dist) {
+			Deflate_Lit(state, state->SymLits[i]);
+		} else {
+			Deflate_LenDist(state, state->SymLits[i] + MIN_MATCH_LEN, dist);
+		}
+		if ((res = Deflate_CheckOutput(state))) return res;
 	}
 
-	/* literals for last few bytes */
-	while (len > 0) {
-		Deflate_Lit(state, *cur);
-		len--; cur++;
+	/* Write huffman encoded "literal 256" to terminate symbols */
+	Deflate_Lit(state, 256);
+	return 0;
+}
+
+/* Moves "current block" to "previous block", adjusting state if needed. */
+static void Deflate_MoveBlock(struct DeflateState* state) {
+	int i, pos;
+	Mem_Copy(state->Input, state->Input + DEFLATE_BLOCK_SIZE, DEFLATE_BLOCK_SIZE);
+	state->InputPosition = DEFLATE_BLOCK_SIZE;
+
+	/* adjust hash table offsets, removing offsets that are no longer in data at all */
+	for (i = 0; i < Array_Elems(state->Head); i++) {
+		state->Head[i] = state->Head[i] < DEFLATE_BLOCK_SIZE ? 0 : (state->Head[i] - DEFLATE_BLOCK_SIZE);
+	}
+	/* hash chain entries are indexed by position too, so must also be moved down */
+	for (i = 0; i < DEFLATE_BLOCK_SIZE; i++) {
+		pos = state->Prev[i + DEFLATE_BLOCK_SIZE];
+		state->Prev[i] = pos < DEFLATE_BLOCK_SIZE ? 0 : (pos - DEFLATE_BLOCK_SIZE);
 	}
+}
+
+/* Compresses current block of data */
+static cc_result Deflate_FlushBlock(struct DeflateState* state, int len, cc_bool final) {
+	cc_result res;
+	Deflate_Compress(state, len);
+	if ((res = Deflate_WriteBlock(state, final))) return res;
 
 	res = Stream_Write(state->Dest, state->Output, DEFLATE_OUT_SIZE - state->AvailOut);
 	state->NextOut  = state->Output;
@@ -958,7 +1296,7 @@ static cc_result Deflate_StreamWrite(struct Stream* stream, const cc_uint8* data
 		data += len;
 
 		if (state->InputPosition == DEFLATE_BUFFER_SIZE) {
-			res = Deflate_FlushBlock(state, DEFLATE_BLOCK_SIZE);
+			res = Deflate_FlushBlock(state, DEFLATE_BLOCK_SIZE, false);
 			if (res) return res;
 		}
 	}
@@ -971,13 +1309,9 @@ static cc_result Deflate_StreamClose(struct Stream* stream) {
 	cc_result res;
 
 	state = (struct DeflateState*)stream->Meta.Inflate;
-	res   = Deflate_FlushBlock(state, state->InputPosition - DEFLATE_BLOCK_SIZE);
+	res   = Deflate_FlushBlock(state, state->InputPosition - DEFLATE_BLOCK_SIZE, true);
 	if (res) return res;
 
-	/* Write huffman encoded "literal 256" to terminate symbols */
-	Deflate_PushLit(state, 256);
-	Deflate_FlushBits(state);
-
 	/* In case last byte still has a few extra bits */
 	if (state->NumBits) {
 		while (state->NumBits < 8) { Deflate_PushBits(state, 0, 1); }
@@ -987,26 +1321,6 @@ static cc_result Deflate_StreamClose(struct Stream* stream) {
 	return Stream_Write(state->Dest, state->Output, DEFLATE_OUT_SIZE - state->AvailOut);
 }
 
-/* Constructs a huffman encoding table (for values to codewords) */
-static void Deflate_BuildTable(const cc_uint8* lens, int count, cc_uint16* codewords, cc_uint8* bitlens) {
-	int i, j, offset, codeword;
-	struct HuffmanTable table;
-
-	/* NOTE: Can ignore since lens table is not user controlled */
-	(void)Huffman_Build(&table, lens, count);
-	for (i = 0; i < INFLATE_MAX_BITS; i++) {
-		if (!table.EndCodewords[i]) continue;
-		count = table.EndCodewords[i] - table.FirstCodewords[i];
-
-		for (j = 0; j < count; j++) {
-			offset   = table.Values[table.FirstOffsets[i] + j];
-			codeword = table.FirstCodewords[i] + j;
-			bitlens[offset]   = i;
-			codewords[offset] = Huffman_ReverseBits(codeword, i);
-		}
-	}
-}
-
 void Deflate_MakeStream(struct Stream* stream, struct DeflateState* state, struct Stream* underlying) {
 	Stream_Init(stream);
 	stream->Meta.Inflate = state;
@@ -1021,11 +1335,14 @@ void Deflate_MakeStream(struct Stream* stream, struct DeflateState* state, struc
 	state->NextOut  = state->Output;
 	state->AvailOut = DEFLATE_OUT_SIZE;
 	state->Dest     = underlying;
-	state->WroteHeader = false;
+	state->Level    = DEFLATE_LEVEL_DEFAULT;
 
 	Mem_Set(state->Head, 0, sizeof(state->Head));
 	Mem_Set(state->Prev, 0, sizeof(state->Prev));
-	Deflate_BuildTable(fixed_lits, INFLATE_MAX_LITS, state->LitsCodewords, state->LitsLens);
+}
+
+void Deflate_SetLevel(struct DeflateState* state, int level) {
+	state->Level = max(DEFLATE_LEVEL_FAST, min(level, DEFLATE_LEVEL_BEST));
 }
 
 
@@ -81,8 +81,14 @@ CC_API void Inflate_MakeStream2(struct Stream* stream, struct InflateState* stat
 #define DEFLATE_BLOCK_SIZE  16384
 #define DEFLATE_BUFFER_SIZE 32768
 #define DEFLATE_OUT_SIZE 8192
-#define DEFLATE_HASH_SIZE 0x1000UL
-#define DEFLATE_HASH_MASK 0x0FFFUL
+#define DEFLATE_HASH_SIZE 0x8000UL
+#define DEFLATE_HASH_MASK 0x7FFFUL
+/* Greedy matching with short hash chain walks, and fixed huffman codes. */
+#define DEFLATE_LEVEL_FAST    1
+/* Lazy matching, and dynamic huffman codes. (default) */
+#define DEFLATE_LEVEL_DEFAULT 2
+/* Lazy matching with long hash chain walks, and dynamic huffman codes. */
+#define DEFLATE_LEVEL_BEST    3
 struct DeflateState {
 	cc_uint32 Bits;         /* Holds bits across byte boundaries */
 	cc_uint32 NumBits;      /* Number of bits in Bits buffer */
@@ -91,19 +97,28 @@ struct DeflateState {
 	cc_uint8* NextOut;    /* Pointer within Output buffer to next byte that can be written */
 	cc_uint32 AvailOut;   /* Max number of bytes that can be written to Output buffer */
 	struct Stream* Dest; /* Destination that Output buffer is written to */
+	int Level;           /* DEFLATE_LEVEL_ value, see Deflate_SetLevel */
 
-	cc_uint16 LitsCodewords[INFLATE_MAX_LITS]; /* Codewords for each value */
-	cc_uint8 LitsLens[INFLATE_MAX_LITS];       /* Bit lengths of each codeword */
+	cc_uint16 LitsCodewords[INFLATE_MAX_LITS];   /* Codewords for each value */
+	cc_uint8 LitsLens[INFLATE_MAX_LITS];         /* Bit lengths of each codeword */
+	cc_uint16 DistsCodewords[INFLATE_MAX_DISTS]; /* Codewords for each distance */
+	cc_uint8 DistsLens[INFLATE_MAX_DISTS];       /* Bit lengths of each distance codeword */
 	
 	cc_uint8 Input[DEFLATE_BUFFER_SIZE];
 	cc_uint8 Output[DEFLATE_OUT_SIZE];
-	int Head[DEFLATE_HASH_SIZE];
-	int Prev[DEFLATE_BUFFER_SIZE];
-	cc_bool WroteHeader;
+	cc_uint16 Head[DEFLATE_HASH_SIZE];
+	cc_uint16 Prev[DEFLATE_BUFFER_SIZE];
+
+	int NumSyms;                            /* Number of symbols in current block */
+	cc_uint8 SymLits[DEFLATE_BLOCK_SIZE];   /* Literal, or match length - 3 */
+	cc_uint16 SymDists[DEFLATE_BLOCK_SIZE]; /* Match distance, or 0 for a literal */
 };
 /* Compresses input data using DEFLATE, then writes compressed output to another stream. Write only stream. */
 /* DEFLATE compression is pure compressed data, there is no header or footer. */
 CC_API void Deflate_MakeStream(struct Stream* stream, struct DeflateState* state, struct Stream* underlying);
+/* Sets how much effort is spent on compressing data. (DEFLATE_LEVEL_DEFAULT by default) */
+/* NOTE: Takes effect from the next block of data compressed. */
+CC_API void Deflate_SetLevel(struct DeflateState* state, int level);
 
 struct GZipState { struct DeflateState Base; cc_uint32 Crc32, Size; };
 /* Compresses input data using GZIP, then writes compressed output to another stream. Write only stream. */
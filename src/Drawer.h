@@ -7,7 +7,7 @@
 */
 struct VertexTextured;
 
-CC_VAR extern struct _DrawerData {
+struct _DrawerData {
 	/* Whether a colour tinting effect should be applied to all faces. */
 	cc_bool Tinted;
 	/* The colour to multiply colour of faces by (tinting effect). */
@@ -20,7 +20,8 @@ CC_VAR extern struct _DrawerData {
 	float X1, Y1, Z1;
 	/* Coordinate of maximum block bounding box corner in the world. */
 	float X2, Y2, Z2;
-} Drawer;
+};
+CC_VAR extern struct _DrawerData Drawer;
 
 /* Draws minimum X face of the cuboid. (i.e. at X1) */
 CC_API void Drawer_XMin(int count, PackedCol col, TextureLoc texLoc, struct VertexTextured** vertices);
@@ -34,4 +35,13 @@ CC_API void Drawer_ZMax(int count, PackedCol col, TextureLoc texLoc, struct Vert
 CC_API void Drawer_YMin(int count, PackedCol col, TextureLoc texLoc, struct VertexTextured** vertices);
 /* Draws maximum Y face of the cuboid. (i.e. at Y2) */
 CC_API void Drawer_YMax(int count, PackedCol col, TextureLoc texLoc, struct VertexTextured** vertices);
+
+/* Variants of the above functions that use the given state instead of the global Drawer state. */
+/* NOTE: Chunk mesh builder threads use these, as each thread has its own state. */
+void Drawer_XMinEx(const struct _DrawerData* d, int count, PackedCol col, TextureLoc texLoc, struct VertexTextured** vertices);
+void Drawer_XMaxEx(const struct _DrawerData* d, int count, PackedCol col, TextureLoc texLoc, struct VertexTextured** vertices);
+void Drawer_ZMinEx(const struct _DrawerData* d, int count, PackedCol col, TextureLoc texLoc, struct VertexTextured** vertices);
+void Drawer_ZMaxEx(const struct _DrawerData* d, int count, PackedCol col, TextureLoc texLoc, struct VertexTextured** vertices);
+void Drawer_YMinEx(const struct _DrawerData* d, int count, PackedCol col, TextureLoc texLoc, struct VertexTextured** vertices);
+void Drawer_YMaxEx(const struct _DrawerData* d, int count, PackedCol col, TextureLoc texLoc, struct VertexTextured** vertices);
 #endif
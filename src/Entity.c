@@ -542,8 +542,118 @@ void Entity_SetSkin(struct Entity* e, const cc_string* skin) {
 struct _EntitiesData Entities;
 static EntityID entities_closestId;
 
+/* Uniform grid of entities in the XZ plane, so nearby entities can be found without checking every entity. */
+/* Each grid cell is hashed into a bucket, which holds a linked list of entities overlapping that cell */
+#define ENTITIES_CELL_SIZE 4.0f
+#define ENTITIES_GRID_BUCKETS 256
+#define ENTITIES_GRID_LINKS 2048
+/* Entities overlapping more cells than this are just always checked instead */
+#define ENTITIES_GRID_MAX_CELLS 16
+
+static struct EntityLink { EntityID id; cc_int16 next; } grid_links[ENTITIES_GRID_LINKS];
+static cc_int16 grid_buckets[ENTITIES_GRID_BUCKETS];
+static int grid_numLinks, grid_numLarge;
+static EntityID grid_large[ENTITIES_MAX_COUNT];
+/* Range of cells that have entities in them */
+static int grid_minX, grid_minZ, grid_maxX, grid_maxZ;
+/* Whether entity positions may have changed since the grid was last built */
+static cc_bool grid_dirty = true;
+/* Used to avoid returning an entity more than once when it overlaps multiple cells */
+static cc_uint8 grid_visited[ENTITIES_MAX_COUNT];
+
+#define Grid_Bucket(x, z) ((((cc_uint32)(x) * 73856093U) ^ ((cc_uint32)(z) * 19349663U)) & (ENTITIES_GRID_BUCKETS - 1))
+
+/* Returns maximum distance from entity's position that its (possibly rotated) model bounds can reach */
+static float Grid_GetRadius(struct Entity* e) {
+	struct AABB* bb = &e->ModelAABB;
+	float x = max(Math_AbsF(bb->Min.X), Math_AbsF(bb->Max.X));
+	float y = max(Math_AbsF(bb->Min.Y), Math_AbsF(bb->Max.Y));
+	float z = max(Math_AbsF(bb->Min.Z), Math_AbsF(bb->Max.Z));
+	return Math_SqrtF(x * x + y * y + z * z);
+}
+
+static void Grid_Add(EntityID id) {
+	struct Entity* e = Entities.List[id];
+	int minX, minZ, maxX, maxZ, x, z;
+	int bucket, cells;
+	float radius;
+
+	radius = Grid_GetRadius(e);
+	minX = Math_Floor((e->Position.X - radius) / ENTITIES_CELL_SIZE);
+	minZ = Math_Floor((e->Position.Z - radius) / ENTITIES_CELL_SIZE);
+	maxX = Math_Floor((e->Position.X + radius) / ENTITIES_CELL_SIZE);
+	maxZ = Math_Floor((e->Position.Z + radius) / ENTITIES_CELL_SIZE);
+
+	cells = (maxX - minX + 1) * (maxZ - minZ + 1);
+	if (cells > ENTITIES_GRID_MAX_CELLS || grid_numLinks + cells > ENTITIES_GRID_LINKS) {
+		grid_large[grid_numLarge++] = id; return;
+	}
+
+	for (z = minZ; z <= maxZ; z++) {
+		for (x = minX; x <= maxX; x++) {
+			bucket = Grid_Bucket(x, z);
+			grid_links[grid_numLinks].id   = id;
+			grid_links[grid_numLinks].next = grid_buckets[bucket];
+			grid_buckets[bucket] = grid_numLinks++;
+		}
+	}
+
+	grid_minX = min(grid_minX, minX); grid_maxX = max(grid_maxX, maxX);
+	grid_minZ = min(grid_minZ, minZ); grid_maxZ = max(grid_maxZ, maxZ);
+}
+
+/* Rebuilds the grid if any entities may have moved since it was last built */
+static void Grid_Update(void) {
+	int i;
+	if (!grid_dirty) return;
+	grid_dirty = false;
+
+	for (i = 0; i < ENTITIES_GRID_BUCKETS; i++) { grid_buckets[i] = -1; }
+	grid_numLinks = 0; grid_numLarge = 0;
+	grid_minX = Int32_MaxValue; grid_maxX = Int32_MinValue;
+	grid_minZ = Int32_MaxValue; grid_maxZ = Int32_MinValue;
+
+	for (i = 0; i < ENTITIES_MAX_COUNT; i++) {
+		if (Entities.List[i]) Grid_Add(i);
+	}
+}
+
+/* Adds all not yet visited entities in the given bucket to the IDs list */
+static int Grid_CollectBucket(int bucket, EntityID* ids, int count) {
+	int i;
+	for (i = grid_buckets[bucket]; i >= 0; i = grid_links[i].next) {
+		if (grid_visited[grid_links[i].id]) continue;
+		grid_visited[grid_links[i].id] = true;
+		ids[count++] = grid_links[i].id;
+	}
+	return count;
+}
+
+int Entities_GetNearby(const Vec3* pos, float radius, EntityID* ids) {
+	int minX, minZ, maxX, maxZ, x, z;
+	int i, count;
+	Grid_Update();
+	Mem_Set(grid_visited, 0, sizeof(grid_visited));
+
+	for (i = 0; i < grid_numLarge; i++) { ids[i] = grid_large[i]; }
+	count = grid_numLarge;
+
+	minX = max(grid_minX, Math_Floor((pos->X - radius) / ENTITIES_CELL_SIZE));
+	minZ = max(grid_minZ, Math_Floor((pos->Z - radius) / ENTITIES_CELL_SIZE));
+	maxX = min(grid_maxX, Math_Floor((pos->X + radius) / ENTITIES_CELL_SIZE));
+	maxZ = min(grid_maxZ, Math_Floor((pos->Z + radius) / ENTITIES_CELL_SIZE));
+
+	for (z = minZ; z <= maxZ; z++) {
+		for (x = minX; x <= maxX; x++) {
+			count = Grid_CollectBucket(Grid_Bucket(x, z), ids, count);
+		}
+	}
+	return count;
+}
+
 void Entities_Tick(struct ScheduledTask* task) {
 	int i;
+	grid_dirty = true;
 	for (i = 0; i < ENTITIES_MAX_COUNT; i++) {
 		if (!Entities.List[i]) continue;
 		Entities.List[i]->VTABLE->Tick(Entities.List[i], task->interval);
@@ -559,6 +669,8 @@ void Entities_RenderModels(double delta, float t) {
 		if (!Entities.List[i]) continue;
 		Entities.List[i]->VTABLE->RenderModel(Entities.List[i], delta, t);
 	}
+	/* rendering interpolates entity positions */
+	grid_dirty = true;
 	Gfx_SetTexturing(false);
 	Gfx_SetAlphaTest(false);
 }
@@ -645,10 +757,34 @@ static void Entities_ChatFontChanged(void* obj) {
 	}
 }
 
+void Entities_Add(EntityID id, struct Entity* e) {
+	Entities.List[id] = e;
+	grid_dirty = true;
+	Event_RaiseInt(&EntityEvents.Added, id);
+}
+
 void Entities_Remove(EntityID id) {
 	Event_RaiseInt(&EntityEvents.Removed, id);
 	Entities.List[id]->VTABLE->Despawn(Entities.List[id]);
 	Entities.List[id] = NULL;
+	grid_dirty = true;
+}
+
+static void Entities_PickCandidates(Vec3 eyePos, Vec3 dir, EntityID* ids, int count, float* closestDist, EntityID* targetId) {
+	struct Entity* entity;
+	float t0, t1;
+	int i;
+
+	for (i = 0; i < count; i++) {
+		/* because we don't want to pick against local player */
+		if (ids[i] == ENTITIES_SELF_ID) continue;
+		entity = Entities.List[ids[i]];
+
+		if (Intersection_RayIntersectsRotatedBox(eyePos, dir, entity, &t0, &t1) && t0 < *closestDist) {
+			*closestDist = t0;
+			*targetId    = ids[i];
+		}
+	}
 }
 
 EntityID Entities_GetClosest(struct Entity* src) {
@@ -657,17 +793,40 @@ EntityID Entities_GetClosest(struct Entity* src) {
 	float closestDist = MATH_POS_INF;
 	EntityID targetId = ENTITIES_SELF_ID;
 
-	float t0, t1;
-	int i;
+	EntityID ids[ENTITIES_MAX_COUNT];
+	int x, z, stepX, stepZ, count;
+	float t, tMaxX, tMaxZ, tDeltaX, tDeltaZ;
 
-	for (i = 0; i < ENTITIES_SELF_ID; i++) { /* because we don't want to pick against local player */
-		struct Entity* entity = Entities.List[i];
-		if (!entity) continue;
+	Grid_Update();
+	Mem_Set(grid_visited, 0, sizeof(grid_visited));
+	Entities_PickCandidates(eyePos, dir, grid_large, grid_numLarge, &closestDist, &targetId);
 
-		if (Intersection_RayIntersectsRotatedBox(eyePos, dir, entity, &t0, &t1) && t0 < closestDist) {
-			closestDist = t0;
-			targetId = (EntityID)i;
+	/* Walk along the cells the ray passes through, in order of distance */
+	x = Math_Floor(eyePos.X / ENTITIES_CELL_SIZE); stepX = dir.X > 0.0f ? 1 : (dir.X < 0.0f ? -1 : 0);
+	z = Math_Floor(eyePos.Z / ENTITIES_CELL_SIZE); stepZ = dir.Z > 0.0f ? 1 : (dir.Z < 0.0f ? -1 : 0);
+
+	tDeltaX = stepX ? ENTITIES_CELL_SIZE / Math_AbsF(dir.X) : MATH_POS_INF;
+	tDeltaZ = stepZ ? ENTITIES_CELL_SIZE / Math_AbsF(dir.Z) : MATH_POS_INF;
+	tMaxX   = stepX ? ((x + (stepX > 0)) * ENTITIES_CELL_SIZE - eyePos.X) / dir.X : MATH_POS_INF;
+	tMaxZ   = stepZ ? ((z + (stepZ > 0)) * ENTITIES_CELL_SIZE - eyePos.Z) / dir.Z : MATH_POS_INF;
+
+	/* Entity being hit at t is always in the cell the ray is in at t, */
+	/*  so can stop once the ray enters cells further away than the closest hit */
+	for (t = 0.0f; t <= closestDist; ) {
+		/* Stop once ray has gone past all cells with entities */
+		if ((x < grid_minX && stepX <= 0) || (x > grid_maxX && stepX >= 0)) break;
+		if ((z < grid_minZ && stepZ <= 0) || (z > grid_maxZ && stepZ >= 0)) break;
+
+		count = Grid_CollectBucket(Grid_Bucket(x, z), ids, 0);
+		Entities_PickCandidates(eyePos, dir, ids, count, &closestDist, &targetId);
+
+		if (tMaxX < tMaxZ) {
+			t = tMaxX; tMaxX += tDeltaX; x += stepX;
+		} else {
+			t = tMaxZ; tMaxZ += tDeltaZ; z += stepZ;
 		}
+		/* Ray is pointing straight up or down */
+		if (t == MATH_POS_INF) break;
 	}
 	return targetId;
 }
@@ -143,10 +143,16 @@ void Entities_RenderModels(double delta, float t);
 void Entities_RenderNames(void);
 /* Renders hovered entity name tags. (these appears through blocks) */
 void Entities_RenderHoveredNames(void);
+/* Adds the given entity, raising EntityEvents.Added event. */
+void Entities_Add(EntityID id, struct Entity* e);
 /* Removes the given entity, raising EntityEvents.Removed event. */
 void Entities_Remove(EntityID id);
 /* Gets the ID of the closest entity to the given entity. */
 EntityID Entities_GetClosest(struct Entity* src);
+/* Gets the IDs of all entities that might be within the given horizontal distance of the given position. */
+/* NOTE: This is only a coarse check, so may also return entities further away than that. */
+/* NOTE: ids must have space for ENTITIES_MAX_COUNT entries. Returns number of IDs written. */
+int Entities_GetNearby(const Vec3* pos, float radius, EntityID* ids);
 /* Draws shadows under entities, depending on Entities.ShadowsMode */
 void Entities_DrawShadows(void);
 
@@ -54,6 +54,8 @@ enum ERRORS_ALL {
 	INF_ERR_BLOCKTYPE, INF_ERR_LEN_VERIFY, INF_ERR_REPEAT_BEG, INF_ERR_REPEAT_END,
 	INF_ERR_INVALID_CODE, INF_ERR_NUM_CODES,
 	/* Misc other errors */
-	ERR_DOWNLOAD_INVALID
+	ERR_DOWNLOAD_INVALID,
+	/* CCR map decoding errors */
+	CCR_ERR_IDENTIFIER, CCR_ERR_VERSION, CCR_ERR_REGION_SIZE, CCR_ERR_DIMENSIONS
 };
 #endif
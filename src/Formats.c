@@ -43,12 +43,14 @@ static cc_result Map_SkipGZipHeader(struct Stream* stream) {
 IMapImporter Map_FindImporter(const cc_string* path) {
 	static const cc_string cw  = String_FromConst(".cw"),  lvl = String_FromConst(".lvl");
 	static const cc_string fcm = String_FromConst(".fcm"), dat = String_FromConst(".dat");
+	static const cc_string ccr = String_FromConst(".ccr");
 
 	if (String_CaselessEnds(path, &cw))  return Cw_Load;
 #ifndef CC_BUILD_WEB
 	if (String_CaselessEnds(path, &lvl)) return Lvl_Load;
 	if (String_CaselessEnds(path, &fcm)) return Fcm_Load;
 	if (String_CaselessEnds(path, &dat)) return Dat_Load;
+	if (String_CaselessEnds(path, &ccr)) return Ccr_Load;
 #endif
 
 	return NULL;
@@ -293,8 +295,11 @@ struct NbtTag;
 struct NbtTag {
 	struct NbtTag* parent;
 	cc_uint8  type;
+	cc_uint8  depth;    /* number of parent tags */
 	cc_string name;
 	cc_uint32 dataSize; /* size of data for arrays */
+	cc_uint32 dataRead; /* how much of the data of large arrays has been read */
+	struct Stream* stream;
 
 	union {
 		cc_uint8  u8;
@@ -303,7 +308,6 @@ struct NbtTag {
 		cc_uint32 u32;
 		float     f32;
 		cc_uint8  small[NBT_SMALL_SIZE];
-		cc_uint8* big; /* malloc for big byte arrays */
 		struct { cc_string text; char buffer[NBT_STRING_SIZE]; } str;
 	} value;
 	char _nameBuffer[NBT_STRING_SIZE];
@@ -334,7 +338,24 @@ static cc_uint8* NbtTag_U8_Array(struct NbtTag* tag, int minSize) {
 	if (tag->type != NBT_I8S) Logger_Abort("Expected I8_Array NBT tag");
 	if (tag->dataSize < minSize) Logger_Abort("I8_Array NBT tag too small");
 
-	return NbtTag_IsSmall(tag) ? tag->value.small : tag->value.big;
+	/* Large arrays are streamed, so only read in the start of them */
+	if (!NbtTag_IsSmall(tag) && !tag->dataRead) {
+		tag->result   = Stream_Read(tag->stream, tag->value.small, NBT_SMALL_SIZE);
+		tag->dataRead = NBT_SMALL_SIZE;
+	}
+	return tag->value.small;
+}
+
+/* Reads all the data of a byte array tag into the given buffer */
+/* NOTE: Large arrays are not read by Nbt_ReadTag, so this reads them directly from the stream */
+static cc_result NbtTag_ReadArray(struct NbtTag* tag, cc_uint8* data) {
+	if (NbtTag_IsSmall(tag)) {
+		Mem_Copy(data, tag->value.small, tag->dataSize); return 0;
+	}
+	if (tag->dataRead) return NBT_ERR_UNKNOWN;
+
+	tag->dataRead = tag->dataSize;
+	return Stream_Read(tag->stream, data, tag->dataSize);
 }
 
 static cc_string NbtTag_String(struct NbtTag* tag) {
@@ -368,7 +389,10 @@ static cc_result Nbt_ReadTag(cc_uint8 typeId, cc_bool readTagName, struct Stream
 	if (typeId == NBT_END) return 0;
 	tag.type   = typeId; 
 	tag.parent = parent;
+	tag.depth  = parent ? parent->depth + 1 : 0;
 	tag.dataSize = 0;
+	tag.dataRead = 0;
+	tag.stream   = stream;
 	String_InitArray(tag.name, tag._nameBuffer);
 
 	if (readTagName) {
@@ -396,14 +420,10 @@ static cc_result Nbt_ReadTag(cc_uint8 typeId, cc_bool readTagName, struct Stream
 	case NBT_I8S:
 		if ((res = Stream_ReadU32_BE(stream, &tag.dataSize))) break;
 
+		/* Large arrays are left in the stream for the callback to read */
+		/*  (e.g. so map blocks can be decompressed straight into the map) */
 		if (NbtTag_IsSmall(&tag)) {
 			res = Stream_Read(stream, tag.value.small, tag.dataSize);
-		} else {
-			tag.value.big = (cc_uint8*)Mem_TryAlloc(tag.dataSize, 1);
-			if (!tag.value.big) return ERR_OUT_OF_MEMORY;
-
-			res = Stream_Read(stream, tag.value.big, tag.dataSize);
-			if (res) Mem_Free(tag.value.big);
 		}
 		break;
 	case NBT_STR:
@@ -438,9 +458,13 @@ static cc_result Nbt_ReadTag(cc_uint8 typeId, cc_bool readTagName, struct Stream
 	if (res) return res;
 	tag.result = 0;
 	callback(&tag);
-	/* NOTE: callback must set DataBig to NULL, if doesn't want it to be freed */
-	if (!NbtTag_IsSmall(&tag)) Mem_Free(tag.value.big);
-	return tag.result;
+	if (tag.result) return tag.result;
+
+	/* Skip over any data of large arrays that the callback didn't read */
+	if (typeId == NBT_I8S && !NbtTag_IsSmall(&tag) && tag.dataRead < tag.dataSize) {
+		return stream->Skip(stream, tag.dataSize - tag.dataRead);
+	}
+	return 0;
 }
 #define IsTag(tag, tagName) (String_CaselessEqualsConst(&tag->name, tagName))
 
@@ -487,16 +511,19 @@ COMPOUND "ClassicWorld" {
 		}
 	}
 }*/
+/* Whether block arrays are ignored, as region maps store the blocks separately */
+static cc_bool cw_skipBlocks;
+
 static BlockRaw* Cw_GetBlocks(struct NbtTag* tag) {
-	BlockRaw* ptr;
-	if (NbtTag_IsSmall(tag)) {
-		ptr = (BlockRaw*)Mem_Alloc(tag->dataSize, 1, ".cw map blocks");
-		Mem_Copy(ptr, tag->value.small, tag->dataSize);
-	} else {
-		ptr = tag->value.big;
-		tag->value.big = NULL; /* So Nbt_ReadTag doesn't call Mem_Free on World.Blocks */
-	}
-	return ptr;
+	BlockRaw* ptr = (BlockRaw*)Mem_TryAlloc(tag->dataSize, 1);
+	if (!ptr) { tag->result = ERR_OUT_OF_MEMORY; return NULL; }
+
+	/* Decompresses directly into the map's blocks array */
+	tag->result = NbtTag_ReadArray(tag, ptr);
+	if (!tag->result) return ptr;
+
+	Mem_Free(ptr);
+	return NULL;
 }
 
 static void Cw_Callback_1(struct NbtTag* tag) {
@@ -513,12 +540,16 @@ static void Cw_Callback_1(struct NbtTag* tag) {
 		return;
 	}
 
+	if (cw_skipBlocks) return;
 	if (IsTag(tag, "BlockArray")) {
 		World.Volume = tag->dataSize;
 		World.Blocks = Cw_GetBlocks(tag);
 	}
 #ifdef EXTENDED_BLOCKS
-	if (IsTag(tag, "BlockArray2")) World_SetMapUpper(Cw_GetBlocks(tag));
+	if (IsTag(tag, "BlockArray2")) {
+		BlockRaw* blocks2 = Cw_GetBlocks(tag);
+		if (blocks2) World_SetMapUpper(blocks2);
+	}
 #endif
 }
 
@@ -676,11 +707,7 @@ static void Cw_Callback_5(struct NbtTag* tag) {
 }
 
 static void Cw_Callback(struct NbtTag* tag) {
-	struct NbtTag* tmp = tag->parent;
-	int depth = 0;
-	while (tmp) { depth++; tmp = tmp->parent; }
-
-	switch (depth) {
+	switch (tag->depth) {
 	case 1: Cw_Callback_1(tag); return;
 	case 2: Cw_Callback_2(tag); return;
 	case 4: Cw_Callback_4(tag); return;
@@ -1090,7 +1117,8 @@ static cc_result Cw_WriteBockDef(struct Stream* stream, int b) {
 	return Stream_Write(stream, tmp, sizeof(cw_meta_def) + len);
 }
 
-cc_result Cw_Save(struct Stream* stream) {
+/* Writes the map as a ClassicWorld NBT tag, optionally without the blocks */
+static cc_result Cw_WriteMap(struct Stream* stream, cc_bool withBlocks) {
 	cc_uint8 tmp[768];
 	PackedCol col;
 	struct LocalPlayer* p = &LocalPlayer_Instance;
@@ -1103,7 +1131,7 @@ cc_result Cw_Save(struct Stream* stream) {
 		Stream_SetU16_BE(&tmp[63], World.Width);
 		Stream_SetU16_BE(&tmp[69], World.Height);
 		Stream_SetU16_BE(&tmp[75], World.Length);
-		Stream_SetU32_BE(&tmp[127], World.Volume);
+		Stream_SetU32_BE(&tmp[127], withBlocks ? World.Volume : 0);
 		
 		/* TODO: Maybe keep real spawn too? */
 		Stream_SetU16_BE(&tmp[89],  (cc_uint16)p->Base.Position.X);
@@ -1112,10 +1140,10 @@ cc_result Cw_Save(struct Stream* stream) {
 		tmp[107] = Math_Deg2Packed(p->SpawnYaw);
 		tmp[112] = Math_Deg2Packed(p->SpawnPitch);
 	}
-	if ((res = Stream_Write(stream, tmp,      sizeof(cw_begin)))) return res;
-	if ((res = Stream_Write(stream, World.Blocks, World.Volume))) return res;
+	if ((res = Stream_Write(stream, tmp, sizeof(cw_begin)))) return res;
 
-	if (World.Blocks != World.Blocks2) {
+	if (withBlocks && (res = Stream_Write(stream, World.Blocks, World.Volume))) return res;
+	if (withBlocks && World.Blocks != World.Blocks2) {
 		Mem_Copy(tmp, cw_map2, sizeof(cw_map2));
 		Stream_SetU32_BE(&tmp[14], World.Volume);
 
@@ -1151,6 +1179,8 @@ cc_result Cw_Save(struct Stream* stream) {
 	return Stream_Write(stream, cw_end, sizeof(cw_end));
 }
 
+cc_result Cw_Save(struct Stream* stream) { return Cw_WriteMap(stream, true); }
+
 
 /*########################################################################################################################*
 *---------------------------------------------------Schematic export------------------------------------------------------*
@@ -1200,3 +1230,425 @@ cc_result Schematic_Save(struct Stream* stream) {
 	}
 	return Stream_Write(stream, sc_end, sizeof(sc_end));
 }
+
+
+/*########################################################################################################################*
+*-----------------------------------------------ClassiCube region map format----------------------------------------------*
+*#########################################################################################################################*/
+/* Region format splits the map into 32x32x32 regions, which are each DEFLATE compressed separately.
+   This allows regions to be compressed/decompressed in parallel, and any region to be read by itself.
+	U32  "Identifier" (must be 'CCRM')
+	U8   "Version"    (only '1' supported)
+	U8   "Flags"      (1 = map has upper 8 bits of blocks)
+	U16  "Width", "Height", "Length"
+	U32* "Sizes"      (compressed size of each region)
+	U8*  "Regions"    (compressed blocks of each region)
+	U8*  "Metadata"   (compressed ClassicWorld NBT, with an empty BlockArray)
+NOTE: Regions are ordered by Y, then Z, then X. Blocks within a region are also ordered that way.
+NOTE: Regions at the edges of the map are smaller, if map dimensions aren't a multiple of 32.
+NOTE: Blocks in a region are followed by upper 8 bits of the blocks, if the map has them. */
+#define CCR_IDENTIFIER  0x4343524DUL
+#define CCR_VERSION     1
+#define CCR_FLAG_UPPER  0x01
+#define CCR_HEADER_SIZE 12
+
+#define CCR_REGION_SIZE   32
+#define CCR_REGION_VOLUME (CCR_REGION_SIZE * CCR_REGION_SIZE * CCR_REGION_SIZE)
+/* Max size of a region's data, after compressing it with DEFLATE */
+#define CCR_MAX_COMPRESSED (CCR_REGION_VOLUME * 2 + CCR_REGION_VOLUME / 2 + 1024)
+#define CCR_MAX_THREADS 32
+
+struct CcrRegion { cc_uint8* data; cc_uint32 size; };
+struct CcrState {
+	struct CcrRegion* regions;
+	BlockRaw* blocks;
+	BlockRaw* blocks2;
+	int width, height, length;
+	int regionsX, regionsZ, count, next;
+	cc_bool upper; /* Whether regions include upper 8 bits of blocks */
+	cc_result result;
+	void* mutex;
+};
+/* Loading and saving use separate state, as a save may still be running on a background thread */
+static struct CcrState ccr_load, ccr_save;
+
+static void Ccr_Init(struct CcrState* s, int width, int height, int length, cc_bool upper) {
+	int regionsY;
+	s->width  = width;
+	s->height = height;
+	s->length = length;
+	s->upper  = upper;
+
+	s->regionsX = (width  + CCR_REGION_SIZE - 1) / CCR_REGION_SIZE;
+	s->regionsZ = (length + CCR_REGION_SIZE - 1) / CCR_REGION_SIZE;
+	regionsY    = (height + CCR_REGION_SIZE - 1) / CCR_REGION_SIZE;
+	s->count    = s->regionsX * regionsY * s->regionsZ;
+}
+
+/* Copies the blocks of the given region from the blocks array(s) into data, or from data into the array(s) */
+/* Returns number of bytes of data the region has */
+static int Ccr_CopyRegion(struct CcrState* s, int i, cc_uint8* data, cc_bool toMap) {
+	int x1, y1, z1, width, height, length;
+	int y, z, index, volume;
+	cc_uint8* cur;
+
+	x1 = (i % s->regionsX) * CCR_REGION_SIZE; i /= s->regionsX;
+	z1 = (i % s->regionsZ) * CCR_REGION_SIZE; i /= s->regionsZ;
+	y1 = i * CCR_REGION_SIZE;
+
+	width  = min(s->width  - x1, CCR_REGION_SIZE);
+	height = min(s->height - y1, CCR_REGION_SIZE);
+	length = min(s->length - z1, CCR_REGION_SIZE);
+	volume = width * height * length;
+	if (!data) return s->upper ? volume * 2 : volume;
+
+	for (y = y1, cur = data; y < y1 + height; y++) {
+		for (z = z1; z < z1 + length; z++, cur += width) {
+			index = (y * s->length + z) * s->width + x1;
+			if (toMap) {
+				Mem_Copy(&s->blocks[index], cur, width);
+			} else {
+				Mem_Copy(cur, &s->blocks[index], width);
+			}
+
+			if (!s->blocks2) continue;
+			if (toMap) {
+				Mem_Copy(&s->blocks2[index], cur + volume, width);
+			} else {
+				Mem_Copy(cur + volume, &s->blocks2[index], width);
+			}
+		}
+	}
+	return s->upper ? volume * 2 : volume;
+}
+
+/* Returns index of the next region to process, or -1 if none left (or an error occurred) */
+static int Ccr_NextRegion(struct CcrState* s) {
+	int i;
+	Mutex_Lock(s->mutex);
+	{
+		i = s->next++;
+		if (i >= s->count || s->result) i = -1;
+	}
+	Mutex_Unlock(s->mutex);
+	return i;
+}
+
+static void Ccr_SetResult(struct CcrState* s, cc_result res) {
+	Mutex_Lock(s->mutex);
+	{
+		if (!s->result) s->result = res;
+	}
+	Mutex_Unlock(s->mutex);
+}
+
+/* Runs the given function on as many threads as there are processors (or regions) */
+static cc_result Ccr_RunThreads(struct CcrState* s, Thread_StartFunc func) {
+	void* threads[CCR_MAX_THREADS];
+	int i, count;
+
+	count = min(min(Thread_ProcessorsCount(), s->count) - 1, CCR_MAX_THREADS);
+	s->next   = 0;
+	s->result = 0;
+	s->mutex  = Mutex_Create();
+
+	for (i = 0; i < count; i++) {
+		threads[i] = Thread_Start(func);
+	}
+	func();
+	for (i = 0; i < count; i++) {
+		Thread_Join(threads[i]);
+	}
+	Mutex_Free(s->mutex);
+	return s->result;
+}
+
+/* NOTE: Runs on multiple threads */
+static void Ccr_DecompressRegions(void) {
+	struct CcrState* s = &ccr_load;
+	struct Stream stream, compStream;
+	struct InflateState* state;
+	cc_uint8* blocks;
+	cc_result res = 0;
+	int i, size;
+
+	state  = (struct InflateState*)Mem_TryAlloc(1, sizeof(struct InflateState));
+	blocks = (cc_uint8*)Mem_TryAlloc(CCR_REGION_VOLUME * 2, 1);
+	if (!state || !blocks) res = ERR_OUT_OF_MEMORY;
+
+	while (!res && (i = Ccr_NextRegion(s)) >= 0) {
+		Stream_ReadonlyMemory(&stream, s->regions[i].data, s->regions[i].size);
+		Inflate_MakeStream2(&compStream, state, &stream);
+
+		size = Ccr_CopyRegion(s, i, NULL, true);
+		if ((res = Stream_Read(&compStream, blocks, size))) break;
+		Ccr_CopyRegion(s, i, blocks, true);
+	}
+
+	if (res) Ccr_SetResult(s, res);
+	Mem_Free(state);
+	Mem_Free(blocks);
+}
+
+/* Reads and validates the compressed size of each region */
+static cc_result Ccr_ReadSizes(struct Stream* stream, cc_uint32* total) {
+	struct CcrState* s = &ccr_load;
+	cc_uint8* sizes;
+	cc_uint32 size;
+	cc_result res;
+	int i;
+
+	sizes = (cc_uint8*)Mem_TryAlloc(s->count, 4);
+	if (!sizes) return ERR_OUT_OF_MEMORY;
+	if ((res = Stream_Read(stream, sizes, s->count * 4))) { Mem_Free(sizes); return res; }
+
+	for (i = 0, *total = 0; i < s->count; i++) {
+		size = Stream_GetU32_BE(&sizes[i * 4]);
+		/* Compressed data is never empty, and total must not overflow */
+		if (!size || size > CCR_MAX_COMPRESSED || size > (cc_uint32)Int32_MaxValue - *total) {
+			Mem_Free(sizes); return CCR_ERR_REGION_SIZE;
+		}
+
+		s->regions[i].size = size;
+		*total += size;
+	}
+	Mem_Free(sizes);
+	return 0;
+}
+
+static cc_result Ccr_ReadRegions(struct Stream* stream, cc_uint32 total) {
+	struct CcrState* s = &ccr_load;
+	cc_uint8* data;
+	cc_result res;
+	int i;
+
+	/* Compressed data is much smaller than the map, so just read it all in at once */
+	data = (cc_uint8*)Mem_TryAlloc(total, 1);
+	if (!data) return ERR_OUT_OF_MEMORY;
+	if ((res = Stream_Read(stream, data, total))) { Mem_Free(data); return res; }
+
+	for (i = 0, total = 0; i < s->count; i++) {
+		s->regions[i].data = data + total;
+		total += s->regions[i].size;
+	}
+
+	res = Ccr_RunThreads(s, Ccr_DecompressRegions);
+	Mem_Free(data);
+	return res;
+}
+
+static cc_result Ccr_ReadMetadata(struct Stream* stream) {
+	struct CcrState* s = &ccr_load;
+	struct Stream compStream;
+	struct InflateState state;
+	cc_result res;
+	cc_uint8 tag;
+
+	Inflate_MakeStream2(&compStream, &state, stream);
+	if ((res = compStream.ReadU8(&compStream, &tag))) return res;
+
+	if (tag != NBT_DICT) return CW_ERR_ROOT_TAG;
+
+	cw_skipBlocks = true;
+	res = Nbt_ReadTag(NBT_DICT, true, &compStream, NULL, Cw_Callback);
+	cw_skipBlocks = false;
+	if (res) return res;
+
+	/* Blocks were allocated using the dimensions in the header, so metadata must not change them */
+	if (World.Width != s->width || World.Height != s->height || World.Length != s->length) {
+		return CCR_ERR_DIMENSIONS;
+	}
+	return 0;
+}
+
+static cc_result Ccr_AllocBlocks(void) {
+	struct CcrState* s = &ccr_load;
+	World.Width  = s->width;
+	World.Height = s->height;
+	World.Length = s->length;
+
+	World.Volume = World.Width * World.Height * World.Length;
+	World.Blocks = (BlockRaw*)Mem_TryAlloc(World.Volume, 1);
+	if (!World.Blocks) return ERR_OUT_OF_MEMORY;
+	s->blocks  = World.Blocks;
+	s->blocks2 = NULL;
+#ifdef EXTENDED_BLOCKS
+	if (s->upper) {
+		BlockRaw* blocks2 = (BlockRaw*)Mem_TryAlloc(World.Volume, 1);
+		if (!blocks2) return ERR_OUT_OF_MEMORY;
+		World_SetMapUpper(blocks2);
+		s->blocks2 = blocks2;
+	}
+#endif
+	return 0;
+}
+
+cc_result Ccr_Load(struct Stream* stream) {
+	struct CcrState* s = &ccr_load;
+	cc_uint8 header[CCR_HEADER_SIZE];
+	int width, height, length;
+	cc_uint32 total;
+	cc_result res;
+
+	if ((res = Stream_Read(stream, header, sizeof(header)))) return res;
+	if (Stream_GetU32_BE(&header[0]) != CCR_IDENTIFIER) return CCR_ERR_IDENTIFIER;
+	if (header[4] != CCR_VERSION) return CCR_ERR_VERSION;
+
+	width  = Stream_GetU16_BE(&header[6]);
+	height = Stream_GetU16_BE(&header[8]);
+	length = Stream_GetU16_BE(&header[10]);
+	if (!width || !height || !length) return CCR_ERR_DIMENSIONS;
+	/* Volume of the map must fit in an int */
+	if ((cc_uint64)width * height * length > Int32_MaxValue) return CCR_ERR_DIMENSIONS;
+	Ccr_Init(s, width, height, length, header[5] & CCR_FLAG_UPPER);
+
+	/* Validate all the region sizes before allocating the map */
+	s->regions = (struct CcrRegion*)Mem_TryAlloc(s->count, sizeof(struct CcrRegion));
+	if (!s->regions) return ERR_OUT_OF_MEMORY;
+
+	res = Ccr_ReadSizes(stream, &total);
+	if (!res) res = Ccr_AllocBlocks();
+	if (!res) res = Ccr_ReadRegions(stream, total);
+	Mem_Free(s->regions);
+	s->regions = NULL;
+
+	if (res) return res;
+	return Ccr_ReadMetadata(stream);
+}
+
+/* NOTE: Runs on multiple threads */
+static void Ccr_CompressRegions(void) {
+	struct CcrState* s = &ccr_save;
+	struct Stream stream, compStream;
+	struct DeflateState* state;
+	cc_uint8* blocks;
+	cc_uint8* buffer;
+	cc_result res = 0;
+	int i, size;
+
+	state  = (struct DeflateState*)Mem_TryAlloc(1, sizeof(struct DeflateState));
+	blocks = (cc_uint8*)Mem_TryAlloc(CCR_REGION_VOLUME * 2, 1);
+	buffer = (cc_uint8*)Mem_TryAlloc(CCR_MAX_COMPRESSED, 1);
+	if (!state || !blocks || !buffer) res = ERR_OUT_OF_MEMORY;
+
+	while (!res && (i = Ccr_NextRegion(s)) >= 0) {
+		Stream_WriteonlyMemory(&stream, buffer, CCR_MAX_COMPRESSED);
+		Deflate_MakeStream(&compStream, state, &stream);
+
+		size = Ccr_CopyRegion(s, i, blocks, false);
+		if ((res = Stream_Write(&compStream, blocks, size))) break;
+		if ((res = compStream.Close(&compStream)))           break;
+
+		size = CCR_MAX_COMPRESSED - stream.Meta.Mem.Left;
+		s->regions[i].data = (cc_uint8*)Mem_TryAlloc(size, 1);
+		if (!s->regions[i].data) { res = ERR_OUT_OF_MEMORY; break; }
+
+		Mem_Copy(s->regions[i].data, buffer, size);
+		s->regions[i].size = size;
+	}
+
+	if (res) Ccr_SetResult(s, res);
+	Mem_Free(state);
+	Mem_Free(blocks);
+	Mem_Free(buffer);
+}
+
+static cc_result Ccr_WriteRegions(struct Stream* stream) {
+	struct CcrState* s = &ccr_save;
+	cc_uint8 header[CCR_HEADER_SIZE];
+	cc_uint8* sizes;
+	cc_result res;
+	int i;
+
+	Stream_SetU32_BE(&header[0], CCR_IDENTIFIER);
+	header[4] = CCR_VERSION;
+	header[5] = s->upper ? CCR_FLAG_UPPER : 0;
+	Stream_SetU16_BE(&header[6],  s->width);
+	Stream_SetU16_BE(&header[8],  s->height);
+	Stream_SetU16_BE(&header[10], s->length);
+	if ((res = Stream_Write(stream, header, sizeof(header)))) return res;
+
+	sizes = (cc_uint8*)Mem_TryAlloc(s->count, 4);
+	if (!sizes) return ERR_OUT_OF_MEMORY;
+
+	for (i = 0; i < s->count; i++) {
+		Stream_SetU32_BE(&sizes[i * 4], s->regions[i].size);
+	}
+	res = Stream_Write(stream, sizes, s->count * 4);
+	Mem_Free(sizes);
+
+	for (i = 0; !res && i < s->count; i++) {
+		res = Stream_Write(stream, s->regions[i].data, s->regions[i].size);
+	}
+	return res;
+}
+
+static cc_result Ccr_WriteMetadata(struct Stream* stream) {
+	struct Stream compStream;
+	struct DeflateState* state;
+	cc_result res;
+
+	state = (struct DeflateState*)Mem_TryAlloc(1, sizeof(struct DeflateState));
+	if (!state) return ERR_OUT_OF_MEMORY;
+	Deflate_MakeStream(&compStream, state, stream);
+
+	if (!(res = Cw_WriteMap(&compStream, false))) {
+		res = compStream.Close(&compStream);
+	}
+	Mem_Free(state);
+	return res;
+}
+
+cc_result Ccr_BeginSave(struct Stream* metadata) {
+	struct CcrState* s = &ccr_save;
+	cc_result res;
+#ifdef EXTENDED_BLOCKS
+	Ccr_Init(s, World.Width, World.Height, World.Length, World.Blocks != World.Blocks2);
+#else
+	Ccr_Init(s, World.Width, World.Height, World.Length, false);
+#endif
+
+	s->blocks = (BlockRaw*)Mem_TryAlloc(World.Volume, 1);
+	if (!s->blocks) return ERR_OUT_OF_MEMORY;
+	Mem_Copy(s->blocks, World.Blocks, World.Volume);
+
+#ifdef EXTENDED_BLOCKS
+	if (s->upper) {
+		s->blocks2 = (BlockRaw*)Mem_TryAlloc(World.Volume, 1);
+		if (!s->blocks2) { Ccr_EndSave(); return ERR_OUT_OF_MEMORY; }
+		Mem_Copy(s->blocks2, World.Blocks2, World.Volume);
+	}
+#endif
+
+	if ((res = Ccr_WriteMetadata(metadata))) Ccr_EndSave();
+	return res;
+}
+
+cc_result Ccr_WriteSave(struct Stream* stream, const cc_uint8* metadata, cc_uint32 size) {
+	struct CcrState* s = &ccr_save;
+	cc_result res;
+	int i;
+
+	s->regions = (struct CcrRegion*)Mem_TryAllocCleared(s->count, sizeof(struct CcrRegion));
+	if (!s->regions) return ERR_OUT_OF_MEMORY;
+
+	res = Ccr_RunThreads(s, Ccr_CompressRegions);
+	if (!res) res = Ccr_WriteRegions(stream);
+
+	for (i = 0; i < s->count; i++) {
+		Mem_Free(s->regions[i].data);
+	}
+	Mem_Free(s->regions);
+	s->regions = NULL;
+
+	if (res) return res;
+	return Stream_Write(stream, metadata, size);
+}
+
+void Ccr_EndSave(void) {
+	struct CcrState* s = &ccr_save;
+	Mem_Free(s->blocks);
+	Mem_Free(s->blocks2);
+	s->blocks  = NULL;
+	s->blocks2 = NULL;
+}
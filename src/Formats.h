@@ -27,6 +27,9 @@ cc_result Cw_Load(struct Stream* stream);
 /* Imports a world from a .dat classic map file. */
 /* Used by Minecraft Classic/WoM client. */
 cc_result Dat_Load(struct Stream* stream);
+/* Imports a world from a .ccr ClassiCube region map file. */
+/* Regions are decompressed in parallel. */
+cc_result Ccr_Load(struct Stream* stream);
 
 /* Exports a world to a .cw ClassicWorld map file. */
 /* Compatible with ClassiCube/ClassicalSharp. */
@@ -34,4 +37,12 @@ cc_result Cw_Save(struct Stream* stream);
 /* Exports a world to a .schematic Schematic map file. */
 /* Used by MCEdit and other tools. */
 cc_result Schematic_Save(struct Stream* stream);
+/* Begins exporting a world to a .ccr ClassiCube region map file. */
+/* Copies the blocks of the world, and writes the compressed metadata (env, block definitions etc) to the given stream. */
+cc_result Ccr_BeginSave(struct Stream* metadata);
+/* Compresses the copied blocks (regions are compressed in parallel), then writes the file. */
+/* NOTE: Doesn't access the world, so can be called from a background thread. */
+cc_result Ccr_WriteSave(struct Stream* stream, const cc_uint8* metadata, cc_uint32 size);
+/* Frees the blocks copied by Ccr_BeginSave. */
+void Ccr_EndSave(void);
 #endif
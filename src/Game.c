@@ -186,6 +186,40 @@ void Game_UpdateBlock(int x, int y, int z, BlockID block) {
 	MapRenderer_OnBlockChanged(x, y, z, block);
 }
 
+void Game_UpdateBlocks(const cc_int32* indices, const BlockID* blocks, int count) {
+	IVec3 coords[LIGHTING_MAX_BATCH];
+	BlockID changed[LIGHTING_MAX_BATCH];
+	int i = 0, n, index, x, y, z;
+	BlockID old, block;
+
+	while (i < count) {
+		/* Apply all the block writes first, then update lighting for them in one go */
+		for (n = 0; i < count && n < LIGHTING_MAX_BATCH; i++) {
+			index = indices[i];
+			if (index < 0 || index >= World.Volume) continue;
+
+			/* Avoids the 3 divisions World_Unpack would do */
+			y = index / World.OneY; index -= y * World.OneY;
+			z = index / World.Width;
+			x = index - z * World.Width;
+
+			block = blocks[i];
+			old   = World_GetBlock(x, y, z);
+			if (old == block) continue;
+			World_SetBlock(x, y, z, block);
+
+			if (Weather_Heightmap) {
+				EnvRenderer_OnBlockChanged(x, y, z, old, block);
+			}
+			MapRenderer_OnBlockChanged(x, y, z, block);
+
+			coords[n].X = x; coords[n].Y = y; coords[n].Z = z;
+			changed[n]  = block; n++;
+		}
+		Lighting_OnBlocksChanged(coords, changed, n);
+	}
+}
+
 void Game_ChangeBlock(int x, int y, int z, BlockID block) {
 	BlockID old = World_GetBlock(x, y, z);
 	Game_UpdateBlock(x, y, z, block);
@@ -428,8 +462,21 @@ void Game_SetFpsLimit(int method) {
 }
 
 static void UpdateViewMatrix(void) {
+	struct Matrix leftProj, rightProj;
 	Camera.Active->GetView(&Gfx.View);
-	FrustumCulling_CalcFrustumEquations(&Gfx.Projection, &Gfx.View);
+
+	/* Cull against a frustum covering both eyes, so culling is only done once per frame */
+	Camera.Active->GetProjection(&leftProj,  EVREye_Eye_Left);
+	Camera.Active->GetProjection(&rightProj, EVREye_Eye_Right);
+	FrustumCulling_CalcStereoFrustumEquations(&leftProj, &rightProj, &Gfx.View, Camera.CurrentPos);
+}
+
+/* Per-frame work that is the same for both eyes, so is only done once before they are drawn */
+static void Game_Update3D(double delta) {
+	Camera.Active->GetPickedBlock(&Game_SelectedPos); /* TODO: only pick when necessary */
+	Lighting_Update();
+	MapRenderer_Update(delta);
+	InputHandler_Tick();
 }
 
 static void Game_Render3D(double delta, float t) {
@@ -443,11 +490,9 @@ static void Game_Render3D(double delta, float t) {
 	Entities_RenderNames();
 
 	Particles_Render(t);
-	Camera.Active->GetPickedBlock(&Game_SelectedPos); /* TODO: only pick when necessary */
 	EnvRenderer_RenderSky();
 	EnvRenderer_RenderClouds();
 
-	MapRenderer_Update(delta);
 	MapRenderer_RenderNormal(delta);
 	EnvRenderer_RenderMapSides();
 
@@ -474,7 +519,6 @@ static void Game_Render3D(double delta, float t) {
 
 	Selections_Render();
 	Entities_RenderHoveredNames();
-	InputHandler_Tick();
 	if (!Game_HideGui) HeldBlockRenderer_Render(delta);
 }
 
@@ -555,18 +599,13 @@ static void RenderScene(Hmd_Eye nEye, double delta, float t) {
 	Gfx_Clear();	
 	Gfx_SetDepthTest(true);
 
-	Camera.CurrentPos = Camera.Active->GetPosition(t);
-
-	Camera_UpdateProjection(nEye);
-	
-	UpdateViewMatrix();
+	/* NOTE: Camera_UpdateProjection is not used here, as raising ProjectionChanged */
+	/*  for every eye would make the map renderer recalculate chunk visibility twice per frame */
+	Camera.Active->GetProjection(&Gfx.Projection, nEye);
+	Gfx_LoadMatrix(MATRIX_PROJECTION, &Gfx.Projection);
 	Gfx_LoadMatrix(MATRIX_VIEW, &Gfx.View);
 
-	if (!Gui_GetBlocksWorld()) {
-		Game_Render3D(delta, t);
-	} else {
-		RayTracer_SetInvalid(&Game_SelectedPos);
-	}
+	if (!Gui_GetBlocksWorld()) Game_Render3D(delta, t);
 
 	VR_RenderControllers(nEye);
 
@@ -577,6 +616,27 @@ static void RenderScene(Hmd_Eye nEye, double delta, float t) {
 	if (Game_ScreenshotRequested) Game_TakeScreenshot();
 }
 
+/* Draws both eyes at once, halving the number of draw calls made per frame */
+static void RenderSceneStereo(double delta, float t) {
+	struct Matrix rightProj;
+	Gfx_Clear();
+	Gfx_SetDepthTest(true);
+
+	Camera.Active->GetProjection(&Gfx.Projection, EVREye_Eye_Left);
+	Camera.Active->GetProjection(&rightProj,      EVREye_Eye_Right);
+	Gfx_LoadMatrix(MATRIX_VIEW, &Gfx.View);
+	Gfx_BeginStereo(&Gfx.Projection, &rightProj);
+
+	if (!Gui_GetBlocksWorld()) Game_Render3D(delta, t);
+
+	Gfx_Begin2D(Game.Width, Game.Height);
+	Gui_RenderGui(delta);
+	Gfx_End2D();
+	Gfx_EndStereo();
+
+	if (Game_ScreenshotRequested) Game_TakeScreenshot();
+}
+
 static void Game_RenderFrame(double delta) {
 	struct ScheduledTask entTask;
 	float t;
@@ -612,10 +672,20 @@ static void Game_RenderFrame(double delta) {
 	t = (float)(entTask.accumulator / entTask.interval);
 	LocalPlayer_SetInterpPosition(t);
 
+	Camera.CurrentPos = Camera.Active->GetPosition(t);
+	UpdateViewMatrix();
 
-	VR_RenderStereoTargets(RenderScene, delta, t);
-
+	if (!Gui_GetBlocksWorld()) {
+		Game_Update3D(delta);
+	} else {
+		RayTracer_SetInvalid(&Game_SelectedPos);
+	}
 
+	if (Gfx.SinglePassStereo) {
+		VR_RenderStereoSinglePass(RenderSceneStereo, delta, t);
+	} else {
+		VR_RenderStereoTargets(RenderScene, delta, t);
+	}
 	Gfx_EndFrame();
 }
 
@@ -61,6 +61,10 @@ void Game_Reset(void);
 /* (updating state means recalculating light, redrawing chunk block is in, etc) */
 /* NOTE: This does NOT notify the server, use Game_ChangeBlock for that. */
 CC_API void Game_UpdateBlock(int x, int y, int z, BlockID block);
+/* Sets multiple blocks in the map at the given world indices, then updates state associated with them. */
+/* Unlike calling Game_UpdateBlock for each block, affected light columns are only recalculated once. */
+/* NOTE: Invalid indices are ignored. This does NOT notify the server. */
+void Game_UpdateBlocks(const cc_int32* indices, const BlockID* blocks, int count);
 /* Calls Game_UpdateBlock, then informs server connection of the block change. */
 /* In multiplayer this is sent to the server, in singleplayer just activates physics. */
 CC_API void Game_ChangeBlock(int x, int y, int z, BlockID block);
@@ -155,6 +155,53 @@ static int waterLevel, minHeight;
 static cc_int16* Heightmap;
 static RNGState rnd;
 
+/* Stages that only depend on each column's own data are split up by rows across multiple threads. */
+/* Random state is only ever used on the generating thread, so output is the same regardless of thread count */
+#define GEN_BAND_ROWS 16
+#define GEN_MAX_THREADS 32
+typedef void (*NotchyGen_BandFunc)(int zBeg, int zEnd);
+static NotchyGen_BandFunc gen_bandFunc;
+static void* gen_mutex;
+static int gen_nextZ;
+
+static void NotchyGen_BandLoop(void) {
+	int zBeg, zEnd;
+
+	for (;;) {
+		Mutex_Lock(gen_mutex);
+		{
+			zBeg = gen_nextZ;
+			gen_nextZ += GEN_BAND_ROWS;
+		}
+		Mutex_Unlock(gen_mutex);
+
+		if (zBeg >= World.Length) return;
+		zEnd = min(zBeg + GEN_BAND_ROWS, World.Length);
+
+		Gen_CurrentProgress = (float)zBeg / World.Length;
+		gen_bandFunc(zBeg, zEnd);
+	}
+}
+
+/* Calls func for all rows of the map, using all available processors */
+/* NOTE: func must only modify blocks in the columns of its rows */
+static void NotchyGen_RunBands(NotchyGen_BandFunc func) {
+	void* threads[GEN_MAX_THREADS];
+	int i, count;
+
+	gen_bandFunc = func;
+	gen_nextZ    = 0;
+	count = min(Thread_ProcessorsCount() - 1, GEN_MAX_THREADS);
+
+	for (i = 0; i < count; i++) {
+		threads[i] = Thread_Start(NotchyGen_BandLoop);
+	}
+	NotchyGen_BandLoop();
+	for (i = 0; i < count; i++) {
+		Thread_Join(threads[i]);
+	}
+}
+
 static void NotchyGen_FillOblateSpheroid(int x, int y, int z, float radius, BlockRaw block) {
 	int xBeg = Math_Floor(max(x - radius, 0));
 	int xEnd = Math_Floor(min(x + radius, World.MaxX));
@@ -217,38 +264,48 @@ static void NotchyGen_FloodFill(int index, BlockRaw block) {
 }
 
 
-static void NotchyGen_CreateHeightmap(void) {
+static struct CombinedNoise heightmap_n1, heightmap_n2;
+static struct OctaveNoise heightmap_n3;
+
+static void NotchyGen_HeightmapBand(int zBeg, int zEnd) {
 	float hLow, hHigh, height;
-	int hIndex = 0, adjHeight;
+	int hIndex = zBeg * World.Width, adjHeight;
+	int bandMinHeight = World.Height;
 	int x, z;
-	struct CombinedNoise n1, n2;
-	struct OctaveNoise n3;
-
-	CombinedNoise_Init(&n1, &rnd, 8, 8);
-	CombinedNoise_Init(&n2, &rnd, 8, 8);	
-	OctaveNoise_Init(&n3, &rnd, 6);
-
-	Gen_CurrentState = "Building heightmap";
-	for (z = 0; z < World.Length; z++) {
-		Gen_CurrentProgress = (float)z / World.Length;
 
+	for (z = zBeg; z < zEnd; z++) {
 		for (x = 0; x < World.Width; x++) {
-			hLow   = CombinedNoise_Calc(&n1, x * 1.3f, z * 1.3f) / 6 - 4;
+			hLow   = CombinedNoise_Calc(&heightmap_n1, x * 1.3f, z * 1.3f) / 6 - 4;
 			height = hLow;
 
-			if (OctaveNoise_Calc(&n3, (float)x, (float)z) <= 0) {
-				hHigh = CombinedNoise_Calc(&n2, x * 1.3f, z * 1.3f) / 5 + 6;
+			if (OctaveNoise_Calc(&heightmap_n3, (float)x, (float)z) <= 0) {
+				hHigh = CombinedNoise_Calc(&heightmap_n2, x * 1.3f, z * 1.3f) / 5 + 6;
 				height = max(hLow, hHigh);
 			}
 
 			height *= 0.5f;
 			if (height < 0) height *= 0.8f;
 
-			adjHeight = (int)(height + waterLevel);
-			minHeight = min(adjHeight, minHeight);
+			adjHeight     = (int)(height + waterLevel);
+			bandMinHeight = min(adjHeight, bandMinHeight);
 			Heightmap[hIndex++] = adjHeight;
 		}
 	}
+
+	Mutex_Lock(gen_mutex);
+	{
+		minHeight = min(bandMinHeight, minHeight);
+	}
+	Mutex_Unlock(gen_mutex);
+}
+
+static void NotchyGen_CreateHeightmap(void) {
+	CombinedNoise_Init(&heightmap_n1, &rnd, 8, 8);
+	CombinedNoise_Init(&heightmap_n2, &rnd, 8, 8);	
+	OctaveNoise_Init(&heightmap_n3, &rnd, 6);
+
+	Gen_CurrentState = "Building heightmap";
+	NotchyGen_RunBands(NotchyGen_HeightmapBand);
 }
 
 static int NotchyGen_CreateStrataFast(void) {
@@ -280,23 +337,18 @@ static int NotchyGen_CreateStrataFast(void) {
 	return max(stoneHeight, 1);
 }
 
-static void NotchyGen_CreateStrata(void) {
+static struct OctaveNoise strata_n;
+static int strata_minStoneY;
+
+static void NotchyGen_StrataBand(int zBeg, int zEnd) {
 	int dirtThickness, dirtHeight;
-	int minStoneY, stoneHeight;
-	int hIndex = 0, maxY = World.MaxY, index = 0;
+	int minStoneY = strata_minStoneY, stoneHeight;
+	int hIndex = zBeg * World.Width, maxY = World.MaxY, index = 0;
 	int x, y, z;
-	struct OctaveNoise n;
-
-	/* Try to bulk fill bottom of the map if possible */
-	minStoneY = NotchyGen_CreateStrataFast();
-	OctaveNoise_Init(&n, &rnd, 8);
-
-	Gen_CurrentState = "Creating strata";
-	for (z = 0; z < World.Length; z++) {
-		Gen_CurrentProgress = (float)z / World.Length;
 
+	for (z = zBeg; z < zEnd; z++) {
 		for (x = 0; x < World.Width; x++) {
-			dirtThickness = (int)(OctaveNoise_Calc(&n, (float)x, (float)z) / 24 - 4);
+			dirtThickness = (int)(OctaveNoise_Calc(&strata_n, (float)x, (float)z) / 24 - 4);
 			dirtHeight    = Heightmap[hIndex++];
 			stoneHeight   = dirtHeight + dirtThickness;
 
@@ -317,6 +369,15 @@ static void NotchyGen_CreateStrata(void) {
 	}
 }
 
+static void NotchyGen_CreateStrata(void) {
+	/* Try to bulk fill bottom of the map if possible */
+	strata_minStoneY = NotchyGen_CreateStrataFast();
+	OctaveNoise_Init(&strata_n, &rnd, 8);
+
+	Gen_CurrentState = "Creating strata";
+	NotchyGen_RunBands(NotchyGen_StrataBand);
+}
+
 static void NotchyGen_CarveCaves(void) {
 	int cavesCount, caveLen;
 	float caveX, caveY, caveZ;
@@ -457,19 +518,14 @@ static void NotchyGen_FloodFillLava(void) {
 	}
 }
 
-static void NotchyGen_CreateSurfaceLayer(void) {	
-	int hIndex = 0, index;
+static struct OctaveNoise surface_n1, surface_n2;
+
+static void NotchyGen_SurfaceBand(int zBeg, int zEnd) {	
+	int hIndex = zBeg * World.Width, index;
 	BlockRaw above;
 	int x, y, z;
-	struct OctaveNoise n1, n2;
-
-	OctaveNoise_Init(&n1, &rnd, 8);
-	OctaveNoise_Init(&n2, &rnd, 8);
-
-	Gen_CurrentState = "Creating surface";
-	for (z = 0; z < World.Length; z++) {
-		Gen_CurrentProgress = (float)z / World.Length;
 
+	for (z = zBeg; z < zEnd; z++) {
 		for (x = 0; x < World.Width; x++) {
 			y = Heightmap[hIndex++];
 			if (y < 0 || y >= World.Height) continue;
@@ -478,15 +534,23 @@ static void NotchyGen_CreateSurfaceLayer(void) {
 			above = y >= World.MaxY ? BLOCK_AIR : Gen_Blocks[index + World.OneY];
 
 			/* TODO: update heightmap */
-			if (above == BLOCK_WATER && (OctaveNoise_Calc(&n2, (float)x, (float)z) > 12)) {
+			if (above == BLOCK_WATER && (OctaveNoise_Calc(&surface_n2, (float)x, (float)z) > 12)) {
 				Gen_Blocks[index] = BLOCK_GRAVEL;
 			} else if (above == BLOCK_AIR) {
-				Gen_Blocks[index] = (y <= waterLevel && (OctaveNoise_Calc(&n1, (float)x, (float)z) > 8)) ? BLOCK_SAND : BLOCK_GRASS;
+				Gen_Blocks[index] = (y <= waterLevel && (OctaveNoise_Calc(&surface_n1, (float)x, (float)z) > 8)) ? BLOCK_SAND : BLOCK_GRASS;
 			}
 		}
 	}
 }
 
+static void NotchyGen_CreateSurfaceLayer(void) {
+	OctaveNoise_Init(&surface_n1, &rnd, 8);
+	OctaveNoise_Init(&surface_n2, &rnd, 8);
+
+	Gen_CurrentState = "Creating surface";
+	NotchyGen_RunBands(NotchyGen_SurfaceBand);
+}
+
 static void NotchyGen_PlantFlowers(void) {
 	int numPatches;
 	BlockRaw block;
@@ -612,6 +676,7 @@ void NotchyGen_Generate(void) {
 	Random_Seed(&rnd, Gen_Seed);
 	waterLevel = World.Height / 2;	
 	minHeight  = World.Height;
+	gen_mutex  = Mutex_Create();
 
 	NotchyGen_CreateHeightmap();
 	NotchyGen_CreateStrata();
@@ -629,6 +694,7 @@ void NotchyGen_Generate(void) {
 	NotchyGen_PlantMushrooms();
 	NotchyGen_PlantTrees();
 
+	Mutex_Free(gen_mutex);
 	Mem_Free(Heightmap);
 	Heightmap = NULL;
 	Gen_Done  = true;
@@ -25,7 +25,7 @@ struct _GfxData Gfx;
 GfxResourceID Gfx_defaultIb;
 GfxResourceID Gfx_quadVb, Gfx_texVb;
 
-static const int strideSizes[2] = { SIZEOF_VERTEX_COLOURED, SIZEOF_VERTEX_TEXTURED };
+static const int strideSizes[3] = { SIZEOF_VERTEX_COLOURED, SIZEOF_VERTEX_TEXTURED, SIZEOF_VERTEX_PACKED };
 /* Current format and size of vertices */
 static int curStride, curFormat = -1;
 /* Whether mipmaps must be created for all dimensions down to 1x1 or not */
@@ -842,9 +842,9 @@ static IDirect3DVertexBuffer9* D3D9_AllocVertexBuffer(VertexFormat fmt, int coun
 	return vbuffer;
 }
 
-static void D3D9_SetVbData(IDirect3DVertexBuffer9* buffer, void* data, int size, int lockFlags) {
+static void D3D9_SetVbData(IDirect3DVertexBuffer9* buffer, int offset, void* data, int size, int lockFlags) {
 	void* dst = NULL;
-	cc_result res = IDirect3DVertexBuffer9_Lock(buffer, 0, size, &dst, lockFlags);
+	cc_result res = IDirect3DVertexBuffer9_Lock(buffer, offset, size, &dst, lockFlags);
 	if (res) Logger_Abort2(res, "D3D9_LockVb");
 
 	Mem_Copy(dst, data, size);
@@ -909,9 +909,23 @@ void Gfx_DrawVb_IndexedTris_Range(int verticesCount, int startVertex) {
 		startVertex, 0, verticesCount, 0, verticesCount >> 1);
 }
 
+static int gfx_baseVertex;
+void Gfx_BindVb_T2fC4b(GfxResourceID vb, int startVertex) {
+	Gfx_BindVb(vb);
+	gfx_baseVertex = startVertex;
+}
+
 void Gfx_DrawIndexedTris_T2fC4b(int verticesCount, int startVertex) {
 	IDirect3DDevice9_DrawIndexedPrimitive(device, D3DPT_TRIANGLELIST,
-		startVertex, 0, verticesCount, 0, verticesCount >> 1);
+		gfx_baseVertex + startVertex, 0, verticesCount, 0, verticesCount >> 1);
+}
+
+/* Direct3D9 has no way of submitting multiple draws at once */
+void Gfx_MultiDrawIndexedTris_T2fC4b(int count, const int* verticesCounts, const int* startVertices) {
+	int i;
+	for (i = 0; i < count; i++) {
+		Gfx_DrawIndexedTris_T2fC4b(verticesCounts[i], startVertices[i]);
+	}
 }
 
 
@@ -935,12 +949,19 @@ void Gfx_UnlockDynamicVb(GfxResourceID vb) {
 void Gfx_SetDynamicVbData(GfxResourceID vb, void* vertices, int vCount) {
 	int size = vCount * curStride;
 	IDirect3DVertexBuffer9* buffer = (IDirect3DVertexBuffer9*)vb;
-	D3D9_SetVbData(buffer, vertices, size, D3DLOCK_DISCARD);
+	D3D9_SetVbData(buffer, 0, vertices, size, D3DLOCK_DISCARD);
 
 	cc_result res = IDirect3DDevice9_SetStreamSource(device, 0, buffer, 0, curStride);
 	if (res) Logger_Abort2(res, "D3D9_SetDynamicVbData - Bind");
 }
 
+void Gfx_SetDynamicVbRange(GfxResourceID vb, VertexFormat fmt, int startVertex, void* vertices, int vCount) {
+	IDirect3DVertexBuffer9* buffer = (IDirect3DVertexBuffer9*)vb;
+	int stride = strideSizes[fmt];
+	/* Can't use D3DLOCK_NOOVERWRITE, as the GPU may still be drawing what was previously in this range */
+	D3D9_SetVbData(buffer, startVertex * stride, vertices, vCount * stride, 0);
+}
+
 
 /*########################################################################################################################*
 *---------------------------------------------------------Matrices--------------------------------------------------------*
@@ -972,6 +993,15 @@ void Gfx_DisableTextureOffset(void) {
 	IDirect3DDevice9_SetTransform(device, D3DTS_TEXTURE0, (const D3DMATRIX*)&Matrix_Identity);
 }
 
+/* Fixed function pipeline can't wrap texture coordinates within atlas tiles */
+void Gfx_EnableTileRepeat(float tileSize) { }
+void Gfx_DisableTileRepeat(void) { }
+/* Fixed function pipeline can't decode packed vertices */
+void Gfx_SetPackedOrigin(float x, float y, float z) { }
+/* Fixed function pipeline can't duplicate draws to each eye */
+void Gfx_BeginStereo(const struct Matrix* leftProj, const struct Matrix* rightProj) { }
+void Gfx_EndStereo(void) { }
+
 void Gfx_CalcOrthoMatrix(float width, float height, struct Matrix* matrix) {
 	Matrix_Orthographic(matrix, 0.0f, width, 0.0f, height, ORTHO_NEAR, ORTHO_FAR);
 	matrix->row3.Z = 1.0f       / (ORTHO_NEAR - ORTHO_FAR);
@@ -1487,6 +1517,13 @@ void Gfx_SetDynamicVbData(GfxResourceID vb, void* vertices, int vCount) {
 	_glBindBuffer(_GL_ARRAY_BUFFER, (GLuint)vb);
 	_glBufferSubData(_GL_ARRAY_BUFFER, 0, size, vertices);
 }
+
+void Gfx_SetDynamicVbRange(GfxResourceID vb, VertexFormat fmt, int startVertex, void* vertices, int vCount) {
+	cc_uint32 offset = startVertex * strideSizes[fmt];
+	cc_uint32 size   = vCount      * strideSizes[fmt];
+	_glBindBuffer(_GL_ARRAY_BUFFER, (GLuint)vb);
+	_glBufferSubData(_GL_ARRAY_BUFFER, offset, size, vertices);
+}
 #else
 GfxResourceID Gfx_CreateDynamicVb(VertexFormat fmt, int maxVertices) { 
 	return (GfxResourceID)Mem_Alloc(maxVertices, strideSizes[fmt], "creating dynamic vb");
@@ -1607,27 +1644,35 @@ void Gfx_OnWindowResize(void) {
 #define FTR_LINEAR_FOG (1 << 3)
 #define FTR_DENSIT_FOG (1 << 4)
 #define FTR_HASANY_FOG (FTR_LINEAR_FOG | FTR_DENSIT_FOG)
-#define FTR_FS_MEDIUMP (1 << 7)
+#define FTR_TILE_REPEAT (1 << 5)
+#define FTR_PACKED_VERTS (1 << 6)
+#define FTR_STEREO     (1 << 7)
+#define FTR_FS_MEDIUMP (1 << 8)
 
 #define UNI_MVP_MATRIX (1 << 0)
 #define UNI_TEX_OFFSET (1 << 1)
 #define UNI_FOG_COL    (1 << 2)
 #define UNI_FOG_END    (1 << 3)
 #define UNI_FOG_DENS   (1 << 4)
-#define UNI_MASK_ALL   0x1F
+#define UNI_TILE_SIZE  (1 << 5)
+#define UNI_ORIGIN     (1 << 6)
+#define UNI_MVP_RIGHT  (1 << 7)
+#define UNI_MASK_ALL   0xFF
 
 /* cached uniforms (cached for multiple programs */
 static struct Matrix _view, _proj, _mvp;
-static cc_bool gfx_alphaTest, gfx_texTransform;
-static float _texX, _texY;
+static struct Matrix _projRight, _mvpRight;
+static cc_bool gfx_alphaTest, gfx_texTransform, gfx_tileRepeat, gfx_stereo;
+static float _texX, _texY, _tileSize;
+static float _originX, _originY, _originZ;
 
 /* shader programs (emulate fixed function) */
 static struct GLShader {
 	int features;     /* what features are enabled for this shader */
 	int uniforms;     /* which associated uniforms need to be resent to GPU */
 	GLuint program;   /* OpenGL program ID (0 if not yet compiled) */
-	int locations[5]; /* location of uniforms (not constant) */
-} shaders[6 * 3] = {
+	int locations[8]; /* location of uniforms (not constant) */
+} shaders[10 * 3 * 2] = {
 	/* no fog */
 	{ 0              },
 	{ 0              | FTR_ALPHA_TEST },
@@ -1635,6 +1680,10 @@ static struct GLShader {
 	{ FTR_TEXTURE_UV | FTR_ALPHA_TEST },
 	{ FTR_TEXTURE_UV | FTR_TEX_OFFSET },
 	{ FTR_TEXTURE_UV | FTR_TEX_OFFSET | FTR_ALPHA_TEST },
+	{ FTR_TEXTURE_UV | FTR_TILE_REPEAT },
+	{ FTR_TEXTURE_UV | FTR_TILE_REPEAT | FTR_ALPHA_TEST },
+	{ FTR_TEXTURE_UV | FTR_PACKED_VERTS },
+	{ FTR_TEXTURE_UV | FTR_PACKED_VERTS | FTR_ALPHA_TEST },
 	/* linear fog */
 	{ FTR_LINEAR_FOG | 0              },
 	{ FTR_LINEAR_FOG | 0              | FTR_ALPHA_TEST },
@@ -1642,6 +1691,10 @@ static struct GLShader {
 	{ FTR_LINEAR_FOG | FTR_TEXTURE_UV | FTR_ALPHA_TEST },
 	{ FTR_LINEAR_FOG | FTR_TEXTURE_UV | FTR_TEX_OFFSET },
 	{ FTR_LINEAR_FOG | FTR_TEXTURE_UV | FTR_TEX_OFFSET | FTR_ALPHA_TEST },
+	{ FTR_LINEAR_FOG | FTR_TEXTURE_UV | FTR_TILE_REPEAT },
+	{ FTR_LINEAR_FOG | FTR_TEXTURE_UV | FTR_TILE_REPEAT | FTR_ALPHA_TEST },
+	{ FTR_LINEAR_FOG | FTR_TEXTURE_UV | FTR_PACKED_VERTS },
+	{ FTR_LINEAR_FOG | FTR_TEXTURE_UV | FTR_PACKED_VERTS | FTR_ALPHA_TEST },
 	/* density fog */
 	{ FTR_DENSIT_FOG | 0              },
 	{ FTR_DENSIT_FOG | 0              | FTR_ALPHA_TEST },
@@ -1649,6 +1702,11 @@ static struct GLShader {
 	{ FTR_DENSIT_FOG | FTR_TEXTURE_UV | FTR_ALPHA_TEST },
 	{ FTR_DENSIT_FOG | FTR_TEXTURE_UV | FTR_TEX_OFFSET },
 	{ FTR_DENSIT_FOG | FTR_TEXTURE_UV | FTR_TEX_OFFSET | FTR_ALPHA_TEST },
+	{ FTR_DENSIT_FOG | FTR_TEXTURE_UV | FTR_TILE_REPEAT },
+	{ FTR_DENSIT_FOG | FTR_TEXTURE_UV | FTR_TILE_REPEAT | FTR_ALPHA_TEST },
+	{ FTR_DENSIT_FOG | FTR_TEXTURE_UV | FTR_PACKED_VERTS },
+	{ FTR_DENSIT_FOG | FTR_TEXTURE_UV | FTR_PACKED_VERTS | FTR_ALPHA_TEST },
+	/* single pass stereo variants of all the above are filled in by GL_CheckSupport */
 };
 static struct GLShader* gfx_activeShader;
 
@@ -1656,19 +1714,37 @@ static struct GLShader* gfx_activeShader;
 static void GenVertexShader(const struct GLShader* shader, cc_string* dst) {
 	int uv = shader->features & FTR_TEXTURE_UV;
 	int tm = shader->features & FTR_TEX_OFFSET;
+	int pk = shader->features & FTR_PACKED_VERTS;
+	int st = shader->features & FTR_STEREO;
 
-	String_AppendConst(dst,         "attribute vec3 in_pos;\n");
+	if (pk) String_AppendConst(dst, "attribute vec4 in_pos;\n");
+	else    String_AppendConst(dst, "attribute vec3 in_pos;\n");
 	String_AppendConst(dst,         "attribute vec4 in_col;\n");
 	if (uv) String_AppendConst(dst, "attribute vec2 in_uv;\n");
 	String_AppendConst(dst,         "varying vec4 out_col;\n");
 	if (uv) String_AppendConst(dst, "varying vec2 out_uv;\n");
+	if (pk) String_AppendConst(dst, "varying float out_row;\n");
 	String_AppendConst(dst,         "uniform mat4 mvp;\n");
 	if (tm) String_AppendConst(dst, "uniform vec2 texOffset;\n");
+	if (pk) String_AppendConst(dst, "uniform vec3 origin;\n");
+	if (st) String_AppendConst(dst, "attribute float in_eye;\n");
+	if (st) String_AppendConst(dst, "uniform mat4 mvpRight;\n");
+	if (st) String_AppendConst(dst, "varying vec2 out_clip;\n");
 
 	String_AppendConst(dst,         "void main() {\n");
-	String_AppendConst(dst,         "  gl_Position = mvp * vec4(in_pos, 1.0);\n");
+	/* Decode position and 1D atlas row of packed vertices (see struct VertexPacked) */
+	if (pk) String_AppendConst(dst, "  vec4 pos = vec4(in_pos.xyz / 1024.0 + origin, 1.0);\n");
+	else    String_AppendConst(dst, "  vec4 pos = vec4(in_pos, 1.0);\n");
+	/* Squash each eye's clip space X into its half of the viewport (see Gfx_BeginStereo) */
+	if (st) String_AppendConst(dst, "  pos = in_eye < 0.5 ? mvp * pos : mvpRight * pos;\n");
+	if (st) String_AppendConst(dst, "  out_clip = pos.xw;\n");
+	if (st) String_AppendConst(dst, "  pos.x = pos.x * 0.5 + (in_eye - 0.5) * pos.w;\n");
+	if (st) String_AppendConst(dst, "  gl_Position = pos;\n");
+	else    String_AppendConst(dst, "  gl_Position = mvp * pos;\n");
 	String_AppendConst(dst,         "  out_col = in_col;\n");
-	if (uv) String_AppendConst(dst, "  out_uv  = in_uv;\n");
+	if (pk) String_AppendConst(dst, "  out_uv  = in_uv / 2048.0;\n");
+	else if (uv) String_AppendConst(dst, "  out_uv  = in_uv;\n");
+	if (pk) String_AppendConst(dst, "  out_row = in_pos.w;\n");
 	if (tm) String_AppendConst(dst, "  out_uv  = out_uv + texOffset;\n");
 	String_AppendConst(dst,         "}");
 }
@@ -1680,6 +1756,9 @@ static void GenFragmentShader(const struct GLShader* shader, cc_string* dst) {
 	int fl = shader->features & FTR_LINEAR_FOG;
 	int fd = shader->features & FTR_DENSIT_FOG;
 	int fm = shader->features & FTR_HASANY_FOG;
+	int tr = shader->features & FTR_TILE_REPEAT;
+	int pk = shader->features & FTR_PACKED_VERTS;
+	int st = shader->features & FTR_STEREO;
 
 #ifdef CC_BUILD_GLES
 	int mp = shader->features & FTR_FS_MEDIUMP;
@@ -1689,13 +1768,24 @@ static void GenFragmentShader(const struct GLShader* shader, cc_string* dst) {
 
 	String_AppendConst(dst,         "varying vec4 out_col;\n");
 	if (uv) String_AppendConst(dst, "varying vec2 out_uv;\n");
+	if (pk) String_AppendConst(dst, "varying float out_row;\n");
 	if (uv) String_AppendConst(dst, "uniform sampler2D texImage;\n");
 	if (fm) String_AppendConst(dst, "uniform vec3 fogCol;\n");
 	if (fl) String_AppendConst(dst, "uniform float fogEnd;\n");
 	if (fd) String_AppendConst(dst, "uniform float fogDensity;\n");
+	if (tr || pk) String_AppendConst(dst, "uniform float tileSize;\n");
+	if (st) String_AppendConst(dst, "varying vec2 out_clip;\n");
 
 	String_AppendConst(dst,         "void main() {\n");
-	if (uv) String_AppendConst(dst, "  vec4 col = texture2D(texImage, out_uv) * out_col;\n");
+	/* Clip triangles that cross over into the other eye's half of the viewport */
+	if (st) String_AppendConst(dst, "  if (abs(out_clip.x) > out_clip.y) discard;\n");
+	/* Decode U = u + (row + 1) * 32 and wrap v within the row's tile (see Gfx_EnableTileRepeat) */
+	if (tr) String_AppendConst(dst, "  vec2 uv = out_uv;\n");
+	if (tr) String_AppendConst(dst, "  if (uv.x >= 24.0) uv.y = (floor(uv.x / 32.0 + 0.125) - 1.0 + fract(uv.y)) * tileSize;\n");
+	/* Wrap v within the 1D atlas row of packed vertices (see Gfx_SetPackedOrigin) */
+	if (pk) String_AppendConst(dst, "  vec2 uv = vec2(out_uv.x, (out_row + fract(out_uv.y)) * tileSize);\n");
+	if (tr || pk) String_AppendConst(dst, "  vec4 col = texture2D(texImage, uv) * out_col;\n");
+	else if (uv) String_AppendConst(dst, "  vec4 col = texture2D(texImage, out_uv) * out_col;\n");
 	else    String_AppendConst(dst, "  vec4 col = out_col;\n");
 	if (al) String_AppendConst(dst, "  if (col.a < 0.5) discard;\n");
 	if (fm) String_AppendConst(dst, "  float depth = gl_FragCoord.z / gl_FragCoord.w;\n");
@@ -1777,6 +1867,7 @@ static void CompileProgram(struct GLShader* shader) {
 	glBindAttribLocation(program, 0, "in_pos");
 	glBindAttribLocation(program, 1, "in_col");
 	glBindAttribLocation(program, 2, "in_uv");
+	glBindAttribLocation(program, 3, "in_eye");
 
 	glLinkProgram(program);
 	glGetProgramiv(program, _GL_LINK_STATUS, &temp);
@@ -1793,6 +1884,9 @@ static void CompileProgram(struct GLShader* shader) {
 		shader->locations[2] = glGetUniformLocation(program, "fogCol");
 		shader->locations[3] = glGetUniformLocation(program, "fogEnd");
 		shader->locations[4] = glGetUniformLocation(program, "fogDensity");
+		shader->locations[5] = glGetUniformLocation(program, "tileSize");
+		shader->locations[6] = glGetUniformLocation(program, "origin");
+		shader->locations[7] = glGetUniformLocation(program, "mvpRight");
 		return;
 	}
 	temp = 0;
@@ -1842,6 +1936,18 @@ static void ReloadUniforms(void) {
 		glUniform1f(s->locations[4], -gfx_fogDensity);
 		s->uniforms &= ~UNI_FOG_DENS;
 	}
+	if ((s->uniforms & UNI_TILE_SIZE) && (s->features & (FTR_TILE_REPEAT | FTR_PACKED_VERTS))) {
+		glUniform1f(s->locations[5], _tileSize);
+		s->uniforms &= ~UNI_TILE_SIZE;
+	}
+	if ((s->uniforms & UNI_ORIGIN) && (s->features & FTR_PACKED_VERTS)) {
+		glUniform3f(s->locations[6], _originX, _originY, _originZ);
+		s->uniforms &= ~UNI_ORIGIN;
+	}
+	if ((s->uniforms & UNI_MVP_RIGHT) && (s->features & FTR_STEREO)) {
+		glUniformMatrix4fv(s->locations[7], 1, false, (float*)&_mvpRight);
+		s->uniforms &= ~UNI_MVP_RIGHT;
+	}
 }
 
 /* Switches program to one that duplicates current fixed function state */
@@ -1851,13 +1957,22 @@ static void SwitchProgram(void) {
 	int index = 0;
 
 	if (gfx_fogEnabled) {
-		index += 6;                       /* linear fog */
-		if (gfx_fogMode >= 1) index += 6; /* exp fog */
+		index += 10;                       /* linear fog */
+		if (gfx_fogMode >= 1) index += 10; /* exp fog */
 	}
 
-	if (curFormat == VERTEX_FORMAT_TEXTURED) index += 2;
-	if (gfx_texTransform) index += 2;
+	if (curFormat == VERTEX_FORMAT_PACKED) {
+		index += 8;
+	} else {
+		if (curFormat == VERTEX_FORMAT_TEXTURED) index += 2;
+		if (gfx_texTransform) {
+			index += 2;
+		} else if (gfx_tileRepeat && curFormat == VERTEX_FORMAT_TEXTURED) {
+			index += 4;
+		}
+	}
 	if (gfx_alphaTest)    index += 1;
+	if (gfx_stereo)       index += 10 * 3;
 
 	shader = &shaders[index];
 	if (shader == gfx_activeShader) { ReloadUniforms(); return; }
@@ -1902,9 +2017,12 @@ void Gfx_SetAlphaTest(cc_bool enabled) { gfx_alphaTest = enabled; SwitchProgram(
 void Gfx_LoadMatrix(MatrixType type, const struct Matrix* matrix) {
 	if (type == MATRIX_VIEW)       _view = *matrix;
 	if (type == MATRIX_PROJECTION) _proj = *matrix;
+	/* Projections loaded while in stereo mode are used by both eyes (e.g. Gfx_Begin2D) */
+	if (type == MATRIX_PROJECTION) _projRight = *matrix;
 
 	Matrix_Mul(&_mvp, &_view, &_proj);
-	DirtyUniform(UNI_MVP_MATRIX);
+	Matrix_Mul(&_mvpRight, &_view, &_projRight);
+	DirtyUniform(UNI_MVP_MATRIX | UNI_MVP_RIGHT);
 	ReloadUniforms();
 }
 void Gfx_LoadIdentityMatrix(MatrixType type) {
@@ -1923,16 +2041,105 @@ void Gfx_DisableTextureOffset(void) {
 	SwitchProgram();
 }
 
+void Gfx_EnableTileRepeat(float tileSize) {
+	_tileSize = tileSize;
+	gfx_tileRepeat = true;
+	DirtyUniform(UNI_TILE_SIZE);
+	SwitchProgram();
+}
+
+void Gfx_DisableTileRepeat(void) {
+	gfx_tileRepeat = false;
+	SwitchProgram();
+}
+
+void Gfx_SetPackedOrigin(float x, float y, float z) {
+	if (x == _originX && y == _originY && z == _originZ) return;
+	_originX = x; _originY = y; _originZ = z;
+	DirtyUniform(UNI_ORIGIN);
+	ReloadUniforms();
+}
+
+#ifndef APIENTRY
+#define APIENTRY
+#endif
+static void (APIENTRY *_glDrawArraysInstanced)(GLenum mode, GLint first, GLsizei count, GLsizei instances);
+static void (APIENTRY *_glDrawElementsInstanced)(GLenum mode, GLsizei count, GLenum type, const GLvoid* indices, GLsizei instances);
+static void (APIENTRY *_glVertexAttribDivisor)(GLuint index, GLuint divisor);
+/* Per instance eye index (0 = left, 1 = right) for single pass stereo */
+static GLuint gfx_eyeVb;
+
+void Gfx_BeginStereo(const struct Matrix* leftProj, const struct Matrix* rightProj) {
+	if (!Gfx.SinglePassStereo) return;
+	gfx_stereo = true;
+	_proj      = *leftProj;
+	_projRight = *rightProj;
+
+	_glBindBuffer(GL_ARRAY_BUFFER, gfx_eyeVb);
+	glVertexAttribPointer(3, 1, GL_FLOAT, false, sizeof(float), (void*)0);
+	_glVertexAttribDivisor(3, 1);
+	glEnableVertexAttribArray(3);
+
+	Matrix_Mul(&_mvp,      &_view, &_proj);
+	Matrix_Mul(&_mvpRight, &_view, &_projRight);
+	DirtyUniform(UNI_MVP_MATRIX | UNI_MVP_RIGHT);
+	SwitchProgram();
+}
+
+void Gfx_EndStereo(void) {
+	if (!gfx_stereo) return;
+	gfx_stereo = false;
+
+	glDisableVertexAttribArray(3);
+	_glVertexAttribDivisor(3, 0);
+	SwitchProgram();
+}
+
+static void GL_CreateEyeVb(void) {
+	static const float eyes[2] = { 0.0f, 1.0f };
+	if (!Gfx.SinglePassStereo) return;
+
+	_glGenBuffers(1, &gfx_eyeVb);
+	_glBindBuffer(GL_ARRAY_BUFFER, gfx_eyeVb);
+	_glBufferData(GL_ARRAY_BUFFER, sizeof(eyes), eyes, GL_STATIC_DRAW);
+}
+
 static void GL_CheckSupport(void) {
+	static const struct DynamicLibSym coreInstFuncs[3] = {
+		DynamicLib_Sym2("glDrawArraysInstanced",   glDrawArraysInstanced),
+		DynamicLib_Sym2("glDrawElementsInstanced", glDrawElementsInstanced),
+		DynamicLib_Sym2("glVertexAttribDivisor",   glVertexAttribDivisor)
+	};
+	static const struct DynamicLibSym extInstFuncs[3] = {
+		DynamicLib_Sym2("glDrawArraysInstancedEXT",   glDrawArraysInstanced),
+		DynamicLib_Sym2("glDrawElementsInstancedEXT", glDrawElementsInstanced),
+		DynamicLib_Sym2("glVertexAttribDivisorEXT",   glVertexAttribDivisor)
+	};
+	int i;
 #ifndef CC_BUILD_GLES
 	customMipmapsLevels = true;
 #endif
+	Gfx.TileRepeat     = true;
+	Gfx.PackedVertices = true;
+
+	/* Instancing is core in OpenGL 3.3 and OpenGL ES 3.0, otherwise needs EXT_instanced_arrays */
+	GLContext_GetAll(coreInstFuncs, Array_Elems(coreInstFuncs));
+	if (!_glDrawElementsInstanced || !_glVertexAttribDivisor) {
+		GLContext_GetAll(extInstFuncs, Array_Elems(extInstFuncs));
+	}
+	Gfx.SinglePassStereo = _glDrawArraysInstanced && _glDrawElementsInstanced && _glVertexAttribDivisor;
+
+	for (i = 0; i < 10 * 3; i++) {
+		shaders[i + 10 * 3].features = shaders[i].features | FTR_STEREO;
+	}
 }
 
 static void Gfx_FreeState(void) {
 	int i;
 	FreeDefaultResources();
 	gfx_activeShader = NULL;
+	gfx_stereo       = false;
+	if (gfx_eyeVb) { _glDeleteBuffers(1, &gfx_eyeVb); gfx_eyeVb = 0; }
 
 	for (i = 0; i < Array_Elems(shaders); i++) {
 		glDeleteProgram(shaders[i].program);
@@ -1942,6 +2149,7 @@ static void Gfx_FreeState(void) {
 
 static void Gfx_RestoreState(void) {
 	InitDefaultResources();
+	GL_CreateEyeVb();
 	glEnableVertexAttribArray(0);
 	glEnableVertexAttribArray(1);
 	curFormat = -1;
@@ -1964,6 +2172,12 @@ static void GL_SetupVbTextured(void) {
 	glVertexAttribPointer(2, 2, GL_FLOAT,         false, SIZEOF_VERTEX_TEXTURED, (void*)16);
 }
 
+static void GL_SetupVbPacked(void) {
+	glVertexAttribPointer(0, 4, GL_SHORT,          false, SIZEOF_VERTEX_PACKED, (void*)0);
+	glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE,  true,  SIZEOF_VERTEX_PACKED, (void*)8);
+	glVertexAttribPointer(2, 2, GL_UNSIGNED_SHORT, false, SIZEOF_VERTEX_PACKED, (void*)12);
+}
+
 static void GL_SetupVbColoured_Range(int startVertex) {
 	cc_uint32 offset = startVertex * SIZEOF_VERTEX_COLOURED;
 	glVertexAttribPointer(0, 3, GL_FLOAT,         false, SIZEOF_VERTEX_COLOURED, (void*)(offset));
@@ -1977,6 +2191,13 @@ static void GL_SetupVbTextured_Range(int startVertex) {
 	glVertexAttribPointer(2, 2, GL_FLOAT,         false, SIZEOF_VERTEX_TEXTURED, (void*)(offset + 16));
 }
 
+static void GL_SetupVbPacked_Range(int startVertex) {
+	cc_uint32 offset = startVertex * SIZEOF_VERTEX_PACKED;
+	glVertexAttribPointer(0, 4, GL_SHORT,          false, SIZEOF_VERTEX_PACKED, (void*)(offset));
+	glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE,  true,  SIZEOF_VERTEX_PACKED, (void*)(offset + 8));
+	glVertexAttribPointer(2, 2, GL_UNSIGNED_SHORT, false, SIZEOF_VERTEX_PACKED, (void*)(offset + 12));
+}
+
 void Gfx_SetVertexFormat(VertexFormat fmt) {
 	if (fmt == curFormat) return;
 	curFormat = fmt;
@@ -1986,6 +2207,10 @@ void Gfx_SetVertexFormat(VertexFormat fmt) {
 		glEnableVertexAttribArray(2);
 		gfx_setupVBFunc      = GL_SetupVbTextured;
 		gfx_setupVBRangeFunc = GL_SetupVbTextured_Range;
+	} else if (fmt == VERTEX_FORMAT_PACKED) {
+		glEnableVertexAttribArray(2);
+		gfx_setupVBFunc      = GL_SetupVbPacked;
+		gfx_setupVBRangeFunc = GL_SetupVbPacked_Range;
 	} else {
 		glDisableVertexAttribArray(2);
 		gfx_setupVBFunc      = GL_SetupVbColoured;
@@ -1994,34 +2219,58 @@ void Gfx_SetVertexFormat(VertexFormat fmt) {
 	SwitchProgram();
 }
 
+/* In single pass stereo mode, every draw is drawn once for each eye */
+static void GL_DrawTris(int verticesCount, void* offset) {
+	if (gfx_stereo) {
+		_glDrawElementsInstanced(GL_TRIANGLES, ICOUNT(verticesCount), GL_UNSIGNED_SHORT, offset, 2);
+	} else {
+		glDrawElements(GL_TRIANGLES, ICOUNT(verticesCount), GL_UNSIGNED_SHORT, offset);
+	}
+}
+
 void Gfx_DrawVb_Lines(int verticesCount) {
 	gfx_setupVBFunc();
-	glDrawArrays(GL_LINES, 0, verticesCount);
+	if (gfx_stereo) {
+		_glDrawArraysInstanced(GL_LINES, 0, verticesCount, 2);
+	} else {
+		glDrawArrays(GL_LINES, 0, verticesCount);
+	}
 }
 
 void Gfx_DrawVb_IndexedTris_Range(int verticesCount, int startVertex) {
 	gfx_setupVBRangeFunc(startVertex);
-	glDrawElements(GL_TRIANGLES, ICOUNT(verticesCount), GL_UNSIGNED_SHORT, NULL);
+	GL_DrawTris(verticesCount, NULL);
 }
 
 void Gfx_DrawVb_IndexedTris(int verticesCount) {
 	gfx_setupVBFunc();
-	glDrawElements(GL_TRIANGLES, ICOUNT(verticesCount), GL_UNSIGNED_SHORT, NULL);
+	GL_DrawTris(verticesCount, NULL);
 }
 
-void Gfx_BindVb_T2fC4b(GfxResourceID vb) {
+/* NOTE: Map renderer uses either VERTEX_FORMAT_TEXTURED or VERTEX_FORMAT_PACKED */
+static int gfx_baseVertex;
+void Gfx_BindVb_T2fC4b(GfxResourceID vb, int startVertex) {
 	Gfx_BindVb(vb);
-	GL_SetupVbTextured();
+	gfx_baseVertex = startVertex;
+	gfx_setupVBRangeFunc(startVertex);
 }
 
 void Gfx_DrawIndexedTris_T2fC4b(int verticesCount, int startVertex) {
 	if (startVertex + verticesCount > GFX_MAX_VERTICES) {
-		GL_SetupVbTextured_Range(startVertex);
-		glDrawElements(GL_TRIANGLES, ICOUNT(verticesCount), GL_UNSIGNED_SHORT, NULL);
-		GL_SetupVbTextured();
+		gfx_setupVBRangeFunc(gfx_baseVertex + startVertex);
+		GL_DrawTris(verticesCount, NULL);
+		gfx_setupVBRangeFunc(gfx_baseVertex);
 	} else {
 		/* ICOUNT(startVertex) * 2 = startVertex * 3  */
-		glDrawElements(GL_TRIANGLES, ICOUNT(verticesCount), GL_UNSIGNED_SHORT, (void*)(startVertex * 3));
+		GL_DrawTris(verticesCount, (void*)(startVertex * 3));
+	}
+}
+
+/* OpenGL ES 2.0 and WebGL have no way of submitting multiple draws with different base vertices */
+void Gfx_MultiDrawIndexedTris_T2fC4b(int count, const int* verticesCounts, const int* startVertices) {
+	int i;
+	for (i = 0; i < count; i++) {
+		Gfx_DrawIndexedTris_T2fC4b(verticesCounts[i], startVertices[i]);
 	}
 }
 #endif
@@ -2090,6 +2339,14 @@ void Gfx_EnableTextureOffset(float x, float y) {
 }
 
 void Gfx_DisableTextureOffset(void) { Gfx_LoadIdentityMatrix(2); }
+/* Fixed function pipeline can't wrap texture coordinates within atlas tiles */
+void Gfx_EnableTileRepeat(float tileSize) { }
+void Gfx_DisableTileRepeat(void) { }
+/* Fixed function pipeline can't decode packed vertices */
+void Gfx_SetPackedOrigin(float x, float y, float z) { }
+/* Fixed function pipeline can't duplicate draws to each eye */
+void Gfx_BeginStereo(const struct Matrix* leftProj, const struct Matrix* rightProj) { }
+void Gfx_EndStereo(void) { }
 
 static void Gfx_FreeState(void) { FreeDefaultResources(); }
 static void Gfx_RestoreState(void) {
@@ -2198,14 +2455,57 @@ void Gfx_DrawVb_IndexedTris(int verticesCount) {
 }
 
 #ifndef CC_BUILD_GL11
+static int gfx_baseVertex;
+void Gfx_BindVb_T2fC4b(GfxResourceID vb, int startVertex) {
+	Gfx_BindVb(vb);
+	gfx_baseVertex = startVertex;
+}
+
 void Gfx_DrawIndexedTris_T2fC4b(int verticesCount, int startVertex) {
-	cc_uint32 offset = startVertex * SIZEOF_VERTEX_TEXTURED;
+	cc_uint32 offset = (gfx_baseVertex + startVertex) * SIZEOF_VERTEX_TEXTURED;
 	glVertexPointer(3, GL_FLOAT,        SIZEOF_VERTEX_TEXTURED, (void*)(offset));
 	glColorPointer(4, GL_UNSIGNED_BYTE, SIZEOF_VERTEX_TEXTURED, (void*)(offset + 12));
 	glTexCoordPointer(2, GL_FLOAT,      SIZEOF_VERTEX_TEXTURED, (void*)(offset + 16));
 	glDrawElements(GL_TRIANGLES,        ICOUNT(verticesCount),   GL_UNSIGNED_SHORT, NULL);
 }
 
+static void (APIENTRY *_glMultiDrawElementsBaseVertex)(GLenum mode, const GLsizei* count, GLenum type, 
+													const GLvoid* const* indices, GLsizei drawcount, const GLint* basevertex);
+#define GL_MAX_MULTIDRAWS 256
+
+void Gfx_MultiDrawIndexedTris_T2fC4b(int count, const int* verticesCounts, const int* startVertices) {
+	GLsizei indicesCounts[GL_MAX_MULTIDRAWS];
+	const GLvoid* offsets[GL_MAX_MULTIDRAWS];
+	GLint baseVertices[GL_MAX_MULTIDRAWS];
+	int i = 0, j, k, part;
+
+	if (!Gfx.MultiDraw) {
+		for (; i < count; i++) Gfx_DrawIndexedTris_T2fC4b(verticesCounts[i], startVertices[i]);
+		return;
+	}
+
+	while (i < count) {
+		for (j = 0; i < count && j < GL_MAX_MULTIDRAWS; i++) {
+			/* Default index buffer only has enough indices for GFX_MAX_VERTICES vertices */
+			if (verticesCounts[i] > GFX_MAX_VERTICES) {
+				for (k = 0; k < verticesCounts[i]; k += GFX_MAX_VERTICES) {
+					part = min(verticesCounts[i] - k, GFX_MAX_VERTICES);
+					Gfx_DrawIndexedTris_T2fC4b(part, startVertices[i] + k);
+				}
+				continue;
+			}
+			indicesCounts[j] = ICOUNT(verticesCounts[i]);
+			offsets[j]       = NULL;
+			baseVertices[j]  = gfx_baseVertex + startVertices[i];
+			j++;
+		}
+		if (!j) continue;
+
+		GL_SetupVbTextured();
+		_glMultiDrawElementsBaseVertex(GL_TRIANGLES, indicesCounts, GL_UNSIGNED_SHORT, offsets, j, baseVertices);
+	}
+}
+
 static void GL_CheckSupport(void) {
 	static const struct DynamicLibSym coreVboFuncs[5] = {
 		DynamicLib_Sym2("glBindBuffer",    glBindBuffer), DynamicLib_Sym2("glDeleteBuffers", glDeleteBuffers),
@@ -2217,7 +2517,11 @@ static void GL_CheckSupport(void) {
 		DynamicLib_Sym2("glGenBuffersARB",    glGenBuffers), DynamicLib_Sym2("glBufferDataARB",    glBufferData),
 		DynamicLib_Sym2("glBufferSubDataARB", glBufferSubData)
 	};
-	static const cc_string vboExt = String_FromConst("GL_ARB_vertex_buffer_object");
+	static const struct DynamicLibSym multiDrawFuncs[1] = {
+		DynamicLib_Sym2("glMultiDrawElementsBaseVertex", glMultiDrawElementsBaseVertex)
+	};
+	static const cc_string vboExt  = String_FromConst("GL_ARB_vertex_buffer_object");
+	static const cc_string baseExt = String_FromConst("GL_ARB_draw_elements_base_vertex");
 	cc_string extensions = String_FromReadonly((const char*)glGetString(GL_EXTENSIONS));
 	const GLubyte* ver   = glGetString(GL_VERSION);
 
@@ -2233,6 +2537,12 @@ static void GL_CheckSupport(void) {
 		Logger_Abort("Only OpenGL 1.1 supported.\n\n" \
 			"Compile the game with CC_BUILD_GL11, or ask on the ClassiCube forums for it");
 	}
+
+	/* Supported in core since 3.2 */
+	if (major > 3 || (major == 3 && minor >= 2) || String_CaselessContains(&extensions, &baseExt)) {
+		GLContext_GetAll(multiDrawFuncs, Array_Elems(multiDrawFuncs));
+		Gfx.MultiDraw = _glMultiDrawElementsBaseVertex != NULL;
+	}
 	customMipmapsLevels = true;
 }
 #else
@@ -12,7 +12,7 @@ struct IGameComponent;
 extern struct IGameComponent Gfx_Component;
 
 typedef enum VertexFormat_ {
-	VERTEX_FORMAT_COLOURED, VERTEX_FORMAT_TEXTURED
+	VERTEX_FORMAT_COLOURED, VERTEX_FORMAT_TEXTURED, VERTEX_FORMAT_PACKED
 } VertexFormat;
 typedef enum FogFunc_ {
 	FOG_LINEAR, FOG_EXP, FOG_EXP2
@@ -23,11 +23,20 @@ typedef enum MatrixType_ {
 
 #define SIZEOF_VERTEX_COLOURED 16
 #define SIZEOF_VERTEX_TEXTURED 24
+#define SIZEOF_VERTEX_PACKED   16
 
 /* 3 floats for position (XYZ), 4 bytes for colour. */
 struct VertexColoured { float X, Y, Z; PackedCol Col; };
 /* 3 floats for position (XYZ), 2 floats for texture coordinates (UV), 4 bytes for colour. */
 struct VertexTextured { float X, Y, Z; PackedCol Col; float U, V; };
+/* 3 shorts for position (XYZ) relative to origin, 1 short for 1D atlas row, 4 bytes for colour, */
+/*  2 shorts for texture coordinates (UV) in units of tiles within that row. (see Gfx_SetPackedOrigin) */
+/* NOTE: Only supported when Gfx.PackedVertices is true. */
+struct VertexPacked { cc_int16 X, Y, Z; cc_uint16 Row; PackedCol Col; cc_uint16 U, V; };
+/* Number of units per block that positions of packed vertices are in. */
+#define PACKED_POS_SCALE 1024
+/* Number of units per tile that texture coordinates of packed vertices are in. */
+#define PACKED_UV_SCALE  2048
 
 void Gfx_Create(void);
 void Gfx_Free(void);
@@ -46,6 +55,14 @@ CC_VAR extern struct _GfxData {
 	/* Whether graphics context has been created */
 	cc_bool Created;
 	struct Matrix View, Projection;
+	/* Whether textures can be repeated along both axes of 1D atlas tiles. (see Gfx_EnableTileRepeat) */
+	cc_bool TileRepeat;
+	/* Whether vertices can be drawn using VERTEX_FORMAT_PACKED. */
+	cc_bool PackedVertices;
+	/* Whether Gfx_MultiDrawIndexedTris_T2fC4b draws all of the ranges using a single draw call. */
+	cc_bool MultiDraw;
+	/* Whether both eyes of a stereo view can be drawn in a single pass. (see Gfx_BeginStereo) */
+	cc_bool SinglePassStereo;
 } Gfx;
 
 extern GfxResourceID Gfx_defaultIb;
@@ -137,11 +154,10 @@ CC_API void  Gfx_UnlockVb(GfxResourceID vb);
 /* Special case of Gfx_Create/LockVb for building chunks in Builder.c */
 GfxResourceID Gfx_CreateVb2(void* vertices, VertexFormat fmt, int count);
 #endif
-#ifdef CC_BUILD_GLMODERN
+#ifndef CC_BUILD_GL11
 /* Special case Gfx_BindVb for map renderer */
-void Gfx_BindVb_T2fC4b(GfxResourceID vb);
-#else
-#define Gfx_BindVb_T2fC4b Gfx_BindVb
+/* NOTE: startVertex is added to startVertex of subsequent Gfx_DrawIndexedTris_T2fC4b calls */
+void Gfx_BindVb_T2fC4b(GfxResourceID vb, int startVertex);
 #endif
 
 /* Creates a new dynamic vertex buffer, whose contents can be updated later. */
@@ -164,6 +180,10 @@ CC_API void  Gfx_UnlockDynamicVb(GfxResourceID vb);
 CC_API void Gfx_SetVertexFormat(VertexFormat fmt);
 /* Updates the data of a dynamic vertex buffer. */
 CC_API void Gfx_SetDynamicVbData(GfxResourceID vb, void* vertices, int vCount);
+#ifndef CC_BUILD_GL11
+/* Updates part of the data of a dynamic vertex buffer, without affecting the rest of its data. */
+void Gfx_SetDynamicVbRange(GfxResourceID vb, VertexFormat fmt, int startVertex, void* vertices, int vCount);
+#endif
 /* Renders vertices from the currently bound vertex buffer as lines. */
 CC_API void Gfx_DrawVb_Lines(int verticesCount);
 /* Renders vertices from the currently bound vertex and index buffer as triangles. */
@@ -173,6 +193,11 @@ CC_API void Gfx_DrawVb_IndexedTris_Range(int verticesCount, int startVertex);
 CC_API void Gfx_DrawVb_IndexedTris(int verticesCount);
 /* Special case Gfx_DrawVb_IndexedTris_Range for map renderer */
 void Gfx_DrawIndexedTris_T2fC4b(int verticesCount, int startVertex);
+#ifndef CC_BUILD_GL11
+/* Special case for map renderer, that draws several ranges of vertices at once. (see Gfx.MultiDraw) */
+/* Equivalent to calling Gfx_DrawIndexedTris_T2fC4b for each range. */
+void Gfx_MultiDrawIndexedTris_T2fC4b(int count, const int* verticesCounts, const int* startVertices);
+#endif
 
 /* Loads the given matrix over the currently active matrix. */
 CC_API void Gfx_LoadMatrix(MatrixType type, const struct Matrix* matrix);
@@ -180,6 +205,27 @@ CC_API void Gfx_LoadMatrix(MatrixType type, const struct Matrix* matrix);
 CC_API void Gfx_LoadIdentityMatrix(MatrixType type);
 CC_API void Gfx_EnableTextureOffset(float x, float y);
 CC_API void Gfx_DisableTextureOffset(void);
+/* U texture coordinate stride between the rows of a 1D atlas, for vertices drawn with tile repeat. */
+#define GFX_TILE_REPEAT_STRIDE 32
+/* Enables repeating textures along both axes of 1D atlas tiles. (only if Gfx.TileRepeat) */
+/* Vertices with U >= GFX_TILE_REPEAT_STRIDE are then treated as being encoded with */
+/*  U = u + (row + 1) * GFX_TILE_REPEAT_STRIDE, V = v, where u and v are in units of tiles. */
+/* NOTE: Other vertices are unaffected, as U of normal 1D atlas vertices never exceeds 17. */
+void Gfx_EnableTileRepeat(float tileSize);
+/* Disables repeating textures along both axes of 1D atlas tiles. */
+void Gfx_DisableTileRepeat(void);
+/* Sets the position that the positions of VERTEX_FORMAT_PACKED vertices are relative to. */
+/* NOTE: Packed vertices must be drawn with Gfx_EnableTileRepeat enabled, as their texture */
+/*  coordinates are decoded to V = (row + fract(v)) * tileSize. (and U = u) */
+void Gfx_SetPackedOrigin(float x, float y, float z);
+/* Begins drawing both eyes of a stereo view at once, into the left and right halves of the viewport. */
+/* Every draw call is drawn twice, transformed by the view matrix and then each eye's projection matrix. */
+/* The result matches drawing each eye separately into its half, apart from rounding at triangle edges. */
+/* NOTE: Projection matrices loaded before Gfx_EndStereo are used by both eyes. (e.g. Gfx_Begin2D) */
+/* NOTE: Only supported when Gfx.SinglePassStereo is true. */
+void Gfx_BeginStereo(const struct Matrix* leftProj, const struct Matrix* rightProj);
+/* Ends drawing both eyes at once, subsequent draw calls are only drawn once again. */
+void Gfx_EndStereo(void);
 /* Calculates an orthographic matrix suitable with this backend. (usually for 2D) */
 void Gfx_CalcOrthoMatrix(float width, float height, struct Matrix* matrix);
 /* Calculates a projection matrix suitable with this backend. (usually for 3D) */
@@ -7,10 +7,28 @@
 #include "Logger.h"
 #include "Event.h"
 #include "Game.h"
+#include "Builder.h"
+#include "Options.h"
 
 cc_int16* Lighting_Heightmap;
 #define HEIGHT_UNCALCULATED Int16_MaxValue
 
+cc_bool Lighting_BlockLighting;
+/* Per block light levels, with sky light in upper 4 bits and block light in lower 4 bits */
+/* NULL when block lighting is disabled, in which case light only comes from the heightmap */
+static cc_uint8* light_levels;
+enum LIGHT_FACE { LIGHT_FACE_NORMAL, LIGHT_FACE_XSIDE, LIGHT_FACE_ZSIDE, LIGHT_FACE_YMIN, LIGHT_FACE_COUNT };
+/* Colour of each face for every combination of sky and block light levels */
+static PackedCol light_cols[LIGHT_FACE_COUNT][256];
+
+/* Returns the packed sky and block light levels of the block at the given coordinates */
+static int BlockLight_Levels(int x, int y, int z) {
+	/* Blocks that block light are always dark themselves, but top faces of e.g. slabs */
+	/*  are inside the block, so use light of block above instead */
+	if (y < World.MaxY && Blocks.BlocksLight[World_GetBlock(x, y, z)]) y++;
+	return light_levels[World_Pack(x, y, z)];
+}
+
 #define Lighting_CalcBody(get_block)\
 for (y = maxY; y >= 0; y--, i -= World.OneY) {\
 	block = get_block;\
@@ -53,38 +71,379 @@ cc_bool Lighting_IsLit(int x, int y, int z) {
 }
 
 PackedCol Lighting_Col(int x, int y, int z) {
+	if (light_levels) return light_cols[LIGHT_FACE_NORMAL][BlockLight_Levels(x, y, z)];
 	return y > Lighting_GetLightHeight(x, z) ? Env.SunCol : Env.ShadowCol;
 }
 
 PackedCol Lighting_Col_XSide(int x, int y, int z) {
+	if (light_levels) return light_cols[LIGHT_FACE_XSIDE][BlockLight_Levels(x, y, z)];
 	return y > Lighting_GetLightHeight(x, z) ? Env.SunXSide : Env.ShadowXSide;
 }
 
 PackedCol Lighting_Col_Sprite_Fast(int x, int y, int z) {
+	if (light_levels) return light_cols[LIGHT_FACE_NORMAL][BlockLight_Levels(x, y, z)];
 	return y > Lighting_Heightmap[Lighting_Pack(x, z)] ? Env.SunCol : Env.ShadowCol;
 }
 
 PackedCol Lighting_Col_YMax_Fast(int x, int y, int z) {
+	if (light_levels) return light_cols[LIGHT_FACE_NORMAL][BlockLight_Levels(x, y, z)];
 	return y > Lighting_Heightmap[Lighting_Pack(x, z)] ? Env.SunCol : Env.ShadowCol;
 }
 
 PackedCol Lighting_Col_YMin_Fast(int x, int y, int z) {
+	if (light_levels) return light_cols[LIGHT_FACE_YMIN][BlockLight_Levels(x, y, z)];
 	return y > Lighting_Heightmap[Lighting_Pack(x, z)] ? Env.SunYMin : Env.ShadowYMin;
 }
 
 PackedCol Lighting_Col_XSide_Fast(int x, int y, int z) {
+	if (light_levels) return light_cols[LIGHT_FACE_XSIDE][BlockLight_Levels(x, y, z)];
 	return y > Lighting_Heightmap[Lighting_Pack(x, z)] ? Env.SunXSide : Env.ShadowXSide;
 }
 
 PackedCol Lighting_Col_ZSide_Fast(int x, int y, int z) {
+	if (light_levels) return light_cols[LIGHT_FACE_ZSIDE][BlockLight_Levels(x, y, z)];
 	return y > Lighting_Heightmap[Lighting_Pack(x, z)] ? Env.SunZSide : Env.ShadowZSide;
 }
 
+static void BlockLight_CalcAll(void);
+static void Lighting_Precompute(void);
+/* Whether light heights of all columns need to be recalculated before chunks are next built */
+static cc_bool heights_stale;
+/* Whether light levels of all blocks need to be recalculated before chunks are next built */
+static cc_bool light_stale;
+
 void Lighting_Refresh(void) {
 	int i;
+	/* Light heights are recalculated in Lighting_Update, as the chunk mesh builder threads */
+	/*  only ever read the heightmap (and so can't calculate missing heights themselves) */
 	for (i = 0; i < World.Width * World.Length; i++) {
 		Lighting_Heightmap[i] = HEIGHT_UNCALCULATED;
 	}
+	heights_stale = true;
+	/* Recalculating block light is expensive, so is delayed until Lighting_Update */
+	/*  (changing the definitions of many blocks at once then only recalculates once) */
+	if (light_levels) light_stale = true;
+}
+
+void Lighting_Update(void) {
+	if (heights_stale) {
+		heights_stale = false;
+		Lighting_Precompute();
+	}
+
+	if (!light_stale) return;
+	light_stale = false;
+	BlockLight_CalcAll();
+}
+
+
+/*########################################################################################################################*
+*-----------------------------------------------------Block lighting------------------------------------------------------*
+*#########################################################################################################################*/
+#define LIGHT_MAX 15
+#define LIGHT_BLOCK_SHIFT 0
+#define LIGHT_SKY_SHIFT   4
+#define Light_Get(i, shift) ((light_levels[i] >> (shift)) & 0x0F)
+#define Light_Set(i, shift, value) light_levels[i] = (cc_uint8)((light_levels[i] & ~(0x0F << (shift))) | ((value) << (shift)))
+/* Colour block light tints faces towards, when at maximum light level */
+#define LIGHT_BLOCK_COL PackedCol_Make(255, 235, 200, 255)
+
+struct LightNode { cc_uint16 x, y, z, level; };
+/* Ring buffer of nodes, whose capacity is always a power of two */
+struct LightQueue { struct LightNode* nodes; int head, count, capacity; };
+#define LIGHT_QUEUE_SIZE 4096
+/* Blocks whose light needs spreading to neighbours, and blocks whose light was removed */
+static struct LightQueue light_spreadQueue, light_removeQueue;
+
+static const cc_int8 light_dirs[6][3] = {
+	{ -1, 0, 0 }, { +1, 0, 0 }, { 0, 0, -1 }, { 0, 0, +1 }, { 0, -1, 0 }, { 0, +1, 0 }
+};
+#define LIGHT_DIR_DOWN 4
+/* Whether each chunk contains (or has faces next to) blocks whose light changed during the current update */
+static cc_uint8* light_dirtyChunks;
+/* Indices of the chunks marked in light_dirtyChunks, so only those chunks get refreshed */
+static int* light_dirtyList;
+static int light_dirtyCount, light_chunksX, light_chunksY;
+
+static void LightQueue_Grow(struct LightQueue* queue) {
+	if (!queue->capacity) {
+		queue->capacity = LIGHT_QUEUE_SIZE;
+		queue->nodes    = (struct LightNode*)Mem_Alloc(queue->capacity, sizeof(struct LightNode), "light queue");
+		return;
+	}
+
+	queue->nodes = (struct LightNode*)Mem_Realloc(queue->nodes, queue->capacity * 2,
+									sizeof(struct LightNode), "light queue");
+	/* Queue is full, so nodes before head are the ones that wrapped around to the start */
+	/*  Move them to just after the old end, so all nodes are contiguous again */
+	Mem_Copy(&queue->nodes[queue->capacity], queue->nodes, queue->head * sizeof(struct LightNode));
+	queue->capacity *= 2;
+}
+
+static void LightQueue_Push(struct LightQueue* queue, int x, int y, int z, int level) {
+	struct LightNode* node;
+	if (queue->count == queue->capacity) LightQueue_Grow(queue);
+
+	node = &queue->nodes[(queue->head + queue->count) & (queue->capacity - 1)];
+	node->x = x; node->y = y; node->z = z; node->level = level;
+	queue->count++;
+}
+
+static CC_INLINE struct LightNode LightQueue_Pop(struct LightQueue* queue) {
+	struct LightNode node = queue->nodes[queue->head];
+	queue->head = (queue->head + 1) & (queue->capacity - 1);
+	queue->count--;
+	return node;
+}
+
+static void LightQueue_Free(struct LightQueue* queue) {
+	Mem_Free(queue->nodes);
+	queue->nodes    = NULL;
+	queue->head     = 0;
+	queue->count    = 0;
+	queue->capacity = 0;
+}
+
+static void BlockLight_MarkChanged(int x, int y, int z) {
+	int minCx, minCy, minCz, maxCx, maxCy, maxCz;
+	int cx, cy, cz, index;
+
+	/* Faces of blocks next to the given block use its light too */
+	minCx = max(x - 1, 0) >> CHUNK_SHIFT; maxCx = min(x + 1, World.MaxX) >> CHUNK_SHIFT;
+	minCy = max(y - 1, 0) >> CHUNK_SHIFT; maxCy = min(y + 1, World.MaxY) >> CHUNK_SHIFT;
+	minCz = max(z - 1, 0) >> CHUNK_SHIFT; maxCz = min(z + 1, World.MaxZ) >> CHUNK_SHIFT;
+
+	for (cz = minCz; cz <= maxCz; cz++) {
+		for (cy = minCy; cy <= maxCy; cy++) {
+			for (cx = minCx; cx <= maxCx; cx++) {
+				index = (cz * light_chunksY + cy) * light_chunksX + cx;
+				if (light_dirtyChunks[index]) continue;
+
+				light_dirtyChunks[index] = true;
+				light_dirtyList[light_dirtyCount++] = index;
+			}
+		}
+	}
+}
+
+/* Forgets which chunks were marked as changed, without refreshing them */
+static void BlockLight_ClearChanged(void) {
+	int i;
+	for (i = 0; i < light_dirtyCount; i++) {
+		light_dirtyChunks[light_dirtyList[i]] = false;
+	}
+	light_dirtyCount = 0;
+}
+
+#ifdef EXTENDED_BLOCKS
+#define BlockLight_Block(i) ((BlockID)((World.Blocks[i] | (World.Blocks2[i] << 8)) & World.IDMask))
+#else
+#define BlockLight_Block(i) World.Blocks[i]
+#endif
+
+#define BlockLight_SpreadTo(x, y, z, offset, next)\
+j = i + (offset);\
+if (Light_Get(j, shift) < (next) && !Blocks.BlocksLight[BlockLight_Block(j)]) {\
+	Light_Set(j, shift, next);\
+	BlockLight_MarkChanged(x, y, z);\
+	LightQueue_Push(queue, x, y, z, 0);\
+}
+
+/* Spreads light from all blocks in the spread queue to their neighbours, */
+/*  until every reachable block is lit with the brightest level it can receive */
+static void BlockLight_Spread(int shift) {
+	struct LightQueue* queue = &light_spreadQueue;
+	struct LightNode node;
+	int i, j, x, y, z, level, down;
+
+	while (queue->count) {
+		node  = LightQueue_Pop(queue);
+		x = node.x; y = node.y; z = node.z;
+		i     = World_Pack(x, y, z);
+		level = Light_Get(i, shift);
+		if (level <= 1) continue;
+
+		/* Sky light shines straight down without getting any dimmer */
+		down  = (shift == LIGHT_SKY_SHIFT && level == LIGHT_MAX) ? LIGHT_MAX : level - 1;
+		level = level - 1;
+
+		if (x > 0)          { BlockLight_SpreadTo(x - 1, y, z, -1,           level); }
+		if (x < World.MaxX) { BlockLight_SpreadTo(x + 1, y, z, +1,           level); }
+		if (z > 0)          { BlockLight_SpreadTo(x, y, z - 1, -World.Width, level); }
+		if (z < World.MaxZ) { BlockLight_SpreadTo(x, y, z + 1, +World.Width, level); }
+		if (y > 0)          { BlockLight_SpreadTo(x, y - 1, z, -World.OneY,  down);  }
+		if (y < World.MaxY) { BlockLight_SpreadTo(x, y + 1, z, +World.OneY,  level); }
+	}
+}
+
+/* Darkens all blocks that were lit by the blocks in the remove queue, */
+/*  and queues up blocks lit by other sources for spreading light back into the darkened area */
+static void BlockLight_Unspread(int shift) {
+	struct LightQueue* queue = &light_removeQueue;
+	struct LightNode node;
+	int i, dir, x, y, z, level;
+	BlockID block;
+
+	while (queue->count) {
+		node = LightQueue_Pop(queue);
+
+		for (dir = 0; dir < 6; dir++) {
+			x = node.x + light_dirs[dir][0];
+			y = node.y + light_dirs[dir][1];
+			z = node.z + light_dirs[dir][2];
+			if (!World_Contains(x, y, z)) continue;
+
+			i     = World_Pack(x, y, z);
+			level = Light_Get(i, shift);
+			if (!level) continue;
+
+			if (level < node.level || (shift == LIGHT_SKY_SHIFT && dir == LIGHT_DIR_DOWN && node.level == LIGHT_MAX)) {
+				Light_Set(i, shift, 0);
+				BlockLight_MarkChanged(x, y, z);
+				LightQueue_Push(queue, x, y, z, level);
+
+				/* Light emitting blocks are never darkened */
+				block = World_GetBlock(x, y, z);
+				if (shift == LIGHT_BLOCK_SHIFT && Blocks.FullBright[block]) {
+					Light_Set(i, shift, LIGHT_MAX);
+					LightQueue_Push(&light_spreadQueue, x, y, z, 0);
+				}
+			} else {
+				LightQueue_Push(&light_spreadQueue, x, y, z, 0);
+			}
+		}
+	}
+}
+
+/* Removes the light of the given block, then queues up whatever light it should now have */
+static void BlockLight_Reset(int x, int y, int z, BlockID block, int shift) {
+	int dir, nx, ny, nz, i = World_Pack(x, y, z);
+	int level = Light_Get(i, shift);
+
+	if (level) {
+		Light_Set(i, shift, 0);
+		BlockLight_MarkChanged(x, y, z);
+		LightQueue_Push(&light_removeQueue, x, y, z, level);
+	}
+
+	if (!Blocks.BlocksLight[block]) {
+		/* Neighbours may now be able to spread light into this block */
+		for (dir = 0; dir < 6; dir++) {
+			nx = x + light_dirs[dir][0];
+			ny = y + light_dirs[dir][1];
+			nz = z + light_dirs[dir][2];
+			if (World_Contains(nx, ny, nz)) LightQueue_Push(&light_spreadQueue, nx, ny, nz, 0);
+		}
+	}
+
+	/* Top of the world is always in full sky light, and light emitting blocks always at full light */
+	if (shift == LIGHT_SKY_SHIFT ? (y == World.MaxY && !Blocks.BlocksLight[block]) : Blocks.FullBright[block]) {
+		Light_Set(i, shift, LIGHT_MAX);
+		BlockLight_MarkChanged(x, y, z);
+		LightQueue_Push(&light_spreadQueue, x, y, z, 0);
+	}
+}
+
+/* Only refreshes chunks containing (or having faces next to) blocks whose light changed */
+/*  (changes scattered across the map only refresh the chunks around each change) */
+static void BlockLight_RefreshChanged(void) {
+	int i, index, cx, cy, cz;
+
+	for (i = 0; i < light_dirtyCount; i++) {
+		index = light_dirtyList[i];
+		cx    = index % light_chunksX;
+		cy    = (index / light_chunksX) % light_chunksY;
+		cz    = index / (light_chunksX * light_chunksY);
+		MapRenderer_RefreshChunk(cx, cy, cz);
+	}
+	BlockLight_ClearChanged();
+}
+
+/* Incrementally updates light levels after the given blocks have changed */
+static void BlockLight_OnBlocksChanged(const IVec3* coords, const BlockID* blocks, int count) {
+	int i, shift;
+
+	for (shift = LIGHT_BLOCK_SHIFT; shift <= LIGHT_SKY_SHIFT; shift += LIGHT_SKY_SHIFT) {
+		for (i = 0; i < count; i++) {
+			BlockLight_Reset(coords[i].X, coords[i].Y, coords[i].Z, blocks[i], shift);
+		}
+		BlockLight_Unspread(shift);
+		BlockLight_Spread(shift);
+	}
+	BlockLight_RefreshChanged();
+}
+
+/* Calculates light levels of all blocks in the world from scratch */
+static void BlockLight_CalcAll(void) {
+	cc_int16* bottoms;
+	int x, y, z, hIndex, bottom, maxBottom;
+
+	bottoms = (cc_int16*)Mem_TryAlloc(World.Width * World.Length, 2);
+	/* Fall back to only using heightmap if not enough memory */
+	if (!bottoms) { Mem_Free(light_levels); light_levels = NULL; return; }
+	Mem_Set(light_levels, 0, World.Volume);
+
+	/* Sky light shines straight down each column until the first block that blocks light */
+	for (z = 0, hIndex = 0; z < World.Length; z++) {
+		for (x = 0; x < World.Width; x++, hIndex++) {
+			for (y = World.MaxY; y >= 0; y--) {
+				if (Blocks.BlocksLight[World_GetBlock(x, y, z)]) break;
+				light_levels[World_Pack(x, y, z)] = LIGHT_MAX << LIGHT_SKY_SHIFT;
+			}
+			bottoms[hIndex] = y + 1;
+		}
+	}
+
+	/* Sky light only needs to be spread sideways from where neighbouring columns are in shadow */
+	for (z = 0, hIndex = 0; z < World.Length; z++) {
+		for (x = 0; x < World.Width; x++, hIndex++) {
+			bottom    = bottoms[hIndex];
+			maxBottom = bottom;
+			if (x > 0)             maxBottom = max(maxBottom, bottoms[hIndex - 1]);
+			if (x < World.MaxX)    maxBottom = max(maxBottom, bottoms[hIndex + 1]);
+			if (z > 0)             maxBottom = max(maxBottom, bottoms[hIndex - World.Width]);
+			if (z < World.MaxZ)    maxBottom = max(maxBottom, bottoms[hIndex + World.Width]);
+
+			for (y = bottom; y < maxBottom; y++) {
+				LightQueue_Push(&light_spreadQueue, x, y, z, 0);
+			}
+		}
+	}
+	Mem_Free(bottoms);
+	BlockLight_Spread(LIGHT_SKY_SHIFT);
+
+	for (y = 0; y < World.Height; y++) {
+		for (z = 0; z < World.Length; z++) {
+			for (x = 0; x < World.Width; x++) {
+				if (!Blocks.FullBright[World_GetBlock(x, y, z)]) continue;
+
+				Light_Set(World_Pack(x, y, z), LIGHT_BLOCK_SHIFT, LIGHT_MAX);
+				LightQueue_Push(&light_spreadQueue, x, y, z, 0);
+			}
+		}
+	}
+	BlockLight_Spread(LIGHT_BLOCK_SHIFT);
+	/* Queue may have grown to be very large, but incremental updates usually only need a small queue */
+	LightQueue_Free(&light_spreadQueue);
+	/* All chunks get built from scratch after a new map is loaded anyways */
+	BlockLight_ClearChanged();
+}
+
+static void BlockLight_UpdateCols(void) {
+	PackedCol sky, lit, col;
+	int level;
+
+	for (level = 0; level < 256; level++) {
+		sky = PackedCol_Lerp(Env.ShadowCol, Env.SunCol,    (level >> LIGHT_SKY_SHIFT) / (float)LIGHT_MAX);
+		lit = PackedCol_Lerp(Env.ShadowCol, LIGHT_BLOCK_COL, (level & 0x0F) / (float)LIGHT_MAX);
+
+		/* Brightest of sky and block light */
+		col = PackedCol_Make(max(PackedCol_R(sky), PackedCol_R(lit)), max(PackedCol_G(sky), PackedCol_G(lit)),
+							 max(PackedCol_B(sky), PackedCol_B(lit)), 255);
+		light_cols[LIGHT_FACE_NORMAL][level] = col;
+		PackedCol_GetShaded(col, &light_cols[LIGHT_FACE_XSIDE][level],
+							&light_cols[LIGHT_FACE_ZSIDE][level], &light_cols[LIGHT_FACE_YMIN][level]);
+	}
 }
 
 
@@ -154,8 +513,22 @@ static cc_bool Lighting_NeedsNeighour(BlockID block, int i, int minY, int y, int
 	return false;
 }
 
+static void Lighting_ResetNeighbours(int x, int y, int z, BlockID block, int cx, int cz, int minCy, int maxCy) {
+	int cy, minY, maxY;
+
+	for (cy = maxCy; cy >= minCy; cy--) {
+		minY = (cy << CHUNK_SHIFT); 
+		maxY = (cy << CHUNK_SHIFT) + CHUNK_MAX;
+		if (maxY > World.MaxY) maxY = World.MaxY;
+
+		if (Lighting_NeedsNeighour(block, World_Pack(x, maxY, z), minY, maxY, y)) {
+			MapRenderer_RefreshChunk(cx, cy, cz);
+		}
+	}
+}
+
 static void Lighting_ResetNeighbour(int x, int y, int z, BlockID block, int cx, int cy, int cz, int minCy, int maxCy) {
-	int minY, maxY;
+	int minY;
 
 	if (minCy == maxCy) {
 		minY = cy << CHUNK_SHIFT;
@@ -164,15 +537,7 @@ static void Lighting_ResetNeighbour(int x, int y, int z, BlockID block, int cx,
 			MapRenderer_RefreshChunk(cx, cy, cz);
 		}
 	} else {
-		for (cy = maxCy; cy >= minCy; cy--) {
-			minY = (cy << CHUNK_SHIFT); 
-			maxY = (cy << CHUNK_SHIFT) + CHUNK_MAX;
-			if (maxY > World.MaxY) maxY = World.MaxY;
-
-			if (Lighting_NeedsNeighour(block, World_Pack(x, maxY, z), minY, maxY, y)) {
-				MapRenderer_RefreshChunk(cx, cy, cz);
-			}
-		}
+		Lighting_ResetNeighbours(x, y, z, block, cx, cz, minCy, maxCy);
 	}
 }
 
@@ -222,6 +587,12 @@ void Lighting_OnBlockChanged(int x, int y, int z, BlockID oldBlock, BlockID newB
 	int hIndex = Lighting_Pack(x, z);
 	int lightH = Lighting_Heightmap[hIndex];
 	int newHeight;
+	IVec3 coords;
+
+	if (light_levels) {
+		coords.X = x; coords.Y = y; coords.Z = z;
+		BlockLight_OnBlocksChanged(&coords, &newBlock, 1);
+	}
 
 	/* Since light wasn't checked to begin with, means column never had meshes for any of its chunks built. */
 	/* So we don't need to do anything. */
@@ -229,146 +600,279 @@ void Lighting_OnBlockChanged(int x, int y, int z, BlockID oldBlock, BlockID newB
 
 	Lighting_UpdateLighting(x, y, z, oldBlock, newBlock, hIndex, lightH);
 	newHeight = Lighting_Heightmap[hIndex] + 1;
+	/* Heightmap is only used for colours of smooth lit chunks when block lighting is enabled */
+	if (light_levels && !Builder_SmoothLighting) return;
 	Lighting_RefreshAffected(x, y, z, newBlock, lightH + 1, newHeight);
 }
 
 
 /*########################################################################################################################*
-*---------------------------------------------------Lighting heightmap----------------------------------------------------*
+*-------------------------------------------------Lighting batched update-------------------------------------------------*
 *#########################################################################################################################*/
-static int Lighting_InitialHeightmapCoverage(int x1, int z1, int xCount, int zCount, int* skip) {
-	int elemsLeft = 0, index = 0, curRunCount = 0;
-	int x, z, hIndex, lightH;
-
-	for (z = 0; z < zCount; z++) {
-		hIndex = Lighting_Pack(x1, z1 + z);
-		for (x = 0; x < xCount; x++) {
-			lightH = Lighting_Heightmap[hIndex++];
-
-			skip[index] = 0;
-			if (lightH == HEIGHT_UNCALCULATED) {
-				elemsLeft++;
-				curRunCount = 0;
-			} else {
-				skip[index - curRunCount]++;
-				curRunCount++;
-			}
-			index++;
+struct LightingColumn { int x, z, hIndex, lightH, maxY; };
+
+/* Refreshes all chunks in the column (and on chunk borders, neighbouring columns) whose light changed */
+static void Lighting_RefreshColumn(int x, int z, int oldHeight, int newHeight) {
+	int cx = x >> CHUNK_SHIFT, bX = x & CHUNK_MASK;
+	int cz = z >> CHUNK_SHIFT, bZ = z & CHUNK_MASK;
+
+	int newCy = newHeight < 0 ? 0 : newHeight >> 4;
+	int oldCy = oldHeight < 0 ? 0 : oldHeight >> 4;
+	int minCy = min(oldCy, newCy), maxCy = max(oldCy, newCy);
+	Lighting_ResetColumn(cx, minCy, cz, minCy, maxCy);
+
+	/* NOTE: -1 as Y, since there is no changed block in neighbouring columns to compare against */
+	if (bX == 0 && cx > 0) {
+		Lighting_ResetNeighbours(x - 1, -1, z, BLOCK_AIR, cx - 1, cz, minCy, maxCy);
+	}
+	if (bZ == 0 && cz > 0) {
+		Lighting_ResetNeighbours(x, -1, z - 1, BLOCK_AIR, cx, cz - 1, minCy, maxCy);
+	}
+	if (bX == 15 && cx < MapRenderer_ChunksX - 1) {
+		Lighting_ResetNeighbours(x + 1, -1, z, BLOCK_AIR, cx + 1, cz, minCy, maxCy);
+	}
+	if (bZ == 15 && cz < MapRenderer_ChunksZ - 1) {
+		Lighting_ResetNeighbours(x, -1, z + 1, BLOCK_AIR, cx, cz + 1, minCy, maxCy);
+	}
+}
+
+void Lighting_OnBlocksChanged(const IVec3* coords, const BlockID* blocks, int count) {
+	struct LightingColumn columns[LIGHTING_MAX_BATCH];
+	struct LightingColumn* col;
+	int i, j, hIndex, height, numColumns = 0;
+	if (light_levels) BlockLight_OnBlocksChanged(coords, blocks, count);
+
+	/* Merge the changed blocks into the set of distinct columns they are in */
+	for (i = 0; i < count; i++) {
+		hIndex = Lighting_Pack(coords[i].X, coords[i].Z);
+		/* Light was never calculated for this column, so no chunks in it have been built yet */
+		if (Lighting_Heightmap[hIndex] == HEIGHT_UNCALCULATED) continue;
+
+		for (j = 0; j < numColumns; j++) {
+			if (columns[j].hIndex == hIndex) break;
+		}
+		col = &columns[j];
+
+		if (j == numColumns) {
+			col->x      = coords[i].X;
+			col->z      = coords[i].Z;
+			col->hIndex = hIndex;
+			col->lightH = Lighting_Heightmap[hIndex];
+			col->maxY   = coords[i].Y;
+			numColumns++;
+		} else if (coords[i].Y > col->maxY) {
+			col->maxY   = coords[i].Y;
 		}
-		curRunCount = 0; /* We can only skip an entire X row at most. */
 	}
-	return elemsLeft;
+
+	/* Nothing above max(highest changed block, old light height + 1) can block light, */
+	/*  so the new light height can be found by scanning down from there just once. */
+	/* Changes entirely below the old light height never change the light height. */
+	for (j = 0; j < numColumns; j++) {
+		col = &columns[j];
+		if (col->maxY < col->lightH) continue;
+
+		height = max(col->maxY, col->lightH + 1);
+		if (height > World.MaxY) height = World.MaxY;
+		Lighting_CalcHeightAt(col->x, height, col->z, col->hIndex);
+	}
+	if (light_levels && !Builder_SmoothLighting) return;
+
+	/* Blocks on chunk borders may still require faces of neighbouring chunks to be rebuilt */
+	for (i = 0; i < count; i++) {
+		hIndex = Lighting_Pack(coords[i].X, coords[i].Z);
+		height = Lighting_Heightmap[hIndex];
+		if (height == HEIGHT_UNCALCULATED) continue;
+
+		Lighting_RefreshAffected(coords[i].X, coords[i].Y, coords[i].Z, blocks[i], height + 1, height + 1);
+	}
+
+	for (j = 0; j < numColumns; j++) {
+		col    = &columns[j];
+		height = Lighting_Heightmap[col->hIndex];
+		if (height == col->lightH) continue;
+
+		Lighting_RefreshColumn(col->x, col->z, col->lightH + 1, height + 1);
+	}
 }
 
-#define Lighting_CalculateBody(get_block)\
-for (y = World.Height - 1; y >= 0; y--) {\
-	if (elemsLeft <= 0) { return true; } \
-	mapIndex = World_Pack(x1, y, z1);\
-	hIndex   = Lighting_Pack(x1, z1);\
-\
-	for (z = 0; z < zCount; z++) {\
-		baseIndex = mapIndex;\
-		index = z * xCount;\
-		for (x = 0; x < xCount;) {\
-			curRunCount = skip[index];\
-			x += curRunCount; mapIndex += curRunCount; index += curRunCount;\
-\
-			if (x < xCount && Blocks.BlocksLight[get_block]) {\
-				lightOffset = (Blocks.LightOffset[get_block] >> FACE_YMAX) & 1;\
-				Lighting_Heightmap[hIndex + x] = (cc_int16)(y - lightOffset);\
-				elemsLeft--;\
-				skip[index] = 0;\
+
+/*########################################################################################################################*
+*--------------------------------------------------Lighting precompute----------------------------------------------------*
+*#########################################################################################################################*/
+/* Heightmap is calculated for all columns before chunks are built, so chunk building never has to */
+/*  scan down columns itself. Columns are split up by rows across multiple threads. */
+#define LIGHTING_BAND_ROWS 16
+#define LIGHTING_MAX_THREADS 32
+static void* lighting_mutex;
+static int lighting_nextZ;
+static cc_bool lighting_airFast;
+
+/* Whether the 8 blocks starting at the given index are all air */
+static CC_INLINE cc_bool Lighting_AllAir8(int i) {
+	BlockRaw* b = &World.Blocks[i];
+	int all = b[0] | b[1] | b[2] | b[3] | b[4] | b[5] | b[6] | b[7];
+#ifdef EXTENDED_BLOCKS
+	if (World.IDMask > 0xFF) {
+		b    = &World.Blocks2[i];
+		all |= b[0] | b[1] | b[2] | b[3] | b[4] | b[5] | b[6] | b[7];
+	}
+#endif
+	return all == BLOCK_AIR;
+}
+
+#define Lighting_PrecomputeBody(get_block)\
+for (y = World.MaxY; y >= 0; y--) {\
+	/* Scanning entire rows is wasteful when only a few columns are left */\
+	if (elemsLeft <= minLeft) break;\
 \
-				offset = prevRunCount + curRunCount;\
-				newRunCount = skip[index - offset] + 1;\
+	for (z = zBeg; z < zEnd; z++) {\
+		mapIndex = World_Pack(0, y, z);\
+		hIndex   = Lighting_Pack(0, z);\
 \
-				/* consider case 1 0 1 0, where we are at last 0 */ \
-				/* we need to make this 3 0 0 0 and advance by 1 */ \
-				oldRunCount = (x - offset + newRunCount) < xCount ? skip[index - offset + newRunCount] : 0; \
-				if (oldRunCount != 0) {\
-					skip[index - offset + newRunCount] = 0; \
-					newRunCount += oldRunCount; \
-				} \
-				skip[index - offset] = newRunCount; \
-				x += oldRunCount; index += oldRunCount; mapIndex += oldRunCount; \
-				prevRunCount = newRunCount; \
-			} else { \
-				prevRunCount = 0; \
+		for (x = 0; x < World.Width; x++, mapIndex++, hIndex++) {\
+			/* Check 8 blocks at once, since most blocks above the ground are air */\
+			if (lighting_airFast && (x & 7) == 0 && x + 8 <= World.Width && Lighting_AllAir8(mapIndex)) {\
+				x += 7; mapIndex += 7; hIndex += 7; continue;\
 			}\
-			x++; mapIndex++; index++; \
+			if (Lighting_Heightmap[hIndex] != HEIGHT_UNCALCULATED) continue;\
+\
+			block = get_block;\
+			if (!Blocks.BlocksLight[block]) continue;\
+			offset = (Blocks.LightOffset[block] >> FACE_YMAX) & 1;\
+			Lighting_Heightmap[hIndex] = (cc_int16)(y - offset);\
+			elemsLeft--;\
 		}\
-		prevRunCount = 0;\
-		hIndex += World.Width;\
-		mapIndex = baseIndex + World.Width; /* advance one Z */ \
 	}\
 }
 
-static cc_bool Lighting_CalculateHeightmapCoverage(int x1, int z1, int xCount, int zCount, int elemsLeft, int* skip) {
-	int prevRunCount = 0, curRunCount, newRunCount, oldRunCount;
-	int lightOffset, offset;
-	int mapIndex, hIndex, baseIndex, index;
-	int x, y, z;
+/* Calculates light height of all the columns in the given rows */
+static void Lighting_PrecomputeBand(int zBeg, int zEnd) {
+	int elemsLeft = (zEnd - zBeg) * World.Width;
+	int minLeft   = elemsLeft / 8;
+	int x, y, z, mapIndex, hIndex, offset;
+	BlockID block;
 
 #ifndef EXTENDED_BLOCKS
-	Lighting_CalculateBody(World.Blocks[mapIndex]);
+	Lighting_PrecomputeBody(World.Blocks[mapIndex]);
 #else
 	if (World.IDMask <= 0xFF) {
-		Lighting_CalculateBody(World.Blocks[mapIndex]);
+		Lighting_PrecomputeBody(World.Blocks[mapIndex]);
 	} else {
-		Lighting_CalculateBody(World.Blocks[mapIndex] | (World.Blocks2[mapIndex] << 8));
+		Lighting_PrecomputeBody(World.Blocks[mapIndex] | (World.Blocks2[mapIndex] << 8));
 	}
 #endif
-	return false;
-}
+	if (!elemsLeft) return;
 
-static void Lighting_FinishHeightmapCoverage(int x1, int z1, int xCount, int zCount) {
-	int x, z, hIndex, lightH;
+	/* Scan down the remaining columns individually, from the first row not yet checked */
+	for (z = zBeg; z < zEnd; z++) {
+		hIndex = Lighting_Pack(0, z);
+		for (x = 0; x < World.Width; x++, hIndex++) {
+			if (Lighting_Heightmap[hIndex] == HEIGHT_UNCALCULATED) Lighting_CalcHeightAt(x, y, z, hIndex);
+		}
+	}
+}
 
-	for (z = 0; z < zCount; z++) {
-		hIndex = Lighting_Pack(x1, z1 + z);
-		for (x = 0; x < xCount; x++, hIndex++) {
-			lightH = Lighting_Heightmap[hIndex];
+static void Lighting_PrecomputeLoop(void) {
+	int zBeg;
 
-			if (lightH == HEIGHT_UNCALCULATED) {
-				Lighting_Heightmap[hIndex] = -10;
-			}
+	for (;;) {
+		Mutex_Lock(lighting_mutex);
+		{
+			zBeg = lighting_nextZ;
+			lighting_nextZ += LIGHTING_BAND_ROWS;
 		}
+		Mutex_Unlock(lighting_mutex);
+
+		if (zBeg >= World.Length) return;
+		Lighting_PrecomputeBand(zBeg, min(zBeg + LIGHTING_BAND_ROWS, World.Length));
 	}
 }
 
-void Lighting_LightHint(int startX, int startZ) {
-	int x1 = max(startX, 0), x2 = min(World.Width,  startX + EXTCHUNK_SIZE);
-	int z1 = max(startZ, 0), z2 = min(World.Length, startZ + EXTCHUNK_SIZE);
-	int xCount = x2 - x1, zCount = z2 - z1;
-	int skip[EXTCHUNK_SIZE * EXTCHUNK_SIZE];
+/* Calculates light height of all columns in the world, using all available processors */
+static void Lighting_Precompute(void) {
+	void* threads[LIGHTING_MAX_THREADS];
+	int i, count;
+
+	/* Only need as many threads as there are bands */
+	count = (World.Length + LIGHTING_BAND_ROWS - 1) / LIGHTING_BAND_ROWS;
+	count = min(min(Thread_ProcessorsCount(), count) - 1, LIGHTING_MAX_THREADS);
+	lighting_nextZ   = 0;
+	lighting_airFast = !Blocks.BlocksLight[BLOCK_AIR];
+	lighting_mutex   = Mutex_Create();
 
-	int elemsLeft = Lighting_InitialHeightmapCoverage(x1, z1, xCount, zCount, skip);
-	if (!Lighting_CalculateHeightmapCoverage(x1, z1, xCount, zCount, elemsLeft, skip)) {
-		Lighting_FinishHeightmapCoverage(x1, z1, xCount, zCount);
+	for (i = 0; i < count; i++) {
+		threads[i] = Thread_Start(Lighting_PrecomputeLoop);
+	}
+	Lighting_PrecomputeLoop();
+	for (i = 0; i < count; i++) {
+		Thread_Join(threads[i]);
 	}
+	Mutex_Free(lighting_mutex);
 }
 
-
 /*########################################################################################################################*
 *---------------------------------------------------Lighting component----------------------------------------------------*
 *#########################################################################################################################*/
+static void OnEnvVariableChanged(void* obj, int envVar) {
+	if (envVar == ENV_VAR_SUN_COL || envVar == ENV_VAR_SHADOW_COL) BlockLight_UpdateCols();
+}
+
+static void OnInit(void) {
+	if (!Game_ClassicMode) Lighting_BlockLighting = Options_GetBool(OPT_BLOCK_LIGHTING, false);
+	Event_Register_(&WorldEvents.EnvVarChanged, NULL, OnEnvVariableChanged);
+}
+
 static void OnReset(void) {
 	Mem_Free(Lighting_Heightmap);
 	Lighting_Heightmap = NULL;
+	Mem_Free(light_levels);
+	light_levels = NULL;
+	light_stale  = false;
+
+	Mem_Free(light_dirtyChunks);
+	light_dirtyChunks = NULL;
+	Mem_Free(light_dirtyList);
+	light_dirtyList  = NULL;
+	light_dirtyCount = 0;
+
+	LightQueue_Free(&light_spreadQueue);
+	LightQueue_Free(&light_removeQueue);
+}
+
+static cc_bool BlockLight_AllocChunks(void) {
+	int count;
+	/* MapRenderer_ChunksX etc aren't calculated yet when the new map is first loaded */
+	light_chunksX = (World.Width  + CHUNK_MASK) >> CHUNK_SHIFT;
+	light_chunksY = (World.Height + CHUNK_MASK) >> CHUNK_SHIFT;
+	count         = light_chunksX * light_chunksY * ((World.Length + CHUNK_MASK) >> CHUNK_SHIFT);
+
+	light_dirtyChunks = (cc_uint8*)Mem_TryAllocCleared(count, 1);
+	light_dirtyList   = (int*)Mem_TryAlloc(count, 4);
+	return light_dirtyChunks && light_dirtyList;
 }
 
+static void OnFree(void) { OnReset(); }
+
 static void OnNewMapLoaded(void) {
 	Lighting_Heightmap = (cc_int16*)Mem_TryAlloc(World.Width * World.Length, 2);
-	if (Lighting_Heightmap) {
-		Lighting_Refresh();
-	} else {
-		World_OutOfMemory();
+	if (!Lighting_Heightmap) { World_OutOfMemory(); return; }
+
+	/* Not having enough memory for block lighting isn't fatal, as can just use heightmap instead */
+	if (Lighting_BlockLighting) {
+		light_levels = (cc_uint8*)Mem_TryAlloc(World.Volume, 1);
+		if (light_levels && !BlockLight_AllocChunks()) { Mem_Free(light_levels); light_levels = NULL; }
+		BlockLight_UpdateCols();
 	}
+
+	Lighting_Refresh();
+	/* Calculate all lighting now, instead of when the first chunks are about to be built */
+	Lighting_Update();
 }
 
 struct IGameComponent Lighting_Component = {
-	NULL,    /* Init  */
-	OnReset, /* Free  */
+	OnInit,  /* Init  */
+	OnFree,  /* Free  */
 	OnReset, /* Reset */
 	OnReset, /* OnNewMap */
 	OnNewMapLoaded /* OnNewMapLoaded */
@@ -1,8 +1,10 @@
 #ifndef CC_WORLDLIGHTING_H
 #define CC_WORLDLIGHTING_H
 #include "PackedCol.h"
+#include "Vectors.h"
 /* Manages lighting of blocks in the world.
 BasicLighting: Uses a simple heightmap, where each block is either in sun or shadow.
+BlockLighting: Also flood fills sky light and light from light emitting blocks through the world.
    Copyright 2014-2021 ClassiCube | Licensed under BSD-3
 */
 struct IGameComponent;
@@ -10,17 +12,25 @@ extern struct IGameComponent Lighting_Component;
 
 #define Lighting_Pack(x, z) ((x) + World.Width * (z))
 extern cc_int16* Lighting_Heightmap;
-
-/* Equivalent to (but far more optimised form of)
-* for x = startX; x < startX + 18; x++
-*   for z = startZ; z < startZ + 18; z++
-*      CalcLight(x, maxY, z)                         */
-void Lighting_LightHint(int startX, int startZ);
+/* Whether per block light levels are calculated when a map is loaded. (OPT_BLOCK_LIGHTING) */
+/* NOTE: Only takes effect for maps loaded after this is changed. */
+extern cc_bool Lighting_BlockLighting;
 
 /* Called when a block is changed to update internal lighting state. */
 /* NOTE: Implementations ***MUST*** mark all chunks affected by this lighting change as needing to be refreshed. */
 void Lighting_OnBlockChanged(int x, int y, int z, BlockID oldBlock, BlockID newBlock);
+/* Maximum number of block changes that can be passed to Lighting_OnBlocksChanged at once. */
+#define LIGHTING_MAX_BATCH 256
+/* Called after multiple blocks have been changed to update internal lighting state. */
+/* Each affected column's light height is only recalculated once, rather than once per block. */
+/* NOTE: All the blocks must have already been set in the world before calling this. */
+void Lighting_OnBlocksChanged(const IVec3* coords, const BlockID* blocks, int count);
+/* Marks all lighting state as needing to be recalculated. (e.g. after a block's light blocking state changes) */
+/* NOTE: Light heights and per block light levels are only recalculated in Lighting_Update. */
 void Lighting_Refresh(void);
+/* Recalculates light heights and per block light levels if Lighting_Refresh was called since the last update. */
+/* NOTE: Called once per frame before chunks are built, so is only done once even after many refreshes. */
+void Lighting_Update(void);
 
 /* Returns whether the block at the given coordinates is fully in sunlight. */
 /* NOTE: Does ***NOT*** check that the coordinates are inside the map. */
@@ -83,6 +83,11 @@ static const char* GetCCErrorDesc(cc_result res) {
 	case CW_ERR_STRING_LEN: return "NBT string too long";
 
 	case ERR_DOWNLOAD_INVALID: return "Website denied download or doesn't exist";
+
+	case CCR_ERR_IDENTIFIER:  return "Invalid .ccr map identifier";
+	case CCR_ERR_VERSION:     return "Unsupported .ccr map version";
+	case CCR_ERR_REGION_SIZE: return "Invalid .ccr map region size";
+	case CCR_ERR_DIMENSIONS:  return "Invalid .ccr map dimensions";
 	}
 	return NULL;
 }
@@ -9,6 +9,7 @@
 #include "Funcs.h"
 #include "Game.h"
 #include "Graphics.h"
+#include "Logger.h"
 #include "Platform.h"
 #include "TexturePack.h"
 #include "Utils.h"
@@ -34,27 +35,42 @@ static cc_bool checkNormParts[ATLAS1D_MAX_ATLASES], checkTranParts[ATLAS1D_MAX_A
 
 /* Render info for all chunks in the world. Unsorted. */
 static struct ChunkInfo* mapChunks;
-/* Pointers to render info for all chunks in the world, sorted by distance from the camera. */
+/* Pointers to render info for chunks in the world, sorted by distance from the camera. */
 static struct ChunkInfo** sortedChunks;
 /* Pointers to render info for all chunks in the world, sorted by distance from the camera. */
 /* Only chunks that can be rendered (i.e. not empty and are visible) are included in this.  */
 static struct ChunkInfo** renderChunks;
 /* Number of actually used pointers in the renderChunks array. Entries past this are ignored and skipped. */
 static int renderChunksCount;
+/* Number of chunks in the sortedChunks array that are within unload distance of the camera. */
+/* Entries past this are ignored and skipped, as only these chunks can have meshes. */
+static int activeChunksCount;
 /* Distance of each chunk from the camera. */
 static cc_uint32* distances;
+/* Buckets for sorting chunks by distance from the camera. (see UpdateSortOrder) */
+static int* sortBuckets;
+static int sortBucketsCount;
 /* Maximum number of chunk updates that can be performed in one frame. */
 static int maxChunkUpdates;
+/* Whether to cull chunks that can't be seen from the camera, and whether that needs recalculating. */
+static cc_bool occlusionCulling, occlusionDirty;
+/* Indices of chunks to visit when calculating occlusion, in order of when they were reached. */
+static int* occlusionQueue;
+/* For each chunk, whether visited, face entered through, and directions travelled when calculating occlusion. */
+/* NOTE: This is only non-zero for chunks while occlusion is being calculated. */
+static cc_uint16* occlusionState;
 
 static void ChunkInfo_Reset(struct ChunkInfo* chunk, int x, int y, int z) {
 	chunk->CentreX = x + HALF_CHUNK_SIZE; chunk->CentreY = y + HALF_CHUNK_SIZE; 
 	chunk->CentreZ = z + HALF_CHUNK_SIZE;
 #ifndef CC_BUILD_GL11
-	chunk->Vb = 0;
+	chunk->VbArena = 0; chunk->VbOffset = 0; chunk->VbCount = 0;
 #endif
 
 	chunk->Visible = true;        chunk->Empty = false;
 	chunk->PendingDelete = false; chunk->AllAir = false;
+	chunk->Occluded = false;
+	Mem_Set(chunk->Connects, CHUNK_CONNECTS_ALL, FACE_COUNT);
 	chunk->DrawXMin = false; chunk->DrawXMax = false; chunk->DrawZMin = false;
 	chunk->DrawZMax = false; chunk->DrawYMin = false; chunk->DrawYMax = false;
 
@@ -74,6 +90,236 @@ CC_NOINLINE static int MapRenderer_UsedAtlases(void) {
 }
 
 
+/*########################################################################################################################*
+*-------------------------------------------------Terrain vertex buffers--------------------------------------------------*
+*#########################################################################################################################*/
+#ifndef CC_BUILD_GL11
+/* Rather than each chunk having its own vertex buffer, which the driver has to free and reallocate */
+/*  every time the chunk is rebuilt, the meshes of chunks are sub-allocated from a few large */
+/*  vertex buffers. (arenas) Each arena tracks its free ranges of vertices, sorted by offset. */
+#define VB_ARENA_VERTICES (256 * 1024)
+#define VB_MAX_ARENAS 256
+/* Meshes are allocated in multiples of this many vertices, to reduce fragmentation */
+#define VB_ALIGN_VERTICES 64
+
+struct VbRange { int offset, count; };
+static struct VbArena {
+	GfxResourceID vb;       /* 0 if this arena has been released */
+	int capacity, used;     /* Number of vertices in total/in use by chunk meshes */
+	int allocs;             /* Number of chunk meshes in this arena */
+	struct VbRange* ranges; /* Free ranges of vertices, sorted by offset */
+	int rangesCount, rangesCapacity;
+	cc_bool compacting;     /* Whether this arena's chunks are being rebuilt so it can be released */
+} vbArenas[VB_MAX_ARENAS];
+static int vbArenasCount, vbArenasLive;
+static int vbArenasCreated, vbArenasReleased, vbCompactions;
+
+#define VbArena_Format() (Builder_PackedVertices ? VERTEX_FORMAT_PACKED : VERTEX_FORMAT_TEXTURED)
+
+static void VbArena_InsertRange(struct VbArena* a, int index, int offset, int count) {
+	int i;
+	if (a->rangesCount == a->rangesCapacity) {
+		a->rangesCapacity = max(16, a->rangesCapacity * 2);
+		a->ranges = (struct VbRange*)Mem_Realloc(a->ranges, a->rangesCapacity, sizeof(struct VbRange), "VB arena ranges");
+	}
+
+	for (i = a->rangesCount; i > index; i--) { a->ranges[i] = a->ranges[i - 1]; }
+	a->ranges[index].offset = offset;
+	a->ranges[index].count  = count;
+	a->rangesCount++;
+}
+
+static void VbArena_RemoveRange(struct VbArena* a, int index) {
+	int i;
+	a->rangesCount--;
+	for (i = index; i < a->rangesCount; i++) { a->ranges[i] = a->ranges[i + 1]; }
+}
+
+static cc_bool VbArena_Create(struct VbArena* a, int capacity) {
+	a->vb = Gfx_CreateDynamicVb(VbArena_Format(), capacity);
+	if (!a->vb) return false; /* context lost */
+
+	a->capacity = capacity;
+	a->used     = 0;
+	a->allocs   = 0;
+	a->compacting  = false;
+	a->rangesCount = 0;
+	VbArena_InsertRange(a, 0, 0, capacity);
+
+	vbArenasLive++; vbArenasCreated++;
+	return true;
+}
+
+static void VbArena_Release(struct VbArena* a) {
+	Gfx_DeleteDynamicVb(&a->vb);
+	Mem_Free(a->ranges);
+	a->ranges      = NULL;
+	a->rangesCount = 0; a->rangesCapacity = 0;
+	a->capacity    = 0; a->used = 0; a->allocs = 0;
+	a->compacting  = false;
+
+	vbArenasLive--; vbArenasReleased++;
+}
+
+/* Allocates vertices from the first free range that is large enough */
+/* Returns offset of the allocated vertices, or -1 if there is no large enough free range */
+static int VbArena_Alloc(struct VbArena* a, int count) {
+	struct VbRange* r;
+	int i, offset;
+
+	for (i = 0; i < a->rangesCount; i++) {
+		r = &a->ranges[i];
+		if (r->count < count) continue;
+
+		offset     = r->offset;
+		r->offset += count;
+		r->count  -= count;
+		if (!r->count) VbArena_RemoveRange(a, i);
+
+		a->used += count; a->allocs++;
+		return offset;
+	}
+	return -1;
+}
+
+/* Returns the given vertices to the free ranges, merging with adjacent free ranges */
+static void VbArena_Free(struct VbArena* a, int offset, int count) {
+	struct VbRange* r;
+	int lo = 0, hi = a->rangesCount, mid;
+	a->used -= count; a->allocs--;
+
+	/* Find the first free range after the freed vertices */
+	while (lo < hi) {
+		mid = (lo + hi) >> 1;
+		if (a->ranges[mid].offset < offset) { lo = mid + 1; } else { hi = mid; }
+	}
+
+	r = lo > 0 ? &a->ranges[lo - 1] : NULL;
+	if (r && r->offset + r->count == offset) {
+		r->count += count;
+		/* Freed vertices may also join the previous and next free ranges together */
+		if (lo < a->rangesCount && r->offset + r->count == a->ranges[lo].offset) {
+			r->count += a->ranges[lo].count;
+			VbArena_RemoveRange(a, lo);
+		}
+	} else if (lo < a->rangesCount && offset + count == a->ranges[lo].offset) {
+		a->ranges[lo].offset  = offset;
+		a->ranges[lo].count  += count;
+	} else {
+		VbArena_InsertRange(a, lo, offset, count);
+	}
+}
+
+/* Starts moving all the chunks out of an arena that is mostly unused, so the arena can then be released */
+/* NOTE: Chunks are moved by rebuilding them, as the CPU doesn't keep a copy of their vertices */
+static void VbArena_TryCompact(int index) {
+	struct VbArena* a = &vbArenas[index];
+	struct ChunkInfo* info;
+	int i, available = 0;
+	if (a->compacting || vbArenasLive <= 1 || a->used >= a->capacity / 4) return;
+
+	/* Only worth it when other arenas have plenty of free space to move the chunks into */
+	for (i = 0; i < vbArenasCount; i++) {
+		if (i == index || !vbArenas[i].vb || vbArenas[i].compacting) continue;
+		available += vbArenas[i].capacity - vbArenas[i].used;
+	}
+	if (available < a->used * 2) return;
+
+	a->compacting = true;
+	vbCompactions++;
+
+	/* Only chunks within unload distance of the camera can have meshes */
+	for (i = 0; i < activeChunksCount; i++) {
+		info = sortedChunks[i];
+		if (info->VbCount && info->VbArena == index) info->PendingDelete = true;
+	}
+}
+
+static void FreeChunkVertices(struct ChunkInfo* info) {
+	struct VbArena* a;
+	if (!info->VbCount) return;
+
+	a = &vbArenas[info->VbArena];
+	VbArena_Free(a, info->VbOffset, info->VbCount);
+	info->VbCount = 0;
+
+	if (!a->allocs && (a->compacting || vbArenasLive > 1)) {
+		VbArena_Release(a);
+	} else {
+		VbArena_TryCompact(info->VbArena);
+	}
+}
+
+static void FreeVbArenas(void) {
+	int i;
+	for (i = 0; i < vbArenasCount; i++) {
+		if (vbArenas[i].vb) VbArena_Release(&vbArenas[i]);
+	}
+	vbArenasCount = 0;
+}
+
+void MapRenderer_UploadVertices(struct ChunkInfo* info, void* vertices, int count) {
+	struct VbArena* a = NULL;
+	int i, offset = 0, slot = -1;
+	int size = (count + (VB_ALIGN_VERTICES - 1)) & ~(VB_ALIGN_VERTICES - 1);
+	FreeChunkVertices(info);
+
+	for (i = 0; i < vbArenasCount; i++) {
+		a = &vbArenas[i];
+		if (!a->vb) { if (slot == -1) slot = i; continue; }
+		if (a->compacting) continue;
+
+		offset = VbArena_Alloc(a, size);
+		if (offset >= 0) break;
+	}
+
+	/* No arena has a large enough free range, so create another arena */
+	if (i == vbArenasCount) {
+		if (slot == -1) {
+			if (vbArenasCount == VB_MAX_ARENAS) Logger_Abort("Too many terrain vertex buffers");
+			slot = vbArenasCount++;
+		}
+
+		i = slot; a = &vbArenas[i];
+		/* Chunks full of small blocks can have more vertices than an arena usually has */
+		if (!VbArena_Create(a, max(size, VB_ARENA_VERTICES))) return;
+		offset = VbArena_Alloc(a, size);
+	}
+
+	info->VbArena  = i;
+	info->VbOffset = offset;
+	info->VbCount  = size;
+	Gfx_SetDynamicVbRange(a->vb, VbArena_Format(), offset, vertices, count);
+}
+
+void MapRenderer_GetVbStats(struct TerrainVbStats* stats) {
+	struct VbArena* a;
+	int i, j;
+	Mem_Set(stats, 0, sizeof(struct TerrainVbStats));
+
+	for (i = 0; i < vbArenasCount; i++) {
+		a = &vbArenas[i];
+		if (!a->vb) continue;
+
+		stats->arenas++;
+		stats->allocations += a->allocs;
+		stats->capacity    += a->capacity;
+		stats->used        += a->used;
+		stats->freeRanges  += a->rangesCount;
+
+		for (j = 0; j < a->rangesCount; j++) {
+			stats->largestFree = max(stats->largestFree, (cc_uint32)a->ranges[j].count);
+		}
+	}
+
+	stats->arenasCreated  = vbArenasCreated;
+	stats->arenasReleased = vbArenasReleased;
+	stats->compactions    = vbCompactions;
+	stats->vertexSize     = Builder_PackedVertices ? SIZEOF_VERTEX_PACKED : SIZEOF_VERTEX_TEXTURED;
+}
+#endif
+
+
 /*########################################################################################################################*
 *-------------------------------------------------------Map rendering-----------------------------------------------------*
 *#########################################################################################################################*/
@@ -97,16 +343,111 @@ static void CheckWeather(double delta) {
 #ifdef CC_BUILD_GL11
 #define DrawFace(face, ign)    Gfx_DrawIndexedTris_T2fC4b(part.Vbs[face], 0);
 #define DrawFaces(f1, f2, ign) DrawFace(f1, ign); DrawFace(f2, ign);
+#define SetChunkFaceCulling Gfx_SetFaceCulling
 #else
-#define DrawFace(face, offset)    Gfx_DrawIndexedTris_T2fC4b(part.Counts[face], offset);
-#define DrawFaces(f1, f2, offset) Gfx_DrawIndexedTris_T2fC4b(part.Counts[f1] + part.Counts[f2], offset);
+#define DrawFace(face, offset)    DrawChunkRange(info, part.Counts[face], offset);
+#define DrawFaces(f1, f2, offset) DrawChunkRange(info, part.Counts[f1] + part.Counts[f2], offset);
+
+/* When multi-draw is supported, the draws for all visible chunks in a batch are queued up, */
+/*  then submitted using one draw call per arena and face culling state. (see EndChunkDraws) */
+static cc_bool multiDraw, drawCulled;
+/* Max number of draws queued up per chunk (3 for faces, 4 for sprites) */
+#define CHUNK_MAX_DRAWS 7
+
+/* Range of vertices to draw, and index of previously queued draw with same arena and face culling state */
+static struct ChunkDraw { int start, count, next; } * chunkDraws;
+static int drawsCount, drawsCapacity;
+/* Index of most recently queued draw for each arena and face culling state, or -1 if none */
+static int drawHeads[VB_MAX_ARENAS * 2];
+/* Vertex ranges of the queued draws for one arena and face culling state */
+static int* flushStarts;
+static int* flushCounts;
+
+/* Prepares for drawing the chunks in a batch */
+static void BeginChunkDraws(void) {
+	int capacity = renderChunksCount * CHUNK_MAX_DRAWS;
+	multiDraw = Gfx.MultiDraw && !Builder_PackedVertices;
+	if (!multiDraw) return;
+
+	drawsCount = 0;
+	drawCulled = false;
+	Mem_Set(drawHeads, 0xFF, sizeof(drawHeads));
+	if (capacity <= drawsCapacity) return;
+
+	drawsCapacity = capacity;
+	chunkDraws  = (struct ChunkDraw*)Mem_Realloc(chunkDraws, capacity, sizeof(struct ChunkDraw), "chunk draws");
+	flushStarts = (int*)Mem_Realloc(flushStarts, capacity, sizeof(int), "chunk draw starts");
+	flushCounts = (int*)Mem_Realloc(flushCounts, capacity, sizeof(int), "chunk draw counts");
+}
+
+/* Sets whether face culling is enabled for subsequent draws of chunks */
+static void SetChunkFaceCulling(cc_bool enabled) {
+	if (multiDraw) { drawCulled = enabled; } else { Gfx_SetFaceCulling(enabled); }
+}
+
+static void DrawChunkRange(struct ChunkInfo* info, int count, int offset) {
+	struct ChunkDraw* draw;
+	int key, start;
+	if (!multiDraw) { Gfx_DrawIndexedTris_T2fC4b(count, offset); return; }
+
+	key   = info->VbArena * 2 + drawCulled;
+	start = info->VbOffset + offset;
+
+	/* Draws of a chunk are often adjacent to each other (e.g. sprites), so just extend previous draw */
+	/* NOTE: Draws can't be extended past GFX_MAX_VERTICES, as the index buffer isn't any larger */
+	if (drawHeads[key] >= 0) {
+		draw = &chunkDraws[drawHeads[key]];
+		if (draw->start + draw->count == start && draw->count + count <= GFX_MAX_VERTICES) {
+			draw->count += count; return;
+		}
+	}
+
+	draw = &chunkDraws[drawsCount];
+	draw->start = start;
+	draw->count = count;
+	draw->next  = drawHeads[key];
+	drawHeads[key] = drawsCount++;
+}
+
+/* Submits the draws that were queued up for the chunks in a batch */
+static void EndChunkDraws(void) {
+	struct ChunkDraw* draw;
+	int key, i, count;
+	if (!multiDraw) return;
+
+	for (key = 0; key < vbArenasCount * 2; key++) {
+		count = 0;
+		for (i = drawHeads[key]; i >= 0; i = draw->next) {
+			draw = &chunkDraws[i];
+			flushStarts[count] = draw->start;
+			flushCounts[count] = draw->count;
+			count++;
+		}
+		if (!count) continue;
+
+		Gfx_SetFaceCulling(key & 1);
+		Gfx_BindVb_T2fC4b(vbArenas[key >> 1].vb, 0);
+		Gfx_MultiDrawIndexedTris_T2fC4b(count, flushCounts, flushStarts);
+	}
+	Gfx_SetFaceCulling(false);
+}
+
+static void FreeChunkDraws(void) {
+	Mem_Free(chunkDraws);
+	Mem_Free(flushStarts);
+	Mem_Free(flushCounts);
+	chunkDraws    = NULL;
+	flushStarts   = NULL;
+	flushCounts   = NULL;
+	drawsCapacity = 0;
+}
 #endif
 
 #define DrawNormalFaces(minFace, maxFace) \
 if (drawMin && drawMax) { \
-	Gfx_SetFaceCulling(true); \
+	SetChunkFaceCulling(true); \
 	DrawFaces(minFace, maxFace, offset); \
-	Gfx_SetFaceCulling(false); \
+	SetChunkFaceCulling(false); \
 	Game_Vertices += (part.Counts[minFace] + part.Counts[maxFace]); \
 } else if (drawMin) { \
 	DrawFace(minFace, offset); \
@@ -123,6 +464,9 @@ static void RenderNormalBatch(int batch) {
 	cc_bool drawMin, drawMax;
 	int i, offset, count;
 
+#ifndef CC_BUILD_GL11
+	BeginChunkDraws();
+#endif
 	for (i = 0; i < renderChunksCount; i++) {
 		info = renderChunks[i];
 		if (!info->NormalParts) continue;
@@ -132,7 +476,10 @@ static void RenderNormalBatch(int batch) {
 		hasNormParts[batch] = true;
 
 #ifndef CC_BUILD_GL11
-		Gfx_BindVb_T2fC4b(info->Vb);
+		if (!multiDraw) {
+			if (Builder_PackedVertices) Gfx_SetPackedOrigin(info->CentreX - 8, info->CentreY - 8, info->CentreZ - 8);
+			Gfx_BindVb_T2fC4b(vbArenas[info->VbArena].vb, info->VbOffset);
+		}
 #endif
 
 		offset  = part.Offset + part.SpriteCount;
@@ -154,42 +501,47 @@ static void RenderNormalBatch(int batch) {
 		offset = part.Offset;
 		count  = part.SpriteCount >> 2; /* 4 per sprite */
 
-		Gfx_SetFaceCulling(true);
+		SetChunkFaceCulling(true);
 		/* TODO: fix to not render them all */
 #ifdef CC_BUILD_GL11
 		Gfx_DrawIndexedTris_T2fC4b(part.Vbs[FACE_COUNT], 0);
 		Game_Vertices += count * 4;
-		Gfx_SetFaceCulling(false);
+		SetChunkFaceCulling(false);
 		continue;
-#endif
+#else
 		if (info->DrawXMax || info->DrawZMin) {
-			Gfx_DrawIndexedTris_T2fC4b(count, offset); Game_Vertices += count;
+			DrawChunkRange(info, count, offset); Game_Vertices += count;
 		} offset += count;
 
 		if (info->DrawXMin || info->DrawZMax) {
-			Gfx_DrawIndexedTris_T2fC4b(count, offset); Game_Vertices += count;
+			DrawChunkRange(info, count, offset); Game_Vertices += count;
 		} offset += count;
 
 		if (info->DrawXMin || info->DrawZMin) {
-			Gfx_DrawIndexedTris_T2fC4b(count, offset); Game_Vertices += count;
+			DrawChunkRange(info, count, offset); Game_Vertices += count;
 		} offset += count;
 
 		if (info->DrawXMax || info->DrawZMax) {
-			Gfx_DrawIndexedTris_T2fC4b(count, offset); Game_Vertices += count;
+			DrawChunkRange(info, count, offset); Game_Vertices += count;
 		}
-		Gfx_SetFaceCulling(false);
+		SetChunkFaceCulling(false);
+#endif
 	}
+#ifndef CC_BUILD_GL11
+	EndChunkDraws();
+#endif
 }
 
 void MapRenderer_RenderNormal(double delta) {
 	int batch;
 	if (!mapChunks) return;
 
-	Gfx_SetVertexFormat(VERTEX_FORMAT_TEXTURED);
+	Gfx_SetVertexFormat(Builder_PackedVertices ? VERTEX_FORMAT_PACKED : VERTEX_FORMAT_TEXTURED);
 	Gfx_SetTexturing(true);
 	Gfx_SetAlphaTest(true);
 	
 	Gfx_EnableMipmaps();
+	if (Builder_TileRepeat) Gfx_EnableTileRepeat(Atlas1D.InvTileSize);
 	for (batch = 0; batch < MapRenderer_1DUsedCount; batch++) {
 		if (normPartsCount[batch] <= 0) continue;
 		if (hasNormParts[batch] || checkNormParts[batch]) {
@@ -198,14 +550,12 @@ void MapRenderer_RenderNormal(double delta) {
 			checkNormParts[batch] = false;
 		}
 	}
+	if (Builder_TileRepeat) Gfx_DisableTileRepeat();
 	Gfx_DisableMipmaps();
 
 	CheckWeather(delta);
 	Gfx_SetAlphaTest(false);
 	Gfx_SetTexturing(false);
-#if DEBUG_OCCLUSION
-	DebugPickedPos();
-#endif
 }
 
 #define DrawTranslucentFaces(minFace, maxFace) \
@@ -227,6 +577,9 @@ static void RenderTranslucentBatch(int batch) {
 	cc_bool drawMin, drawMax;
 	int i, offset;
 
+#ifndef CC_BUILD_GL11
+	BeginChunkDraws();
+#endif
 	for (i = 0; i < renderChunksCount; i++) {
 		info = renderChunks[i];
 		if (!info->TranslucentParts) continue;
@@ -236,7 +589,10 @@ static void RenderTranslucentBatch(int batch) {
 		hasTranParts[batch] = true;
 
 #ifndef CC_BUILD_GL11
-		Gfx_BindVb_T2fC4b(info->Vb);
+		if (!multiDraw) {
+			if (Builder_PackedVertices) Gfx_SetPackedOrigin(info->CentreX - 8, info->CentreY - 8, info->CentreZ - 8);
+			Gfx_BindVb_T2fC4b(vbArenas[info->VbArena].vb, info->VbOffset);
+		}
 #endif
 
 		offset  = part.Offset;
@@ -254,6 +610,9 @@ static void RenderTranslucentBatch(int batch) {
 		drawMax = (inTranslucent || info->DrawYMax) && part.Counts[FACE_YMAX];
 		DrawTranslucentFaces(FACE_YMIN, FACE_YMAX);
 	}
+#ifndef CC_BUILD_GL11
+	EndChunkDraws();
+#endif
 }
 
 void MapRenderer_RenderTranslucent(double delta) {
@@ -262,7 +621,7 @@ void MapRenderer_RenderTranslucent(double delta) {
 
 	/* First fill depth buffer */
 	vertices = Game_Vertices;
-	Gfx_SetVertexFormat(VERTEX_FORMAT_TEXTURED);
+	Gfx_SetVertexFormat(Builder_PackedVertices ? VERTEX_FORMAT_PACKED : VERTEX_FORMAT_TEXTURED);
 	Gfx_SetTexturing(false);
 	Gfx_SetAlphaBlending(false);
 	Gfx_SetColWriteMask(false, false, false, false);
@@ -283,12 +642,14 @@ void MapRenderer_RenderTranslucent(double delta) {
 	Gfx_SetDepthWrite(false); /* already calculated depth values in depth pass */
 
 	Gfx_EnableMipmaps();
+	if (Builder_TileRepeat) Gfx_EnableTileRepeat(Atlas1D.InvTileSize);
 	for (batch = 0; batch < MapRenderer_1DUsedCount; batch++) {
 		if (tranPartsCount[batch] <= 0) continue;
 		if (!hasTranParts[batch]) continue;
 		Gfx_BindTexture(Atlas1D.TexIds[batch]);
 		RenderTranslucentBatch(batch);
 	}
+	if (Builder_TileRepeat) Gfx_DisableTileRepeat();
 	Gfx_DisableMipmaps();
 
 	Gfx_SetDepthWrite(true);
@@ -313,14 +674,10 @@ static void DeleteChunk(struct ChunkInfo* info) {
 #ifdef CC_BUILD_GL11
 	int j;
 #else
-	Gfx_DeleteVb(&info->Vb);
+	FreeChunkVertices(info);
 #endif
 
 	info->Empty = false; info->AllAir = false;
-#ifdef OCCLUSION
-	info.OcclusionFlags = 0;
-	info.OccludedFlags = 0;
-#endif
 
 	if (info->NormalParts) {
 		ptr = info->NormalParts;
@@ -347,15 +704,22 @@ static void DeleteChunk(struct ChunkInfo* info) {
 	}
 }
 
-/* Builds the mesh (hence vertex buffer) for the given chunk, and updates internal state */
-static void BuildChunk(struct ChunkInfo* info, int* chunkUpdates) {
-	struct ChunkPartInfo* ptr;
-	int i;
+/* Chunks that will have their meshes built at the end of this frame's chunks update */
+static struct ChunkInfo* buildQueue[BUILDER_MAX_CHUNKS];
+static int buildQueueCount;
 
+/* Queues the mesh (hence vertex buffer) for the given chunk to be built, and updates internal state */
+static void BuildChunk(struct ChunkInfo* info, int* chunkUpdates) {
 	Game.ChunkUpdates++;
 	(*chunkUpdates)++;
 	info->PendingDelete = false;
-	Builder_MakeChunk(info);
+	buildQueue[buildQueueCount++] = info;
+}
+
+/* Updates internal state after the mesh of the given chunk has been built */
+static void OnChunkBuilt(struct ChunkInfo* info) {
+	struct ChunkPartInfo* ptr;
+	int i;
 
 	if (!info->NormalParts && !info->TranslucentParts) {
 		info->Empty = true; return;
@@ -376,6 +740,63 @@ static void BuildChunk(struct ChunkInfo* info, int* chunkUpdates) {
 	}
 }
 
+/* Builds the meshes of all the queued chunks in parallel */
+static void BuildQueuedChunks(void) {
+	/* Chunks which are built may now have different connectivity */
+	if (buildQueueCount) occlusionDirty = true;
+	Builder_MakeChunks(buildQueue, buildQueueCount, OnChunkBuilt);
+	buildQueueCount = 0;
+}
+
+
+/*########################################################################################################################*
+*------------------------------------------------------Chunk regions------------------------------------------------------*
+*#########################################################################################################################*/
+/* Chunks are grouped into regions of 8x8x8 chunks, so that all the chunks in a region which is */
+/*  outside the frustum can be rejected at once, instead of testing each chunk against the frustum. */
+#define REGION_SHIFT (CHUNK_SHIFT + 3)
+#define REGION_SIZE (1 << REGION_SHIFT)
+static int regionsX, regionsY, regionsZ;
+/* Frame that each region was last tested against the frustum in */
+static cc_uint32* regionFrames;
+/* Whether each region was in the frustum when it was last tested */
+static cc_bool* regionVisible;
+/* Incremented whenever the frustum may have changed */
+static cc_uint32 frustumFrame = 1;
+
+static void AllocateRegions(void) {
+	int count;
+	regionsX = (World.Width  + (REGION_SIZE - 1)) >> REGION_SHIFT;
+	regionsY = (World.Height + (REGION_SIZE - 1)) >> REGION_SHIFT;
+	regionsZ = (World.Length + (REGION_SIZE - 1)) >> REGION_SHIFT;
+
+	count = regionsX * regionsY * regionsZ;
+	regionFrames  = (cc_uint32*)Mem_AllocCleared(count, sizeof(cc_uint32), "region frames");
+	regionVisible = (cc_bool*)Mem_AllocCleared(count,   sizeof(cc_bool),   "region visibility");
+}
+
+static void FreeRegions(void) {
+	Mem_Free(regionFrames);
+	Mem_Free(regionVisible);
+	regionFrames  = NULL;
+	regionVisible = NULL;
+}
+
+/* Returns whether the given chunk is inside the frustum */
+static cc_bool ChunkInFrustum(struct ChunkInfo* info) {
+	int rx = info->CentreX >> REGION_SHIFT, ry = info->CentreY >> REGION_SHIFT, rz = info->CentreZ >> REGION_SHIFT;
+	int index = (rz * regionsY + ry) * regionsX + rx;
+
+	if (regionFrames[index] != frustumFrame) {
+		regionFrames[index]  = frustumFrame;
+		regionVisible[index] = FrustumCulling_SphereInFrustum(
+			(rx << REGION_SHIFT) + REGION_SIZE / 2, (ry << REGION_SHIFT) + REGION_SIZE / 2, 
+			(rz << REGION_SHIFT) + REGION_SIZE / 2, 111); /* 111 ~ sqrt(3 * 64^2) */
+	}
+	return regionVisible[index] &&
+		FrustumCulling_SphereInFrustum(info->CentreX, info->CentreY, info->CentreZ, 14); /* 14 ~ sqrt(3 * 8^2) */
+}
+
 
 /*########################################################################################################################*
 *----------------------------------------------------Chunks mangagement---------------------------------------------------*
@@ -391,11 +812,21 @@ static void FreeChunks(void) {
 	Mem_Free(sortedChunks);
 	Mem_Free(renderChunks);
 	Mem_Free(distances);
+	Mem_Free(occlusionQueue);
+	Mem_Free(occlusionState);
+	Mem_Free(sortBuckets);
 
 	mapChunks    = NULL;
 	sortedChunks = NULL;
 	renderChunks = NULL;
 	distances    = NULL;
+	occlusionQueue = NULL;
+	occlusionState = NULL;
+	sortBuckets    = NULL;
+	FreeRegions();
+#ifndef CC_BUILD_GL11
+	FreeChunkDraws();
+#endif
 }
 
 static void AllocateParts(void) {
@@ -412,6 +843,14 @@ static void AllocateChunks(void) {
 	sortedChunks = (struct ChunkInfo**)Mem_Alloc(MapRenderer_ChunksCount, sizeof(struct ChunkInfo*), "sorted chunk info");
 	renderChunks = (struct ChunkInfo**)Mem_Alloc(MapRenderer_ChunksCount, sizeof(struct ChunkInfo*), "render chunk info");
 	distances    = (cc_uint32*)Mem_Alloc(MapRenderer_ChunksCount, 4, "chunk distances");
+	occlusionQueue = (int*)Mem_Alloc(MapRenderer_ChunksCount, sizeof(int), "occlusion queue");
+	occlusionState = (cc_uint16*)Mem_AllocCleared(MapRenderer_ChunksCount, sizeof(cc_uint16), "occlusion state");
+
+	/* Enough buckets for every possible distance between two chunks in the map */
+	sortBucketsCount = (MapRenderer_ChunksX - 1) * (MapRenderer_ChunksX - 1) + (MapRenderer_ChunksY - 1) * (MapRenderer_ChunksY - 1)
+		+ (MapRenderer_ChunksZ - 1) * (MapRenderer_ChunksZ - 1) + 1;
+	sortBuckets = (int*)Mem_Alloc(sortBucketsCount, sizeof(int), "chunk sort buckets");
+	AllocateRegions();
 }
 
 static void ResetPartFlags(void) {
@@ -445,6 +884,7 @@ static void InitChunks(void) {
 			}
 		}
 	}
+	activeChunksCount = 0;
 }
 
 static void ResetChunks(void) {
@@ -467,6 +907,10 @@ static void DeleteChunks(void) {
 		DeleteChunk(&mapChunks[i]);
 	}
 	ResetPartCounts();
+#ifndef CC_BUILD_GL11
+	/* Every arena is empty at this point anyways */
+	FreeVbArenas();
+#endif
 }
 
 void MapRenderer_Refresh(void) {
@@ -510,6 +954,86 @@ static void RefreshBorderChunks(int maxHeight) {
 }
 
 
+/*########################################################################################################################*
+*----------------------------------------------------Occlusion culling----------------------------------------------------*
+*#########################################################################################################################*/
+/* Chunks are only visible if they can be reached by flood filling outwards from the camera's chunk, */
+/*  where each chunk is left through a face that can be seen from the face it was entered through. */
+/* To avoid going around corners back towards the camera, the flood fill never travels in the */
+/*  opposite direction to any direction that was already travelled to reach a chunk. */
+#define OCCLUSION_VISITED 0x8000
+#define OCCLUSION_NO_FACE 7
+static const IVec3 occlusionDirs[FACE_COUNT] = { {-1,0,0}, {1,0,0}, {0,0,-1}, {0,0,1}, {0,-1,0}, {0,1,0} };
+
+static void ClearOcclusion(void) {
+	int i;
+	for (i = 0; i < activeChunksCount; i++) { sortedChunks[i]->Occluded = false; }
+}
+
+static void CalcOcclusion(int maxDistSqr) {
+	struct ChunkInfo* info;
+	struct ChunkInfo* other;
+	int head = 0, tail = 0;
+	int index, next, state, entry, dirs, face;
+	int cx, cy, cz, dx, dy, dz;
+
+	occlusionDirty = false;
+	if (!occlusionCulling || chunkPos.X < 0 || chunkPos.Z < 0 
+		|| chunkPos.X >= World.Width || chunkPos.Z >= World.Length) { ClearOcclusion(); return; }
+
+	/* When above or below the map, start from the nearest chunk instead */
+	cx = chunkPos.X >> CHUNK_SHIFT; cz = chunkPos.Z >> CHUNK_SHIFT;
+	cy = chunkPos.Y < 0 ? 0 : min(chunkPos.Y >> CHUNK_SHIFT, MapRenderer_ChunksY - 1);
+
+	index = MapRenderer_Pack(cx, cy, cz);
+	occlusionState[index]   = OCCLUSION_VISITED | (OCCLUSION_NO_FACE << 8);
+	occlusionQueue[tail++] = index;
+
+	while (head < tail) {
+		index = occlusionQueue[head++];
+		info  = &mapChunks[index];
+		state = occlusionState[index];
+		entry = (state >> 8) & 0x07;
+		dirs  = state & CHUNK_CONNECTS_ALL;
+
+		for (face = 0; face < FACE_COUNT; face++) {
+			/* Never travel back towards the camera */
+			if (dirs & (1 << (face ^ 1))) continue;
+			if (entry != OCCLUSION_NO_FACE && !(info->Connects[entry] & (1 << face))) continue;
+
+			cx = (info->CentreX >> CHUNK_SHIFT) + occlusionDirs[face].X;
+			cy = (info->CentreY >> CHUNK_SHIFT) + occlusionDirs[face].Y;
+			cz = (info->CentreZ >> CHUNK_SHIFT) + occlusionDirs[face].Z;
+			if (cx < 0 || cy < 0 || cz < 0 || cx >= MapRenderer_ChunksX
+				|| cy >= MapRenderer_ChunksY || cz >= MapRenderer_ChunksZ) continue;
+
+			next = MapRenderer_Pack(cx, cy, cz);
+			if (occlusionState[next]) continue;
+			other = &mapChunks[next];
+
+			dx = other->CentreX - chunkPos.X; dy = other->CentreY - chunkPos.Y; dz = other->CentreZ - chunkPos.Z;
+			if (dx * dx + dy * dy + dz * dz > maxDistSqr) continue;
+			if (!ChunkInFrustum(other)) continue;
+
+			/* Face of the neighbour chunk that it is entered through is the opposite face */
+			occlusionState[next]   = OCCLUSION_VISITED | ((face ^ 1) << 8) | dirs | (1 << face);
+			occlusionQueue[tail++] = next;
+		}
+	}
+
+	for (index = 0; index < activeChunksCount; index++) {
+		sortedChunks[index]->Occluded = true;
+	}
+
+	/* Reset state of only the visited chunks, so the cost doesn't depend on the size of the map */
+	for (index = 0; index < tail; index++) {
+		next = occlusionQueue[index];
+		mapChunks[next].Occluded = false;
+		occlusionState[next]     = 0;
+	}
+}
+
+
 /*########################################################################################################################*
 *--------------------------------------------------Chunks updating/sorting------------------------------------------------*
 *#########################################################################################################################*/
@@ -521,8 +1045,9 @@ static float lastYaw, lastPitch;
 /* This may differ from the view distance configured by the user */
 static int renderDistSquared;
 /* Max distance from camera that chunks are built within */
-/* Chunks past this distance are automatically unloaded */
 static int buildDistSquared;
+/* Chunks past this distance from the camera are automatically unloaded */
+#define UNLOAD_DIST_SQUARED (buildDistSquared + 32 * 16)
 
 static int AdjustDist(int dist) {
 	if (dist < CHUNK_SIZE) dist = CHUNK_SIZE;
@@ -543,17 +1068,12 @@ static int UpdateChunksAndVisibility(int* chunkUpdates) {
 	int i, j = 0, distSqr;
 	cc_bool noData;
 
-	for (i = 0; i < MapRenderer_ChunksCount; i++) {
+	for (i = 0; i < activeChunksCount; i++) {
 		info = sortedChunks[i];
 		if (info->Empty) continue;
 
 		distSqr = distances[i];
 		noData  = !info->NormalParts && !info->TranslucentParts;
-		
-		/* Auto unload chunks far away chunks */
-		if (!noData && distSqr >= buildDistSqr + 32 * 16) {
-			DeleteChunk(info); continue;
-		}
 		noData |= info->PendingDelete;
 
 		if (noData && distSqr <= buildDistSqr && *chunkUpdates < chunksTarget) {
@@ -561,8 +1081,7 @@ static int UpdateChunksAndVisibility(int* chunkUpdates) {
 			BuildChunk(info, chunkUpdates);
 		}
 
-		info->Visible = distSqr <= renderDistSqr &&
-			FrustumCulling_SphereInFrustum(info->CentreX, info->CentreY, info->CentreZ, 14); /* 14 ~ sqrt(3 * 8^2) */
+		info->Visible = distSqr <= renderDistSqr && !info->Occluded && ChunkInFrustum(info);
 		if (info->Visible && !info->Empty) { renderChunks[j] = info; j++; }
 	}
 	return j;
@@ -576,17 +1095,12 @@ static int UpdateChunksStill(int* chunkUpdates) {
 	int i, j = 0, distSqr;
 	cc_bool noData;
 
-	for (i = 0; i < MapRenderer_ChunksCount; i++) {
+	for (i = 0; i < activeChunksCount; i++) {
 		info = sortedChunks[i];
 		if (info->Empty) continue;
 
 		distSqr = distances[i];
 		noData  = !info->NormalParts && !info->TranslucentParts;
-
-		/* Auto unload chunks far away chunks */
-		if (!noData && distSqr >= buildDistSqr + 32 * 16) {
-			DeleteChunk(info); continue;
-		}
 		noData |= info->PendingDelete;
 
 		if (noData && distSqr <= buildDistSqr && *chunkUpdates < chunksTarget) {
@@ -594,8 +1108,7 @@ static int UpdateChunksStill(int* chunkUpdates) {
 			BuildChunk(info, chunkUpdates);
 
 			/* only need to update the visibility of chunks in range. */
-			info->Visible = distSqr <= renderDistSqr &&
-				FrustumCulling_SphereInFrustum(info->CentreX, info->CentreY, info->CentreZ, 14); /* 14 ~ sqrt(3 * 8^2) */
+			info->Visible = distSqr <= renderDistSqr && !info->Occluded && ChunkInFrustum(info);
 			if (info->Visible && !info->Empty) { renderChunks[j] = info; j++; }
 		} else if (info->Visible) {
 			renderChunks[j] = info; j++;
@@ -617,9 +1130,18 @@ static void UpdateChunks(double delta) {
 	samePos = Vec3_Equals(&Camera.CurrentPos, &lastCamPos)
 		&& p->Base.Pitch == lastPitch && p->Base.Yaw == lastYaw;
 
+	/* Connectivity of chunks built last frame may have changed what chunks are occluded */
+	if (!samePos || occlusionDirty) {
+		frustumFrame++;
+		CalcOcclusion(renderDistSquared);
+		samePos = false;
+	}
+
 	renderChunksCount = samePos ?
 		UpdateChunksStill(&chunkUpdates) :
 		UpdateChunksAndVisibility(&chunkUpdates);
+	/* Chunks which turn out to be empty are skipped over when rendering */
+	BuildQueuedChunks();
 
 	lastCamPos = Camera.CurrentPos;
 	lastPitch  = p->Base.Pitch;
@@ -628,29 +1150,41 @@ static void UpdateChunks(double delta) {
 	if (!samePos || chunkUpdates) ResetPartFlags();
 }
 
-static void SortMapChunks(int left, int right) {
-	struct ChunkInfo** values = sortedChunks; struct ChunkInfo* value;
-	cc_uint32* keys = distances; cc_uint32 key;
-
-	while (left < right) {
-		int i = left, j = right;
-		cc_uint32 pivot = keys[(i + j) >> 1];
+/* Calculates squared distance from the centre of the given chunk to the centre of the camera's chunk */
+static cc_uint32 ChunkDistance(struct ChunkInfo* info, IVec3 pos) {
+	int dx = info->CentreX - pos.X, dy = info->CentreY - pos.Y, dz = info->CentreZ - pos.Z;
+	return dx * dx + dy * dy + dz * dz;
+}
 
-		/* partition the list */
-		while (i <= j) {
-			while (pivot > keys[i]) i++;
-			while (pivot < keys[j]) j--;
-			QuickSort_Swap_KV_Maybe();
-		}
-		/* recurse into the smaller subset */
-		QuickSort_Recurse(SortMapChunks)
-	}
+/* Calculates which faces of the given chunk can face towards the camera's chunk */
+static void CalcDrawFaces(struct ChunkInfo* info, IVec3 pos) {
+	int dx = info->CentreX - pos.X, dy = info->CentreY - pos.Y, dz = info->CentreZ - pos.Z;
+
+	/* Consider these 3 chunks: */
+	/* |       X-1      |        X        |       X+1      | */
+	/* |################|########@########|################| */
+	/* Assume the player is standing at @, then DrawXMin/XMax is calculated as this */
+	/*    X-1: DrawXMin = false, DrawXMax = true  */
+	/*    X  : DrawXMin = true,  DrawXMax = true  */
+	/*    X+1: DrawXMin = true,  DrawXMax = false */
+
+	info->DrawXMin = dx >= 0; info->DrawXMax = dx <= 0;
+	info->DrawZMin = dz >= 0; info->DrawZMax = dz <= 0;
+	info->DrawYMin = dy >= 0; info->DrawYMax = dy <= 0;
 }
 
+/* Only chunks within unload distance of the camera are sorted, so the cost of sorting depends on */
+/*  the view distance and not the size of the map. Chunks are sorted using a counting sort, instead */
+/*  of a comparison sort. Since chunk centres are CHUNK_SIZE apart, squared distances are multiples */
+/*  of CHUNK_SIZE_2, so (distance / CHUNK_SIZE_2) has few enough distinct values (at most */
+/*  sortBucketsCount) that sorting only takes linear time. */
 static void UpdateSortOrder(void) {
 	struct ChunkInfo* info;
+	cc_uint32 dist, key, minKey, maxKey, maxDist;
+	int i, index, shift, total, count, radius;
+	int x, y, z, cx, cy, cz;
+	int minX, minY, minZ, maxX, maxY, maxZ;
 	IVec3 pos;
-	int i, dx, dy, dz;
 
 	/* pos is centre coordinate of chunk camera is in */
 	IVec3_Floor(&pos, &Camera.CurrentPos);
@@ -662,29 +1196,68 @@ static void UpdateSortOrder(void) {
 	if (pos.X == chunkPos.X && pos.Y == chunkPos.Y && pos.Z == chunkPos.Z) return;
 	chunkPos = pos;
 	if (!MapRenderer_ChunksCount) return;
+	maxDist = UNLOAD_DIST_SQUARED;
 
-	for (i = 0; i < MapRenderer_ChunksCount; i++) {
+	/* Only chunks that were previously within unload distance can have meshes */
+	for (i = 0; i < activeChunksCount; i++) {
 		info = sortedChunks[i];
-		/* Calculate distance to chunk centre */
-		dx = info->CentreX - pos.X; dy = info->CentreY - pos.Y; dz = info->CentreZ - pos.Z;
-		distances[i] = dx * dx + dy * dy + dz * dz;
+		if (ChunkDistance(info, pos) < maxDist) continue;
+		if (info->NormalParts || info->TranslucentParts) DeleteChunk(info);
+	}
 
-		/* Consider these 3 chunks: */
-		/* |       X-1      |        X        |       X+1      | */
-		/* |################|########@########|################| */
-		/* Assume the player is standing at @, then DrawXMin/XMax is calculated as this */
-		/*    X-1: DrawXMin = false, DrawXMax = true  */
-		/*    X  : DrawXMin = true,  DrawXMax = true  */
-		/*    X+1: DrawXMin = true,  DrawXMax = false */
+	/* Bounds of the chunks that can be within unload distance */
+	radius = (int)Math_SqrtF((float)maxDist) / CHUNK_SIZE + 1;
+	cx = (pos.X - HALF_CHUNK_SIZE) / CHUNK_SIZE; minX = max(0, cx - radius); maxX = min(MapRenderer_ChunksX - 1, cx + radius);
+	cy = (pos.Y - HALF_CHUNK_SIZE) / CHUNK_SIZE; minY = max(0, cy - radius); maxY = min(MapRenderer_ChunksY - 1, cy + radius);
+	cz = (pos.Z - HALF_CHUNK_SIZE) / CHUNK_SIZE; minZ = max(0, cz - radius); maxZ = min(MapRenderer_ChunksZ - 1, cz + radius);
+
+	/* renderChunks is always recalculated after sorting, so use it to temporarily store the chunks to sort */
+	minKey = Int32_MaxValue; maxKey = 0; count = 0;
+	for (z = minZ; z <= maxZ; z++) {
+		for (y = minY; y <= maxY; y++) {
+			for (x = minX; x <= maxX; x++) {
+				info = &mapChunks[MapRenderer_Pack(x, y, z)];
+				dist = ChunkDistance(info, pos);
+				if (dist >= maxDist) continue;
+
+				CalcDrawFaces(info, pos);
+				renderChunks[count++] = info;
+				key    = dist / CHUNK_SIZE_2;
+				minKey = min(minKey, key);
+				maxKey = max(maxKey, key);
+			}
+		}
+	}
+	activeChunksCount = count;
+	renderChunksCount = 0;
+	if (!count) return;
+
+	/* When the camera is far outside the map, the range of keys can exceed the number of buckets */
+	/* (in which case chunks are only approximately sorted, as keys have to be made coarser) */
+	for (shift = 0; ((maxKey - minKey) >> shift) >= (cc_uint32)sortBucketsCount; shift++) { }
+	count = ((maxKey - minKey) >> shift) + 1;
+	Mem_Set(sortBuckets, 0, count * sizeof(int));
+
+	for (i = 0; i < activeChunksCount; i++) {
+		key = ChunkDistance(renderChunks[i], pos) / CHUNK_SIZE_2;
+		sortBuckets[(key - minKey) >> shift]++;
+	}
 
-		info->DrawXMin = dx >= 0; info->DrawXMax = dx <= 0;
-		info->DrawZMin = dz >= 0; info->DrawZMax = dz <= 0;
-		info->DrawYMin = dy >= 0; info->DrawYMax = dy <= 0;
+	/* Convert counts into index of first chunk in each bucket */
+	for (i = 0, total = 0; i < count; i++) {
+		total += sortBuckets[i];
+		sortBuckets[i] = total - sortBuckets[i];
 	}
 
-	SortMapChunks(0, MapRenderer_ChunksCount - 1);
+	for (i = 0; i < activeChunksCount; i++) {
+		info  = renderChunks[i];
+		dist  = ChunkDistance(info, pos);
+		index = sortBuckets[(dist / CHUNK_SIZE_2 - minKey) >> shift]++;
+
+		sortedChunks[index] = info;
+		distances[index]    = dist;
+	}
 	ResetPartFlags();
-	/*SimpleOcclusionCulling();*/
 }
 
 void MapRenderer_Update(double delta) {
@@ -752,6 +1325,8 @@ static void OnBlockDefinitionChanged(void* obj) {
 static void OnVisibilityChanged(void* obj) {
 	lastCamPos = Vec3_BigPos();
 	CalcViewDists();
+	/* Unload distance may have changed, so need to recalculate which chunks are sorted */
+	chunkPos   = IVec3_MaxValue();
 }
 static void DeleteChunks_(void* obj) { DeleteChunks(); }
 static void Refresh_(void* obj)      { MapRenderer_Refresh(); }
@@ -799,7 +1374,8 @@ static void OnInit(void) {
 	/* This = 87 fixes map being invisible when no textures */
 	MapRenderer_1DUsedCount = 87; /* Atlas1D_UsedAtlasesCount(); */
 	chunkPos   = IVec3_MaxValue();
-	maxChunkUpdates = Options_GetInt(OPT_MAX_CHUNK_UPDATES, 4, 1024, 30);
+	maxChunkUpdates = Options_GetInt(OPT_MAX_CHUNK_UPDATES, 4, BUILDER_MAX_CHUNKS, 30);
+	occlusionCulling = Options_GetBool(OPT_OCCLUSION_CULLING, true);
 	CalcViewDists();
 }
 
@@ -5,6 +5,8 @@
 /* Renders the blocks of the world by subdividing it into chunks.
    Also manages the process of building/deleting chunk meshes.
    Also sorts chunks so nearest chunks are rendered first, and calculates chunk visibility.
+   Also culls chunks that are occluded by other chunks. (e.g. caves underneath the player)
+   Also sub-allocates the vertices of chunk meshes from a few large vertex buffers.
    Copyright 2014-2021 ClassiCube | Licensed under BSD-3
 */
 struct IGameComponent;
@@ -36,6 +38,9 @@ struct ChunkPartInfo {
 	cc_uint16 Counts[FACE_COUNT]; /* Counts per face */
 };
 
+/* Bitmask of all faces, for ChunkInfo.Connects */
+#define CHUNK_CONNECTS_ALL 0x3F
+
 /* Describes data necessary for rendering a chunk. */
 struct ChunkInfo {	
 	cc_uint16 CentreX, CentreY, CentreZ; /* Centre coordinates of the chunk */
@@ -44,6 +49,7 @@ struct ChunkInfo {
 	cc_uint8 Empty : 1;         /* Whether the chunk is empty of data */
 	cc_uint8 PendingDelete : 1; /* Whether chunk is pending deletion */
 	cc_uint8 AllAir : 1;        /* Whether chunk is completely air */
+	cc_uint8 Occluded : 1;      /* Whether chunk can't be seen from the camera's chunk */
 	cc_uint8 : 0;               /* pad to next byte*/
 
 	cc_uint8 DrawXMin : 1;
@@ -53,12 +59,12 @@ struct ChunkInfo {
 	cc_uint8 DrawYMin : 1;
 	cc_uint8 DrawYMax : 1;
 	cc_uint8 : 0;          /* pad to next byte */
-#ifdef OCCLUSION
-	public cc_bool Visited = false, Occluded = false;
-	public byte OcclusionFlags, OccludedFlags, DistanceFlags;
-#endif
+	/* For each face of the chunk, bitmask of the faces that can be seen from that face through the chunk. */
+	/* (calculated when the chunk's mesh is built, and used for occlusion culling) */
+	cc_uint8 Connects[FACE_COUNT];
 #ifndef CC_BUILD_GL11
-	GfxResourceID Vb;
+	cc_uint16 VbArena;     /* Index of the terrain vertex buffer this chunk's vertices are in */
+	int VbOffset, VbCount; /* Range of vertices in that buffer (VbCount is 0 when no vertices) */
 #endif
 	struct ChunkPartInfo* NormalParts;
 	struct ChunkPartInfo* TranslucentParts;
@@ -80,4 +86,26 @@ void MapRenderer_RefreshChunk(int cx, int cy, int cz);
 void MapRenderer_OnBlockChanged(int x, int y, int z, BlockID block);
 /* Deletes all chunks and resets internal state. */
 void MapRenderer_Refresh(void);
+
+#ifndef CC_BUILD_GL11
+/* Sub-allocates space in the terrain vertex buffers for the vertices of the given chunk, then copies them into it. */
+/* NOTE: Vertices must be in VERTEX_FORMAT_PACKED when Builder_PackedVertices, otherwise VERTEX_FORMAT_TEXTURED */
+void MapRenderer_UploadVertices(struct ChunkInfo* info, void* vertices, int count);
+
+/* Statistics about the terrain vertex buffers that chunk meshes are sub-allocated from. */
+struct TerrainVbStats {
+	int arenas;             /* Number of vertex buffers currently allocated */
+	int allocations;        /* Number of chunk meshes currently in the vertex buffers */
+	cc_uint32 capacity;     /* Total size of the vertex buffers, in vertices */
+	cc_uint32 used;         /* Number of vertices used by chunk meshes */
+	int freeRanges;         /* Number of separate ranges of unused vertices */
+	cc_uint32 largestFree;  /* Size of the largest range of unused vertices */
+	int arenasCreated;      /* Number of vertex buffers created since the game started */
+	int arenasReleased;     /* Number of vertex buffers released since the game started */
+	int compactions;        /* Number of times a sparsely used vertex buffer was emptied by rebuilding its chunks */
+	int vertexSize;         /* Size of each vertex, in bytes */
+};
+/* Retrieves statistics about the terrain vertex buffers. */
+void MapRenderer_GetVbStats(struct TerrainVbStats* stats);
+#endif
 #endif
@@ -31,6 +31,7 @@
 #include "Options.h"
 #include "Input.h"
 #include "Utils.h"
+#include "Errors.h"
 
 /* Describes a menu option button */
 struct MenuOptionDesc {
@@ -1356,50 +1357,189 @@ static void DownloadMap(const cc_string* path) {
 }
 #endif
 
-static void SaveLevelScreen_SaveMap(struct SaveLevelScreen* s, const cc_string* path) {
-	static const cc_string cw = String_FromConst(".cw");
-	struct Stream stream, compStream;
-	struct GZipState state;
+/* The map is first encoded into an uncompressed snapshot in memory, which is then compressed and */
+/*  written to disc on a separate thread. This way the game doesn't freeze when saving large maps. */
+/* The file is written to a temp file first, which then replaces the actual file once complete. */
+#define MAP_SAVE_CHUNK_SIZE (64 * 1024)
+/* Upper limit on size of everything besides the blocks arrays (e.g. block definitions) */
+#define MAP_SAVE_EXTRA_SIZE (512 * 1024)
+
+static struct MapSaveState {
+	void* thread;      /* NOTE: NULL on platforms where Thread_Start runs the function immediately */
+	cc_uint8* data; /* Snapshot of the encoded map, non NULL while a save is in progress */
+	cc_uint32 size;
+	cc_bool ccr;       /* Whether data is just the metadata, and blocks were copied by Ccr_BeginSave */
+	cc_bool background; /* Whether save was started outside the menu, so is finished by MapSave_Tick */
+	const char* place; /* What was being done when an error occurred */
+	cc_result res;
+	volatile float progress;
+	volatile cc_bool done;
+	int lastPercent;
+	cc_string path;    char pathBuffer[FILENAME_SIZE];
+	cc_string tmpPath; char tmpBuffer[FILENAME_SIZE + 4];
+} map_save;
+static struct GZipState map_saveState;
+
+static cc_result MapSave_WriteGZip(struct Stream* stream) {
+	struct Stream compStream;
+	cc_uint32 i, count;
 	cc_result res;
 
-	res = Stream_CreateFile(&stream, path);
-	if (res) { Logger_SysWarn2(res, "creating", path); return; }
-	GZip_MakeStream(&compStream, &state, &stream);
+	GZip_MakeStream(&compStream, &map_saveState, stream);
+	/* Saving is done on a background thread, so can afford to spend longer compressing */
+	Deflate_SetLevel(&map_saveState.Base, DEFLATE_LEVEL_BEST);
+
+	for (i = 0; i < map_save.size; i += count) {
+		map_save.progress = (float)i / map_save.size;
+		count = min(map_save.size - i, MAP_SAVE_CHUNK_SIZE);
+
+		if ((res = Stream_Write(&compStream, map_save.data + i, count))) return res;
+	}
+	return compStream.Close(&compStream);
+}
+
+static cc_result MapSave_DoWrite(const char** place) {
+	struct Stream stream;
+	cc_result res;
+
+	*place = "creating";
+	res = Stream_CreateFile(&stream, &map_save.tmpPath);
+	if (res) return res;
+
+	*place = "encoding";
+	if (map_save.ccr) {
+		/* .ccr compresses the copied blocks itself */
+		res = Ccr_WriteSave(&stream, map_save.data, map_save.size);
+	} else {
+		res = MapSave_WriteGZip(&stream);
+	}
+	if (res) { stream.Close(&stream); return res; }
+
+	*place = "closing";
+	if ((res = stream.Close(&stream))) return res;
 
+	*place = "renaming";
+	return File_Rename(&map_save.tmpPath, &map_save.path);
+}
+
+/* NOTE: Runs on a separate thread */
+static void MapSave_WriteFile(void) {
+	map_save.res  = MapSave_DoWrite(&map_save.place);
+	if (map_save.ccr) Ccr_EndSave();
+	map_save.done = true;
+}
+
+static void MapSave_Start(const cc_string* path, cc_bool background) {
+	static const cc_string cw  = String_FromConst(".cw");
+	static const cc_string ccr = String_FromConst(".ccr");
+	struct Stream stream;
+	cc_uint32 capacity;
+	cc_bool isCw, isCcr;
+	cc_result res;
+
+	isCcr = String_CaselessEnds(path, &ccr);
 #ifdef CC_BUILD_WEB
-	res = Cw_Save(&compStream);
+	isCw = !isCcr;
 #else
-	if (String_CaselessEnds(path, &cw)) {
-		res = Cw_Save(&compStream);
+	isCw = String_CaselessEnds(path, &cw);
+#endif
+
+	if (isCcr) {
+		/* Blocks are copied separately by Ccr_BeginSave */
+		capacity = MAP_SAVE_EXTRA_SIZE;
 	} else {
-		res = Schematic_Save(&compStream);
+		/* Schematic has a data array that's the same size as blocks array */
+		capacity = World.Volume * (isCw && World.Blocks == World.Blocks2 ? 1 : 2) + MAP_SAVE_EXTRA_SIZE;
+	}
+	map_save.data = (cc_uint8*)Mem_TryAlloc(capacity, 1);
+	if (!map_save.data) { Logger_SysWarn2(ERR_OUT_OF_MEMORY, "allocating", path); return; }
+
+	Stream_WriteonlyMemory(&stream, map_save.data, capacity);
+	if (isCcr) {
+		res = Ccr_BeginSave(&stream);
+	} else {
+		res = isCw ? Cw_Save(&stream) : Schematic_Save(&stream);
 	}
-#endif
 
 	if (res) {
-		stream.Close(&stream);
+		Mem_Free(map_save.data);
+		map_save.data = NULL;
 		Logger_SysWarn2(res, "encoding", path); return;
 	}
+	map_save.size = capacity - stream.Meta.Mem.Left;
 
-	if ((res = compStream.Close(&compStream))) {
-		stream.Close(&stream);
-		Logger_SysWarn2(res, "closing", path); return;
-	}
+	String_InitArray(map_save.path,    map_save.pathBuffer);
+	String_InitArray(map_save.tmpPath, map_save.tmpBuffer);
+	String_Copy(&map_save.path, path);
+	String_Format1(&map_save.tmpPath, "%s.tmp", path);
 
-	res = stream.Close(&stream);
-	if (res) { Logger_SysWarn2(res, "closing", path); return; }
+	map_save.ccr         = isCcr;
+	map_save.background  = background;
+	map_save.progress    = 0.0f;
+	map_save.done        = false;
+	map_save.lastPercent = -1;
+	map_save.thread      = Thread_Start(MapSave_WriteFile);
+}
+
+static void SaveLevelScreen_FinishSave(cc_bool showPause) {
+#ifdef CC_BUILD_WEB
+	static const cc_string cw = String_FromConst(".cw");
+#endif
+	Thread_Join(map_save.thread);
+	map_save.thread = NULL;
+	Mem_Free(map_save.data);
+	map_save.data   = NULL;
+
+	if (map_save.res) {
+		Logger_SysWarn2(map_save.res, map_save.place, &map_save.path); return;
+	}
 
 #ifdef CC_BUILD_WEB
-	if (String_CaselessEnds(path, &cw)) {
-		Chat_Add1("&eSaved map to: %s", path);
+	if (String_CaselessEnds(&map_save.path, &cw)) {
+		Chat_Add1("&eSaved map to: %s", &map_save.path);
 	} else {
-		DownloadMap(path);
+		DownloadMap(&map_save.path);
 	}
 #else
-	Chat_Add1("&eSaved map to: %s", path);
+	Chat_Add1("&eSaved map to: %s", &map_save.path);
 #endif
 	World.LastSave = Game.Time;
-	Gui_ShowPauseMenu();
+	if (showPause) Gui_ShowPauseMenu();
+}
+
+static void MapSave_Tick(struct ScheduledTask* task) {
+	if (map_save.data && map_save.background && map_save.done) SaveLevelScreen_FinishSave(false);
+}
+
+cc_bool SaveLevelScreen_SaveMap(const cc_string* path) {
+	static cc_bool addedTask;
+	/* Only one map can be saved at a time */
+	if (map_save.data) return false;
+
+	if (!addedTask) {
+		ScheduledTask_Add(GAME_DEF_TICKS, MapSave_Tick);
+		addedTask = true;
+	}
+	MapSave_Start(path, true);
+	return true;
+}
+
+static void SaveLevelScreen_CheckSave(struct SaveLevelScreen* s) {
+	cc_string str; char strBuffer[STRING_SIZE];
+	int percent;
+
+	if (map_save.done) {
+		TextWidget_SetConst(&s->desc, "", &s->textFont);
+		SaveLevelScreen_FinishSave(true); return;
+	}
+
+	percent = (int)(map_save.progress * 100);
+	if (percent == map_save.lastPercent) return;
+	map_save.lastPercent = percent;
+
+	String_InitArray(str, strBuffer);
+	String_Format1(&str, "&eSaving map.. %i%%", &percent);
+	TextWidget_Set(&s->desc, &str, &s->textFont);
 }
 
 static void SaveLevelScreen_Save(void* screen, void* widget, const char* fmt) {
@@ -1409,6 +1549,9 @@ static void SaveLevelScreen_Save(void* screen, void* widget, const char* fmt) {
 	struct ButtonWidget* btn  = (struct ButtonWidget*)widget;
 	cc_string file = s->input.base.text;
 
+	/* Only one map can be saved at a time */
+	if (map_save.data) return;
+
 	if (!file.length) {
 		TextWidget_SetConst(&s->desc, "&ePlease enter a filename", &s->textFont);
 		return;
@@ -1422,7 +1565,7 @@ static void SaveLevelScreen_Save(void* screen, void* widget, const char* fmt) {
 		SaveLevelScreen_UpdateAlt(s);
 	} else {
 		SaveLevelScreen_RemoveOverwrites(s);
-		SaveLevelScreen_SaveMap(s, &path);
+		MapSave_Start(&path, false);
 	}
 }
 static void SaveLevelScreen_Main(void* a, void* b) { SaveLevelScreen_Save(a, b, "maps/%s.cw"); }
@@ -1442,6 +1585,7 @@ static void SaveLevelScreen_Render(void* screen, double delta) {
 	x = WindowInfo.Width / 2; y = WindowInfo.Height / 2;
 	Gfx_Draw2DFlat(x - 250, y + 90, 500, 2, grey);
 #endif
+	if (map_save.data && !map_save.background) SaveLevelScreen_CheckSave((struct SaveLevelScreen*)screen);
 }
 
 static int SaveLevelScreen_KeyPress(void* screen, char keyChar) {
@@ -1469,6 +1613,12 @@ static int SaveLevelScreen_KeyDown(void* screen, int key) {
 	return Screen_InputDown(s, key);
 }
 
+static void SaveLevelScreen_Free(void* screen) {
+	Menu_CloseKeyboard(screen);
+	/* Menu was closed before saving finished */
+	if (map_save.data && !map_save.background) SaveLevelScreen_FinishSave(false);
+}
+
 static void SaveLevelScreen_ContextLost(void* screen) {
 	struct SaveLevelScreen* s = (struct SaveLevelScreen*)screen;
 	Font_Free(&s->titleFont);
@@ -1545,7 +1695,7 @@ static void SaveLevelScreen_Init(void* screen) {
 }
 
 static const struct ScreenVTABLE SaveLevelScreen_VTABLE = {
-	SaveLevelScreen_Init,    SaveLevelScreen_Update, Menu_CloseKeyboard,
+	SaveLevelScreen_Init,    SaveLevelScreen_Update, SaveLevelScreen_Free,
 	SaveLevelScreen_Render,  Screen_BuildMesh,
 	SaveLevelScreen_KeyDown, Screen_InputUp,   SaveLevelScreen_KeyPress, SaveLevelScreen_TextChanged,
 	Menu_PointerDown,        Screen_PointerUp, Menu_PointerMove,         Screen_TMouseScroll,
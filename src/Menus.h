@@ -25,6 +25,10 @@ void GenLevelScreen_Show(void);
 void ClassicGenScreen_Show(void);
 void LoadLevelScreen_Show(void);
 void SaveLevelScreen_Show(void);
+/* Saves the current map to the given file, without opening the save menu. */
+/* Like saving from the menu, the file is compressed and written on a background thread. */
+/* Returns false if a map is already being saved, as only one map can be saved at a time. */
+cc_bool SaveLevelScreen_SaveMap(const cc_string* path);
 void TexturePackScreen_Show(void);
 void FontListScreen_Show(void);
 void HotkeyListScreen_Show(void);
@@ -25,6 +25,13 @@
 #define OPT_ENTITY_SHADOW "entityshadow"
 #define OPT_RENDER_TYPE "normal"
 #define OPT_SMOOTH_LIGHTING "gfx-smoothlighting"
+#define OPT_GREEDY_MESHING "gfx-greedymeshing"
+#define OPT_BLOCK_LIGHTING "gfx-blocklighting"
+#define OPT_OCCLUSION_CULLING "gfx-occlusionculling"
+#define OPT_PACKED_VERTICES "gfx-packedvertices"
+#define OPT_DYNAMIC_RESOLUTION "gfx-dynamicresolution"
+#define OPT_MIN_RENDER_SCALE "gfx-minrenderscale"
+#define OPT_MAX_RENDER_SCALE "gfx-maxrenderscale"
 #define OPT_MIPMAPS "gfx-mipmaps"
 #define OPT_CHAT_LOGGING "chat-logging"
 #define OPT_WINDOW_WIDTH "window-width"
@@ -73,6 +80,7 @@
 #define OPT_TOUCH_SCALE "gui-touchscale"
 #define OPT_HTTP_ONLY "http-no-https"
 #define OPT_RAW_INPUT "win-raw-input"
+#define OPT_NET_DISPATCH_TIME "net-dispatchtime"
 
 #define LOPT_SESSION  "launcher-session"
 #define LOPT_USERNAME "launcher-cc-username"
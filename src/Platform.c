@@ -475,6 +475,23 @@ cc_result File_Length(cc_file file, cc_uint32* len) {
 	*len = GetFileSize(file, NULL);
 	return *len != INVALID_FILE_SIZE ? 0 : GetLastError();
 }
+
+cc_result File_Rename(const cc_string* src, const cc_string* dst) {
+	WCHAR srcStr[NATIVE_STR_LEN];
+	WCHAR dstStr[NATIVE_STR_LEN];
+	cc_result res;
+	
+	Platform_EncodeUtf16(srcStr, src);
+	Platform_EncodeUtf16(dstStr, dst);
+	if (MoveFileExW(srcStr, dstStr, MOVEFILE_REPLACE_EXISTING)) return 0;
+	if ((res = GetLastError()) != ERROR_CALL_NOT_IMPLEMENTED) return res;
+
+	/* Windows 9x does not support W API functions or MoveFileEx */
+	Platform_Utf16ToAnsi(srcStr);
+	Platform_Utf16ToAnsi(dstStr);
+	DeleteFileA((LPCSTR)dstStr);
+	return MoveFileA((LPCSTR)srcStr, (LPCSTR)dstStr) ? 0 : GetLastError();
+}
 #elif defined CC_BUILD_POSIX
 cc_result Directory_Create(const cc_string* path) {
 	char str[NATIVE_STR_LEN];
@@ -587,6 +604,14 @@ cc_result File_Length(cc_file file, cc_uint32* len) {
 	if (fstat(file, &st) == -1) { *len = -1; return errno; }
 	*len = st.st_size; return 0;
 }
+
+cc_result File_Rename(const cc_string* src, const cc_string* dst) {
+	char srcStr[NATIVE_STR_LEN];
+	char dstStr[NATIVE_STR_LEN];
+	Platform_EncodeUtf8(srcStr, src);
+	Platform_EncodeUtf8(dstStr, dst);
+	return rename(srcStr, dstStr) == -1 ? errno : 0;
+}
 #endif
 
 
@@ -621,6 +646,12 @@ void Thread_Join(void* handle) {
 	Thread_Detach(handle);
 }
 
+int Thread_ProcessorsCount(void) {
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return max(1, (int)info.dwNumberOfProcessors);
+}
+
 void* Mutex_Create(void) {
 	CRITICAL_SECTION* ptr = (CRITICAL_SECTION*)Mem_Alloc(1, sizeof(CRITICAL_SECTION), "mutex");
 	InitializeCriticalSection(ptr);
@@ -662,6 +693,7 @@ void Thread_Sleep(cc_uint32 milliseconds) { }
 void* Thread_Start(Thread_StartFunc func) { func(); return NULL; }
 void Thread_Detach(void* handle) { }
 void Thread_Join(void* handle) { }
+int Thread_ProcessorsCount(void) { return 1; }
 
 void* Mutex_Create(void) { return NULL; }
 void Mutex_Free(void* handle) { }
@@ -715,6 +747,11 @@ void Thread_Join(void* handle) {
 	Mem_Free(ptr);
 }
 
+int Thread_ProcessorsCount(void) {
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+	return count > 0 ? (int)count : 1;
+}
+
 void* Mutex_Create(void) {
 	pthread_mutex_t* ptr = (pthread_mutex_t*)Mem_Alloc(1, sizeof(pthread_mutex_t), "mutex");
 	int res = pthread_mutex_init(ptr, NULL);
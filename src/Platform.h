@@ -181,6 +181,9 @@ cc_result File_Seek(cc_file file, int offset, int seekType);
 cc_result File_Position(cc_file file, cc_uint32* pos);
 /* Attempts to retrieve the length of the given file. */
 cc_result File_Length(cc_file file, cc_uint32* len);
+/* Attempts to rename the given file, replacing the destination file if it already exists. */
+/* NOTE: Where the platform supports it, the destination file is replaced atomically. */
+cc_result File_Rename(const cc_string* src, const cc_string* dst);
 
 /* Blocks the current thread for the given number of milliseconds. */
 CC_API void Thread_Sleep(cc_uint32 milliseconds);
@@ -194,6 +197,8 @@ CC_API void Thread_Detach(void* handle);
 /* Blocks the current thread, until the given thread has finished. */
 /* NOTE: This cannot be used on a thread that has been detached. */
 CC_API void Thread_Join(void* handle);
+/* Returns the number of logical processors available for running threads. (always at least 1) */
+int Thread_ProcessorsCount(void);
 
 /* Allocates a new mutex. (used to synchronise access to a shared resource) */
 CC_API void* Mutex_Create(void);
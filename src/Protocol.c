@@ -170,8 +170,7 @@ static void AddEntity(cc_uint8* data, EntityID id, const cc_string* name, const
 		e = &NetPlayers_List[id].Base;
 
 		NetPlayer_Init((struct NetPlayer*)e);
-		Entities.List[id] = e;
-		Event_RaiseInt(&EntityEvents.Added, id);
+		Entities_Add(id, e);
 	} else {
 		e = &LocalPlayer_Instance.Base;
 	}
@@ -416,38 +415,219 @@ static void MapState_Init(struct MapState* m) {
 	m->allocFailed = false;
 }
 
-static void FreeMapStates(void) {
-	Mem_Free(map.blocks);
-	map.blocks  = NULL;
-#ifdef EXTENDED_BLOCKS
-	Mem_Free(map2.blocks);
-	map2.blocks = NULL;
-#endif
-}
-
-static void MapState_Read(struct MapState* m) {
+/* NOTE: May be called from the map decompression thread */
+static cc_result MapState_Read(struct MapState* m) {
 	cc_uint32 left, read;
 	cc_result res;
-	if (m->allocFailed) return;
+	if (m->allocFailed) return 0;
 
 	if (!m->blocks) {
 		m->blocks = (BlockRaw*)Mem_TryAlloc(map_volume, 1);
 		/* unlikely but possible */
-		if (!m->blocks) {
-			Window_ShowDialog("Out of memory", "Not enough free memory to join that map.\nTry joining a different map.");
-			m->allocFailed = true;
-			return;
-		}
+		if (!m->blocks) { m->allocFailed = true; return 0; }
 	}
 
 	left = map_volume - m->index;
 	res  = m->stream.Read(&m->stream, &m->blocks[m->index], left, &read);
-
-	if (res) DisconnectInvalidMap(res);
 	m->index += read;
+	return res;
+}
+
+/* Decompresses a chunk of map data into the blocks array(s) */
+/* NOTE: May be called from the map decompression thread */
+static cc_result DecodeMapChunk(cc_uint8* data, int length, cc_uint8 value) {
+	cc_uint32 left, read;
+	cc_result res;
+
+	map_part.Meta.Mem.Cur    = data;
+	map_part.Meta.Mem.Base   = data;
+	map_part.Meta.Mem.Left   = length;
+	map_part.Meta.Mem.Length = length;
+
+	if (!map_gzHeader.done) {
+		res = GZipHeader_Read(&map_part, &map_gzHeader);
+		if (res && res != ERR_END_OF_STREAM) return res;
+	}
+	if (!map_gzHeader.done) return 0;
+
+	if (map_sizeIndex < MAP_SIZE_LEN) {
+		left = MAP_SIZE_LEN - map_sizeIndex;
+		res  = map.stream.Read(&map.stream, &map_size[map_sizeIndex], left, &read);
+		if (res) return res;
+
+		map_sizeIndex += read;
+	}
+	if (map_sizeIndex < MAP_SIZE_LEN) return 0;
+	if (!map_volume) map_volume = Stream_GetU32_BE(map_size);
+
+#ifndef EXTENDED_BLOCKS
+	return MapState_Read(&map);
+#else
+	if (cpe_extBlocks && value) return MapState_Read(&map2);
+	return MapState_Read(&map);
+#endif
+}
+
+/* Received map data chunks are queued up and decompressed on a separate thread, */
+/*  so that receiving the rest of the map overlaps with decompressing it */
+#define MAP_QUEUE_SIZE 256
+struct MapChunk { int length; cc_uint8 value; cc_uint8 data[1024]; };
+
+static struct MapChunk* map_queue;
+/* Total number of chunks queued/decoded so far (queue slot is count % MAP_QUEUE_SIZE) */
+static int map_queued, map_decoded;
+static cc_bool map_queueDone, map_queueAbort;
+/* Results of decoding, only updated while holding map_mutex */
+/*  (map_volume itself may be written by the decompression thread, so isn't safe to read) */
+static int map_decodedIndex, map_decodedVolume;
+static cc_result map_decodeRes;
+static void* map_thread;
+static void* map_mutex;
+static void* map_chunksAvailable;
+static void* map_chunksDecoded;
+
+static void MapQueue_WorkerLoop(void) {
+	struct MapChunk* chunk;
+	cc_bool stop, empty;
+	cc_result res;
+
+	for (;;) {
+		Mutex_Lock(map_mutex);
+		{
+			empty = map_decoded == map_queued;
+			stop  = map_queueAbort || (map_queueDone && empty);
+		}
+		Mutex_Unlock(map_mutex);
+
+		if (stop) return;
+		if (empty) { Waitable_Wait(map_chunksAvailable); continue; }
+
+		/* Main thread never writes to a slot until it has been decoded */
+		chunk = &map_queue[map_decoded % MAP_QUEUE_SIZE];
+		res   = DecodeMapChunk(chunk->data, chunk->length, chunk->value);
+
+		Mutex_Lock(map_mutex);
+		{
+			map_decoded++;
+			map_decodedIndex  = map.index;
+			map_decodedVolume = map_volume;
+			if (res && !map_decodeRes) map_decodeRes = res;
+			if (res) map_queueAbort = true;
+		}
+		Mutex_Unlock(map_mutex);
+		Waitable_Signal(map_chunksDecoded);
+	}
+}
+
+static void MapQueue_Start(void) {
+	map_queue = (struct MapChunk*)Mem_TryAlloc(MAP_QUEUE_SIZE, sizeof(struct MapChunk));
+	/* Just decompress on the main thread instead */
+	if (!map_queue) return;
+
+	map_queued     = 0;
+	map_decoded    = 0;
+	map_queueDone  = false;
+	map_queueAbort = false;
+	/* Decompression may have already started on the main thread (e.g. in Classic_LevelInit) */
+	map_decodedIndex  = map.index;
+	map_decodedVolume = map_volume;
+	map_decodeRes     = 0;
+
+	map_mutex           = Mutex_Create();
+	map_chunksAvailable = Waitable_Create();
+	map_chunksDecoded   = Waitable_Create();
+	map_thread          = Thread_Start(MapQueue_WorkerLoop);
+}
+
+/* Waits for the decompression thread to exit, then frees the queue */
+static void MapQueue_Stop(cc_bool abort) {
+	if (!map_thread) return;
+
+	Mutex_Lock(map_mutex);
+	{
+		map_queueDone  = true;
+		map_queueAbort |= abort;
+	}
+	Mutex_Unlock(map_mutex);
+
+	Waitable_Signal(map_chunksAvailable);
+	Thread_Join(map_thread);
+	map_thread = NULL;
+
+	Mutex_Free(map_mutex);
+	Waitable_Free(map_chunksAvailable);
+	Waitable_Free(map_chunksDecoded);
+	Mem_Free(map_queue);
+	map_queue = NULL;
+}
+
+/* Copies the chunk into the queue, waiting for a free slot if the queue is full */
+static cc_result MapQueue_Push(cc_uint8* data, int length, cc_uint8 value) {
+	struct MapChunk* chunk;
+	cc_bool full;
+	cc_result res;
+
+	for (;;) {
+		Mutex_Lock(map_mutex);
+		{
+			full = map_queued - map_decoded >= MAP_QUEUE_SIZE;
+			res  = map_decodeRes;
+		}
+		Mutex_Unlock(map_mutex);
+
+		if (res)  return res;
+		if (!full) break;
+		Waitable_Wait(map_chunksDecoded);
+	}
+
+	chunk = &map_queue[map_queued % MAP_QUEUE_SIZE];
+	chunk->length = length;
+	chunk->value  = value;
+	Mem_Copy(chunk->data, data, length);
+
+	Mutex_Lock(map_mutex);
+	{
+		map_queued++;
+	}
+	Mutex_Unlock(map_mutex);
+	Waitable_Signal(map_chunksAvailable);
+	return 0;
+}
+
+static void MapQueue_GetDecoded(int* index, int* volume) {
+	Mutex_Lock(map_mutex);
+	{
+		*index  = map_decodedIndex;
+		*volume = map_decodedVolume;
+	}
+	Mutex_Unlock(map_mutex);
+}
+
+static void FreeMapStates(void) {
+	MapQueue_Stop(true);
+	Mem_Free(map.blocks);
+	map.blocks  = NULL;
+#ifdef EXTENDED_BLOCKS
+	Mem_Free(map2.blocks);
+	map2.blocks = NULL;
+#endif
+}
+
+static void CheckMapAllocFailed(void) {
+	static cc_bool warned;
+	cc_bool failed = map.allocFailed;
+#ifdef EXTENDED_BLOCKS
+	failed |= map2.allocFailed;
+#endif
+	if (!failed) { warned = false; return; }
+	if (warned) return;
+
+	warned = true;
+	Window_ShowDialog("Out of memory", "Not enough free memory to join that map.\nTry joining a different map.");
 }
 
 static void Classic_StartLoading(void) {
+	MapQueue_Stop(true);
 	World_NewMap();
 	Stream_ReadonlyMemory(&map_part, NULL, 0);
 
@@ -468,9 +648,18 @@ static void Classic_StartLoading(void) {
 }
 
 static void Classic_LevelInit(cc_uint8* data) {
+	cc_result res;
 	if (!map_begunLoading) Classic_StartLoading();
 	if (!cpe_fastMap) return;
 
+	/* Some servers send LevelDataChunk before LevelInit (see Classic_LevelDataChunk), */
+	/*  so the decompression thread must be stopped before its decoding state is changed */
+	if (map_thread) {
+		MapQueue_Stop(false);
+		res = map_decodeRes;
+		if (res) { DisconnectInvalidMap(res); return; }
+	}
+
 	/* Fast map puts volume in header, and uses raw DEFLATE without GZIP header/footer */
 	map_volume    = Stream_GetU32_BE(data);
 	map_gzHeader.done = true;
@@ -478,62 +667,50 @@ static void Classic_LevelInit(cc_uint8* data) {
 }
 
 static void Classic_LevelDataChunk(cc_uint8* data) {
-	int usedLength;
+	int usedLength, index, volume;
 	float progress;
-	cc_uint32 left, read;
 	cc_uint8 value;
 	cc_result res;
 
 	/* Workaround for some servers that send LevelDataChunk before LevelInit due to their async sending behaviour */
 	if (!map_begunLoading) Classic_StartLoading();
 	usedLength = Stream_GetU16_BE(data); data += 2;
+	value      = data[1024]; /* progress in original classic, but we ignore it */
+	if (usedLength > 1024) usedLength = 1024;
 
-	map_part.Meta.Mem.Cur    = data;
-	map_part.Meta.Mem.Base   = data;
-	map_part.Meta.Mem.Left   = usedLength;
-	map_part.Meta.Mem.Length = usedLength;
-
-	data += 1024;
-	value = *data; /* progress in original classic, but we ignore it */
-
-	if (!map_gzHeader.done) {
-		res = GZipHeader_Read(&map_part, &map_gzHeader);
-		if (res && res != ERR_END_OF_STREAM) { DisconnectInvalidMap(res); return; }
-	}
-
-	if (map_gzHeader.done) {
-		if (map_sizeIndex < MAP_SIZE_LEN) {
-			left = MAP_SIZE_LEN - map_sizeIndex;
-			res  = map.stream.Read(&map.stream, &map_size[map_sizeIndex], left, &read); 
+	/* Thread is only started once first chunk arrives, as LevelInit may change decoding state */
+	/* (Not worth using another thread when there is only one processor though) */
+	if (!map_thread && Thread_ProcessorsCount() > 1) MapQueue_Start();
 
-			if (res) { DisconnectInvalidMap(res); return; }
-			map_sizeIndex += read;
-		}
-
-		if (map_sizeIndex == MAP_SIZE_LEN) {
-			if (!map_volume) map_volume = Stream_GetU32_BE(map_size);
-
-#ifndef EXTENDED_BLOCKS
-			MapState_Read(&map);
-#else
-			if (cpe_extBlocks && value) {
-				MapState_Read(&map2);
-			} else {
-				MapState_Read(&map);
-			}
-#endif
-		}
+	if (map_thread) {
+		res = MapQueue_Push(data, usedLength, value);
+		MapQueue_GetDecoded(&index, &volume);
+	} else {
+		res    = DecodeMapChunk(data, usedLength, value);
+		index  = map.index;
+		volume = map_volume;
+		CheckMapAllocFailed();
 	}
+	if (res) { DisconnectInvalidMap(res); return; }
 
-	progress = !map.blocks ? 0.0f : (float)map.index / map_volume;
+	progress = !volume ? 0.0f : (float)index / volume;
 	Event_RaiseFloat(&WorldEvents.Loading, progress);
 }
 
 static void Classic_LevelFinalise(cc_uint8* data) {
 	int width, height, length;
 	cc_uint64 end;
+	cc_result res;
 	int delta;
 
+	/* Wait for the rest of the queued map data to be decompressed */
+	if (map_thread) {
+		MapQueue_Stop(false);
+		res = map_decodeRes;
+		if (res) { DisconnectInvalidMap(res); return; }
+		CheckMapAllocFailed();
+	}
+
 	end   = Stopwatch_Measure();
 	delta = Stopwatch_ElapsedMS(map_receiveBeg, end);
 	Platform_Log1("map loading took: %i", &delta);
@@ -1156,9 +1333,7 @@ static void CPE_ExtAddEntity2(cc_uint8* data) {
 static void CPE_BulkBlockUpdate(cc_uint8* data) {
 	cc_int32 indices[BULK_MAX_BLOCKS];
 	BlockID blocks[BULK_MAX_BLOCKS];
-	int index, i;
-	int x, y, z;
-	int count = 1 + *data++;
+	int i, count = 1 + *data++;
 
 	for (i = 0; i < count; i++) {
 		indices[i] = Stream_GetU32_BE(data); data += 4;
@@ -1181,17 +1356,12 @@ static void CPE_BulkBlockUpdate(cc_uint8* data) {
 		data += BULK_MAX_BLOCKS / 4;
 	}
 
-	for (i = 0; i < count; i++) {
-		index = indices[i];
-		if (index < 0 || index >= World.Volume) continue;
-		World_Unpack(index, x, y, z);
-
 #ifdef EXTENDED_BLOCKS
-		Game_UpdateBlock(x, y, z, blocks[i] % BLOCK_COUNT);
-#else
-		Game_UpdateBlock(x, y, z, blocks[i]);
-#endif
+	for (i = 0; i < count; i++) {
+		blocks[i] %= BLOCK_COUNT;
 	}
+#endif
+	Game_UpdateBlocks(indices, blocks, count);
 }
 
 static void CPE_SetTextColor(cc_uint8* data) {
@@ -23,6 +23,7 @@
 #include "Inventory.h"
 #include "Platform.h"
 #include "Input.h"
+#include "Options.h"
 
 static char nameBuffer[STRING_SIZE];
 static char motdBuffer[STRING_SIZE];
@@ -237,6 +238,151 @@ static cc_uint8 lastOpcode;
 static cc_bool net_connecting;
 static double net_connectTimeout;
 #define NET_TIMEOUT_SECS 15
+/* Maximum time (in microseconds) spent handling received packets each network tick */
+static cc_uint64 net_dispatchTime;
+
+#ifndef CC_BUILD_WEB
+/* Data is received from the socket on a separate thread, so that the socket keeps being drained */
+/*  even when the main thread is busy. Received data is still split up into packets on the main thread, */
+/*  because packet handlers can change Protocol.Sizes (e.g. when CPE extensions are negotiated) */
+#define NET_RECV_QUEUE_SIZE (1024 * 256)
+static cc_uint8* net_recvQueue;
+/* Total number of bytes written to/read from the queue (queue position is count % NET_RECV_QUEUE_SIZE) */
+static cc_uint32 net_recvWritten, net_recvRead;
+static cc_result net_recvResult;
+static cc_bool net_recvClosed, net_recvStop;
+static void* net_recvThread;
+static void* net_recvMutex;
+/* Signalled when the main thread has freed up space in the queue, or wants the thread to stop */
+static void* net_recvWake;
+/* Maximum time (in milliseconds) spent waiting when the socket has no data to read */
+#define NET_RECV_IDLE_MS 4
+
+static void NetRecv_WorkerLoop(void) {
+	cc_uint32 used, offset, count, read;
+	cc_bool stop;
+	cc_result res;
+
+	for (;;) {
+		Mutex_Lock(net_recvMutex);
+		{
+			stop = net_recvStop;
+			used = net_recvWritten - net_recvRead;
+		}
+		Mutex_Unlock(net_recvMutex);
+		if (stop) return;
+
+		/* Only the main thread reads from the used part of the queue, so can write into the free part */
+		offset = net_recvWritten % NET_RECV_QUEUE_SIZE;
+		count  = min(NET_RECV_QUEUE_SIZE - used, NET_RECV_QUEUE_SIZE - offset);
+		/* Queue is full, wait for main thread to catch up */
+		if (!count) { Waitable_Wait(net_recvWake); continue; }
+
+		res = Socket_Read(net_socket, net_recvQueue + offset, count, &read);
+		/* Ignore errors for 'no data available for non-blocking read' */
+		/*  (socket can't be waited on, but the wait still ends early when stopping) */
+		if (res == ReturnCode_SocketInProgess || res == ReturnCode_SocketWouldBlock) {
+			Waitable_WaitFor(net_recvWake, NET_RECV_IDLE_MS); continue;
+		}
+
+		Mutex_Lock(net_recvMutex);
+		{
+			if (res) {
+				net_recvResult = res;
+			} else if (!read) {
+				net_recvClosed = true;
+			} else {
+				net_recvWritten += read;
+			}
+		}
+		Mutex_Unlock(net_recvMutex);
+		if (res || !read) return;
+	}
+}
+
+static void NetRecv_Start(void) {
+	net_recvQueue = (cc_uint8*)Mem_TryAlloc(NET_RECV_QUEUE_SIZE, 1);
+	/* Just read from the socket on the main thread instead */
+	if (!net_recvQueue) return;
+
+	net_recvWritten = 0;
+	net_recvRead    = 0;
+	net_recvResult  = 0;
+	net_recvClosed  = false;
+	net_recvStop    = false;
+
+	net_recvMutex  = Mutex_Create();
+	net_recvWake   = Waitable_Create();
+	net_recvThread = Thread_Start(NetRecv_WorkerLoop);
+}
+
+static void NetRecv_Stop(void) {
+	if (!net_recvThread) return;
+
+	Mutex_Lock(net_recvMutex);
+	{
+		net_recvStop = true;
+	}
+	Mutex_Unlock(net_recvMutex);
+
+	Waitable_Signal(net_recvWake);
+	Thread_Join(net_recvThread);
+	net_recvThread = NULL;
+
+	Mutex_Free(net_recvMutex);
+	Waitable_Free(net_recvWake);
+	Mem_Free(net_recvQueue);
+	net_recvQueue = NULL;
+}
+
+/* Copies up to count bytes of received data from the queue */
+/* NOTE: Errors are only returned once all data received before the error has been read */
+static cc_result NetRecv_Read(cc_uint8* data, cc_uint32 count, cc_uint32* read) {
+	cc_uint32 used, offset, part;
+	cc_result res;
+
+	Mutex_Lock(net_recvMutex);
+	{
+		used = net_recvWritten - net_recvRead;
+		res  = net_recvResult;
+	}
+	Mutex_Unlock(net_recvMutex);
+
+	*read = 0;
+	if (!used) return res;
+	count  = min(count, used);
+	offset = net_recvRead % NET_RECV_QUEUE_SIZE;
+
+	/* Data may wrap around to the start of the queue */
+	part = min(count, NET_RECV_QUEUE_SIZE - offset);
+	Mem_Copy(data,        net_recvQueue + offset, part);
+	Mem_Copy(data + part, net_recvQueue,          count - part);
+
+	Mutex_Lock(net_recvMutex);
+	{
+		net_recvRead += count;
+	}
+	Mutex_Unlock(net_recvMutex);
+	Waitable_Signal(net_recvWake);
+
+	*read = count;
+	return 0;
+}
+
+static cc_bool NetRecv_Closed(void) {
+	cc_bool closed;
+	Mutex_Lock(net_recvMutex);
+	{
+		closed = net_recvClosed;
+	}
+	Mutex_Unlock(net_recvMutex);
+	return closed;
+}
+#else
+static void* net_recvThread;
+static void NetRecv_Start(void) { }
+static void NetRecv_Stop(void)  { }
+#endif
 
 static void OnClose(void);
 static void MPConnection_FinishConnect(void) {
@@ -246,6 +392,7 @@ static void MPConnection_FinishConnect(void) {
 
 	net_readCurrent    = net_readBuffer;
 	Server.WriteBuffer = net_writeBuffer;
+	NetRecv_Start();
 
 	Classic_SendLogin();
 	lastPacket = Game.Time;
@@ -354,6 +501,14 @@ static void MPConnection_CheckDisconnection(void) {
 	int pending = 0;
 	cc_bool poll_read;
 
+#ifndef CC_BUILD_WEB
+	/* Socket is being read from on another thread, so can't reliably check pending data here */
+	if (net_recvThread) {
+		if (net_writeFailed || NetRecv_Closed()) Game_Disconnect(&title, &reason);
+		return;
+	}
+#endif
+
 	availRes  = Socket_Available(net_socket, &pending);
 	/* poll read returns true when socket is closed */
 	selectRes = Socket_Poll(net_socket, SOCKET_POLL_READ, &poll_read);
@@ -376,10 +531,11 @@ static void MPConnection_Tick(struct ScheduledTask* task) {
 	static const cc_string title_lost  = String_FromConst("&eLost connection to the server");
 	static const cc_string reason_err  = String_FromConst("I/O error when reading packets");
 	cc_string msg; char msgBuffer[STRING_SIZE * 2];
-	cc_uint32 pending;
+	cc_uint32 pending, space;
 	cc_uint8* readEnd;
 	Net_Handler handler;
 	int i, remaining;
+	cc_uint64 beg;
 	cc_result res;
 
 	if (Server.Disconnected) return;
@@ -390,18 +546,29 @@ static void MPConnection_Tick(struct ScheduledTask* task) {
 	if (Server.Disconnected) return;
 
 	pending = 0;
-	res     = Socket_Available(net_socket, &pending);
 	readEnd = net_readCurrent; /* todo change to int remaining instead */
+	/* Packets not handled during the last tick may have used up most of the buffer */
+	space   = (cc_uint32)(net_readBuffer + sizeof(net_readBuffer) - net_readCurrent);
 
-	if (!res && pending) {
-		/* NOTE: Always using a read call that is a multiple of 4096 (appears to?) improve read performance */	
-		res = Socket_Read(net_socket, net_readCurrent, 4096 * 4, &pending);
-		/* Ignore errors for 'no data available for non-blocking read' */
-		if (res) {
-			if (res == ReturnCode_SocketInProgess)  return;
-			if (res == ReturnCode_SocketWouldBlock) return;
-		}
+#ifndef CC_BUILD_WEB
+	if (net_recvThread) {
+		res = NetRecv_Read(net_readCurrent, space, &pending);
 		readEnd += pending;
+	} else
+#endif
+	{
+		res = Socket_Available(net_socket, &pending);
+
+		if (!res && pending && space) {
+			/* NOTE: Always using a read call that is a multiple of 4096 (appears to?) improve read performance */	
+			res = Socket_Read(net_socket, net_readCurrent, min(4096 * 4, space), &pending);
+			/* Ignore errors for 'no data available for non-blocking read' */
+			if (res) {
+				if (res == ReturnCode_SocketInProgess)  return;
+				if (res == ReturnCode_SocketWouldBlock) return;
+			}
+			readEnd += pending;
+		}
 	}
 
 	if (res) {
@@ -414,6 +581,8 @@ static void MPConnection_Tick(struct ScheduledTask* task) {
 	}
 
 	net_readCurrent = net_readBuffer;
+	beg = Stopwatch_Measure();
+
 	while (net_readCurrent < readEnd) {
 		cc_uint8 opcode = net_readCurrent[0];
 
@@ -433,6 +602,9 @@ static void MPConnection_Tick(struct ScheduledTask* task) {
 		lastPacket = Game.Time;
 		handler(net_readCurrent + 1); /* skip opcode */
 		net_readCurrent += Protocol.Sizes[opcode];
+
+		/* Leave the rest of the packets until next tick, to avoid a long stall when a lot are received at once */
+		if (Stopwatch_ElapsedMicroseconds(beg, Stopwatch_Measure()) >= net_dispatchTime) break;
 	}
 
 	/* Protocol packets might be split up across TCP packets */
@@ -495,6 +667,7 @@ static void MPConnection_Init(void) {
 
 	net_readCurrent    = net_readBuffer;
 	Server.WriteBuffer = net_writeBuffer;
+	net_dispatchTime   = Options_GetInt(OPT_NET_DISPATCH_TIME, 1, 1000, 10) * 1000;
 }
 
 
@@ -547,6 +720,7 @@ static void OnClose(void) {
 		Ping_Reset();
 		if (Server.Disconnected) return;
 
+		NetRecv_Stop();
 		Socket_Close(net_socket);
 		Server.Disconnected = true;
 	}
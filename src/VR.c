@@ -8,11 +8,13 @@
 
 #include "Constants.h"
 #include "Entity.h"
+#include "ExtMath.h"
 #include "Funcs.h"
 #include "Game.h"
 #include "Graphics.h"
 #include "Input.h"
 #include "Logger.h"
+#include "Options.h"
 #include "Platform.h"
 #include "String.h"
 #include "VRInternal.h"
@@ -22,9 +24,145 @@
 mat4s g_rmat4DevicePose[64 /* k_unMaxTrackedDeviceCount */];
 mat4s g_mat4HMDPose;
 
+// ---------------------- dynamic resolution ----------------------
+// frames that must be rendered well under budget before scale is raised
+#define SCALE_UP_FRAMES 45
+#define SCALE_UP_STEP 0.02f
+// frames to ignore after changing scale, as GPU timings lag behind
+#define SCALE_SETTLE_FRAMES 3
+
+static GLuint g_gpuQueries[2];
+static bool g_gpuQueryPending[2];
+static int g_gpuQueryIndex;
+static cc_uint64 g_frameStart;
+static float g_waitMs, g_cpuMs, g_gpuMs;
+static float g_frameBudgetMs;
+static int g_underBudgetFrames, g_settleFrames;
+
+static void SetupRenderScale() {
+  ETrackedPropertyError propError;
+  float hz = g_pSystem->GetFloatTrackedDeviceProperty(
+      k_unTrackedDeviceIndex_Hmd,
+      ETrackedDeviceProperty_Prop_DisplayFrequency_Float, &propError);
+  if (propError != ETrackedPropertyError_TrackedProp_Success || hz <= 0.0f)
+    hz = 90.0f;
+  g_frameBudgetMs = 1000.0f / hz;
+
+  int minScale = Options_GetInt(OPT_MIN_RENDER_SCALE, 25, 200, 50);
+  int maxScale = Options_GetInt(OPT_MAX_RENDER_SCALE, minScale, 200, 100);
+  g_dynamicResolution = Options_GetBool(OPT_DYNAMIC_RESOLUTION, false);
+
+  // render targets are allocated at max scale, so g_renderScale is relative
+  // to that and goes from min/max up to 1
+  g_maxRenderScale = maxScale / 100.0f;
+  g_minRenderScale = (float)minScale / maxScale;
+  g_renderScale = 1.0f;
+
+  // timer queries are core since OpenGL 3.3
+  if (g_dynamicResolution && (GLEW_VERSION_3_3 || GLEW_ARB_timer_query)) {
+    glGenQueries(2, g_gpuQueries);
+  }
+}
+
+static void BeginFrameTiming() {
+  g_frameStart = Stopwatch_Measure();
+  g_waitMs = 0.0f;
+}
+
+static void EndFrameTiming() {
+  // time spent blocked in WaitGetPoses is not time spent on the frame
+  g_cpuMs = Stopwatch_ElapsedMicroseconds(g_frameStart, Stopwatch_Measure()) /
+            1000.0f - g_waitMs;
+}
+
+// only the eye render passes are timed on the GPU, since they are all that
+// render scale affects. They start after WaitGetPoses has returned, so the
+// compositor wait is never counted.
+static void BeginGpuTiming() {
+  if (!g_gpuQueries[0]) return;
+
+  // result from two frames ago never became available, just discard it
+  g_gpuQueryPending[g_gpuQueryIndex] = false;
+  glBeginQuery(GL_TIME_ELAPSED, g_gpuQueries[g_gpuQueryIndex]);
+}
+
+static void EndGpuTiming() {
+  GLuint64 elapsedNs;
+  GLint available;
+  int prev;
+  if (!g_gpuQueries[0]) return;
+
+  glEndQuery(GL_TIME_ELAPSED);
+  g_gpuQueryPending[g_gpuQueryIndex] = true;
+
+  // read back previous frame's query instead, so the CPU never stalls on it
+  prev = g_gpuQueryIndex ^ 1;
+  g_gpuQueryIndex = prev;
+  if (!g_gpuQueryPending[prev]) return;
+
+  glGetQueryObjectiv(g_gpuQueries[prev], GL_QUERY_RESULT_AVAILABLE, &available);
+  if (!available) return;
+
+  glGetQueryObjectui64v(g_gpuQueries[prev], GL_QUERY_RESULT, &elapsedNs);
+  g_gpuQueryPending[prev] = false;
+  g_gpuMs = elapsedNs / 1000000.0f;
+}
+
+static void UpdateRenderScale() {
+  float scale = g_renderScale;
+  // without timer queries, can only estimate rendering cost from CPU time
+  float renderMs = g_gpuQueries[0] ? g_gpuMs : g_cpuMs;
+
+  if (!g_dynamicResolution) return;
+  if (g_settleFrames > 0) {
+    g_settleFrames--;
+    return;
+  }
+
+  if (renderMs > g_frameBudgetMs * 0.9f) {
+    // cost is roughly proportional to pixels drawn, i.e. square of scale
+    scale *= Math_SqrtF(g_frameBudgetMs * 0.75f / renderMs);
+    g_underBudgetFrames = 0;
+  } else if (renderMs < g_frameBudgetMs * 0.7f &&
+             g_cpuMs < g_frameBudgetMs) {
+    // raise slowly, to avoid oscillating between two scales
+    if (++g_underBudgetFrames < SCALE_UP_FRAMES)
+      return;
+    scale += SCALE_UP_STEP;
+    g_underBudgetFrames = 0;
+  } else {
+    g_underBudgetFrames = 0;
+    return;
+  }
+
+  scale = max(g_minRenderScale, min(scale, 1.0f));
+  if (scale == g_renderScale)
+    return;
+  g_renderScale = scale;
+  g_settleFrames = SCALE_SETTLE_FRAMES;
+}
+
+static int ScaledRenderWidth() {
+  return (int)(g_nRenderWidth * g_renderScale);
+}
+
+static int ScaledRenderHeight() {
+  return (int)(g_nRenderHeight * g_renderScale);
+}
+
+// the compositor samples OpenGL textures with V flipped (V=0 at top of the
+// image), so the rendered bottom-left region of the target ends at V=1
+static VRTextureBounds_t GetEyeBounds(float uMin, float uMax) {
+  VRTextureBounds_t bounds = {uMin, 1.0f - g_renderScale, uMax, 1.0f};
+  return bounds;
+}
+
 void VR_UpdateHMDMatrixPose() {
+  cc_uint64 waitStart = Stopwatch_Measure();
   EVRCompositorError error = g_pCompositor->WaitGetPoses(
       g_rTrackedDevicePose, k_unMaxTrackedDeviceCount, NULL, 0);
+  g_waitMs +=
+      Stopwatch_ElapsedMicroseconds(waitStart, Stopwatch_Measure()) / 1000.0f;
   if (error != EVRCompositorError_VRCompositorError_None &&
       error != EVRCompositorError_VRCompositorError_DoNotHaveFocus) {
     Logger_Abort2(error, "WaitGetPoses");
@@ -167,6 +305,7 @@ void VR_Setup() {
 
   SetupInput();
   SetupCameras();
+  SetupRenderScale();
   SetupStereoRenderTargets();
 }
 
@@ -176,6 +315,24 @@ void RenderCompanionWindow() {
   Gfx_SetTexturing(true);
   struct Texture tex;
 
+  if (Gfx.SinglePassStereo) {
+    // both eyes are already side-by-side in the one texture
+    tex.ID = g_descBothEyes.m_nRenderTextureId;
+    tex.X = 0;
+    tex.Y = 0;
+    tex.Width = Game.Width;
+    tex.Height = Game.Height;
+    tex.uv.U1 = 0;
+    tex.uv.U2 = g_renderScale;
+    tex.uv.V1 = g_renderScale;
+    tex.uv.V2 = 0;
+    Texture_Render(&tex);
+
+    Gfx_SetTexturing(false);
+    Gfx_End2D();
+    return;
+  }
+
   // render left eye (first half of index array )
   tex.ID = g_descLeftEye.m_nRenderTextureId;
   tex.X = 0;
@@ -183,8 +340,8 @@ void RenderCompanionWindow() {
   tex.Width = Game.Width / 2;
   tex.Height = Game.Height;
   tex.uv.U1 = 0;
-  tex.uv.U2 = 1;
-  tex.uv.V1 = 1;
+  tex.uv.U2 = g_renderScale;
+  tex.uv.V1 = g_renderScale;
   tex.uv.V2 = 0;
   Texture_Render(&tex);
 
@@ -195,8 +352,8 @@ void RenderCompanionWindow() {
   tex.Width = Game.Width / 2;
   tex.Height = Game.Height;
   tex.uv.U1 = 0;
-  tex.uv.U2 = 1;
-  tex.uv.V1 = 1;
+  tex.uv.U2 = g_renderScale;
+  tex.uv.V1 = g_renderScale;
   tex.uv.V2 = 0;
   Texture_Render(&tex);
 
@@ -243,34 +400,86 @@ void VR_RenderStereoTargets(void (*RenderScene)(Hmd_Eye nEye,
                                                 float t),
                             double delta,
                             float t) {
+  BeginGpuTiming();
   // Left Eye
   glBindFramebuffer(GL_FRAMEBUFFER, g_descLeftEye.m_nRenderFramebufferId);
-  glViewport(0, 0, g_nRenderWidth, g_nRenderHeight);
+  glViewport(0, 0, ScaledRenderWidth(), ScaledRenderHeight());
   RenderScene(EVREye_Eye_Left, delta, t);
   glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
   // Right Eye
   glBindFramebuffer(GL_FRAMEBUFFER, g_descRightEye.m_nRenderFramebufferId);
-  glViewport(0, 0, g_nRenderWidth, g_nRenderHeight);
+  glViewport(0, 0, ScaledRenderWidth(), ScaledRenderHeight());
   RenderScene(EVREye_Eye_Right, delta, t);
   glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  EndGpuTiming();
 }
 
-void VR_BeginFrame() {
-  UpdateInput();
+void VR_RenderStereoSinglePass(void (*RenderScene)(double delta, float t),
+                               double delta,
+                               float t) {
+  int width = ScaledRenderWidth(), height = ScaledRenderHeight();
+  struct Matrix proj;
+
+  BeginGpuTiming();
+  glBindFramebuffer(GL_FRAMEBUFFER, g_descBothEyes.m_nRenderFramebufferId);
+  glViewport(0, 0, width * 2, height);
+  RenderScene(delta, t);
+
+  // controllers are drawn with raw GL calls, so have to be drawn per eye
+  glViewport(0, 0, width, height);
+  proj = VR_GetProjectionMatrix(EVREye_Eye_Left);
+  Gfx_LoadMatrix(MATRIX_PROJECTION, &proj);
+  VR_RenderControllers(EVREye_Eye_Left);
+
+  glViewport(width, 0, width, height);
+  proj = VR_GetProjectionMatrix(EVREye_Eye_Right);
+  Gfx_LoadMatrix(MATRIX_PROJECTION, &proj);
+  VR_RenderControllers(EVREye_Eye_Right);
+
+  Gfx_LoadMatrix(MATRIX_PROJECTION, &Gfx.Projection);
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  EndGpuTiming();
 }
 
-void VR_EndFrame() {
-  // end RenderStereoTargets();
+static void SubmitBothEyes(void) {
+  VRTextureBounds_t leftBounds = GetEyeBounds(0.0f, g_renderScale * 0.5f);
+  VRTextureBounds_t rightBounds =
+      GetEyeBounds(g_renderScale * 0.5f, g_renderScale);
+  EVRCompositorError error;
+  Texture_t texture = {
+      (void*)(uintptr_t)g_descBothEyes.m_nRenderTextureId,
+      ETextureType_TextureType_OpenGL, EColorSpace_ColorSpace_Gamma};
 
-  RenderCompanionWindow();
+  error = g_pCompositor->Submit(EVREye_Eye_Left, &texture, &leftBounds,
+                                EVRSubmitFlags_Submit_Default);
+  if (error != EVRCompositorError_VRCompositorError_None &&
+      error != EVRCompositorError_VRCompositorError_DoNotHaveFocus) {
+    Logger_Abort2(error, "Submit EVREye_Eye_Left");
+    return;
+  }
 
-  // after RenderCompanionWindow();
+  error = g_pCompositor->Submit(EVREye_Eye_Right, &texture, &rightBounds,
+                                EVRSubmitFlags_Submit_Default);
+  if (error != EVRCompositorError_VRCompositorError_None &&
+      error != EVRCompositorError_VRCompositorError_DoNotHaveFocus) {
+    Logger_Abort2(error, "Submit EVREye_Eye_Right");
+    return;
+  }
+}
+
+void VR_BeginFrame() {
+  BeginFrameTiming();
+  UpdateInput();
+}
+
+static void SubmitEyes(void) {
+  VRTextureBounds_t bounds = GetEyeBounds(0.0f, g_renderScale);
   EVRCompositorError error;
   Texture_t leftEyeTexture = {
       (void*)(uintptr_t)g_descLeftEye.m_nRenderTextureId,
       ETextureType_TextureType_OpenGL, EColorSpace_ColorSpace_Gamma};
-  error = g_pCompositor->Submit(EVREye_Eye_Left, &leftEyeTexture, NULL,
+  error = g_pCompositor->Submit(EVREye_Eye_Left, &leftEyeTexture, &bounds,
                                 EVRSubmitFlags_Submit_Default);
   if (error != EVRCompositorError_VRCompositorError_None &&
       error != EVRCompositorError_VRCompositorError_DoNotHaveFocus) {
@@ -281,7 +490,7 @@ void VR_EndFrame() {
   Texture_t rightEyeTexture = {
       (void*)(uintptr_t)g_descRightEye.m_nRenderTextureId,
       ETextureType_TextureType_OpenGL, EColorSpace_ColorSpace_Gamma};
-  error = g_pCompositor->Submit(EVREye_Eye_Right, &rightEyeTexture, NULL,
+  error = g_pCompositor->Submit(EVREye_Eye_Right, &rightEyeTexture, &bounds,
                                 EVRSubmitFlags_Submit_Default);
   if (error != EVRCompositorError_VRCompositorError_None &&
       error != EVRCompositorError_VRCompositorError_DoNotHaveFocus) {
@@ -290,6 +499,23 @@ void VR_EndFrame() {
   }
 }
 
+void VR_EndFrame() {
+  // end RenderStereoTargets();
+
+  RenderCompanionWindow();
+  EndFrameTiming();
+
+  // after RenderCompanionWindow();
+  if (Gfx.SinglePassStereo) {
+    SubmitBothEyes();
+  } else {
+    SubmitEyes();
+  }
+
+  // only change scale after this frame was submitted with the old scale
+  UpdateRenderScale();
+}
+
 struct Matrix VR_GetViewMatrix() {
   return MatrixFromMat4s(g_mat4HMDPose);
 }
@@ -40,13 +40,20 @@ void VR_Shutdown();
 void VR_BeginFrame();
 
 /* will call `RenderScene` 2 times for left and right eye, call in place of
- * previous scene-render logic */
+ * previous scene-render logic. `RenderScene` should only draw, any per-frame
+ * updates (chunk visibility, picking, input) must be done once beforehand */
 void VR_RenderStereoTargets(void (*RenderScene)(Hmd_Eye nEye,
                                                 double delta,
                                                 float t),
                             double delta,
                             float t);
 
+/* will call `RenderScene` once to draw both eyes side-by-side, using
+ * Gfx_BeginStereo. only available when Gfx.SinglePassStereo is true */
+void VR_RenderStereoSinglePass(void (*RenderScene)(double delta, float t),
+                               double delta,
+                               float t);
+
 /* submits both eye textures to steamvr, call after frame rendered */
 void VR_EndFrame();
 
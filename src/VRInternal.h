@@ -8,6 +8,7 @@
 
 #include "Event.h"
 #include "Game.h"
+#include "Graphics.h"
 #include "Input.h"
 #include "Logger.h"
 #include "VR.h"
@@ -28,6 +29,8 @@ struct FramebufferDesc {
 };
 struct FramebufferDesc g_descLeftEye;
 struct FramebufferDesc g_descRightEye;
+/* side-by-side target for both eyes, only used when Gfx.SinglePassStereo */
+struct FramebufferDesc g_descBothEyes;
 
 struct VR_IVRSystem_FnTable* g_pSystem;
 struct VR_IVRCompositor_FnTable* g_pCompositor;
@@ -36,9 +39,17 @@ struct VR_IVRRenderModels_FnTable* g_pRenderModels;
 
 TrackedDevicePose_t g_rTrackedDevicePose[64 /* k_unMaxTrackedDeviceCount */];
 
+/* size of eye render targets (recommended size scaled by max render scale) */
 uint32_t g_nRenderWidth;
 uint32_t g_nRenderHeight;
 
+/* fraction of eye render targets actually rendered to (see UpdateRenderScale) */
+float g_renderScale = 1.0f;
+float g_minRenderScale = 1.0f;
+/* max render scale relative to recommended render target size */
+float g_maxRenderScale = 1.0f;
+bool g_dynamicResolution;
+
 mat4s g_mat4ProjectionLeft;
 mat4s g_mat4ProjectionRight;
 mat4s g_mat4eyePosLeft;
@@ -164,8 +175,14 @@ static void SetupCameras() {
 
 static void SetupStereoRenderTargets() {
   g_pSystem->GetRecommendedRenderTargetSize(&g_nRenderWidth, &g_nRenderHeight);
-  CreateFrameBuffer(g_nRenderWidth, g_nRenderHeight, &g_descLeftEye);
-  CreateFrameBuffer(g_nRenderWidth, g_nRenderHeight, &g_descRightEye);
+  g_nRenderWidth = (uint32_t)(g_nRenderWidth * g_maxRenderScale);
+  g_nRenderHeight = (uint32_t)(g_nRenderHeight * g_maxRenderScale);
+  if (Gfx.SinglePassStereo) {
+    CreateFrameBuffer(g_nRenderWidth * 2, g_nRenderHeight, &g_descBothEyes);
+  } else {
+    CreateFrameBuffer(g_nRenderWidth, g_nRenderHeight, &g_descLeftEye);
+    CreateFrameBuffer(g_nRenderWidth, g_nRenderHeight, &g_descRightEye);
+  }
 }
 
 static void SetupInput() {
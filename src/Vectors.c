@@ -286,3 +286,42 @@ void FrustumCulling_CalcFrustumEquations(struct Matrix* projection, struct Matri
 #endif
 	FrustumCulling_Normalise(&frustum40, &frustum41, &frustum42, &frustum43);
 }
+
+/* Replaces the plane with the other plane, if the other plane is looser around the given point */
+/* NOTE: The point must be away from where the two planes intersect, otherwise both are ~0 there */
+static void FrustumCulling_Loosen(float* plane0, float* plane1, float* plane2, float* plane3, 
+								float other0, float other1, float other2, float other3, Vec3 pos) {
+	float cur = *plane0 * pos.X + *plane1 * pos.Y + *plane2 * pos.Z + *plane3;
+	float alt = other0  * pos.X + other1  * pos.Y + other2  * pos.Z + other3;
+	if (alt <= cur) return;
+	*plane0 = other0; *plane1 = other1; *plane2 = other2; *plane3 = other3;
+}
+
+void FrustumCulling_CalcStereoFrustumEquations(struct Matrix* leftProj, struct Matrix* rightProj, struct Matrix* modelView, Vec3 pos) {
+	float r00, r01, r02, r03, r20, r21, r22, r23;
+	float r30, r31, r32, r33, r40, r41, r42, r43;
+	float farDist;
+	Vec3 farPos;
+
+	FrustumCulling_CalcFrustumEquations(rightProj, modelView);
+	r00 = frustum00; r01 = frustum01; r02 = frustum02; r03 = frustum03;
+	r20 = frustum20; r21 = frustum21; r22 = frustum22; r23 = frustum23;
+	r30 = frustum30; r31 = frustum31; r32 = frustum32; r33 = frustum33;
+	r40 = frustum40; r41 = frustum41; r42 = frustum42; r43 = frustum43;
+	FrustumCulling_CalcFrustumEquations(leftProj, modelView);
+
+	/* LEFT plane comes from left eye, RIGHT plane comes from right eye */
+	frustum00 = r00; frustum01 = r01; frustum02 = r02; frustum03 = r03;
+	/* The eyes are only offset horizontally, so their other planes are nearly parallel. */
+	/* The top/bottom planes of both eyes pass through (roughly) the viewer position, so they */
+	/*  are compared at the centre of the far plane instead, where the wider plane is furthest out. */
+	/* (FAR plane normal points back towards the viewer, so step against it to reach the far plane) */
+	farDist  = frustum40 * pos.X + frustum41 * pos.Y + frustum42 * pos.Z + frustum43;
+	farPos.X = pos.X - frustum40 * farDist;
+	farPos.Y = pos.Y - frustum41 * farDist;
+	farPos.Z = pos.Z - frustum42 * farDist;
+
+	FrustumCulling_Loosen(&frustum20, &frustum21, &frustum22, &frustum23, r20, r21, r22, r23, farPos);
+	FrustumCulling_Loosen(&frustum30, &frustum31, &frustum32, &frustum33, r30, r31, r32, r33, farPos);
+	FrustumCulling_Loosen(&frustum40, &frustum41, &frustum42, &frustum43, r40, r41, r42, r43, pos);
+}
@@ -134,4 +134,7 @@ void Matrix_LookRot(struct Matrix* result, Vec3 pos, Vec2 rot);
 
 cc_bool FrustumCulling_SphereInFrustum(float x, float y, float z, float radius);
 void FrustumCulling_CalcFrustumEquations(struct Matrix* projection, struct Matrix* modelView);
+/* Calculates a frustum that contains both the left and right eye frustums. */
+/* pos is the viewer position, used to pick the looser of each eye's top/bottom/far planes. */
+void FrustumCulling_CalcStereoFrustumEquations(struct Matrix* leftProj, struct Matrix* rightProj, struct Matrix* modelView, Vec3 pos);
 #endif
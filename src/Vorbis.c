@@ -212,11 +212,14 @@ static float float32_unpack(struct VorbisState* ctx) {
 *----------------------------------------------------Vorbis codebooks-----------------------------------------------------*
 *#########################################################################################################################*/
 #define CODEBOOK_SYNC 0x564342
+#define CODEBOOK_FAST_BITS 10
 struct Codebook {
 	cc_uint32 dimensions, entries, totalCodewords;
 	cc_uint32* codewords;
 	cc_uint32* values;
 	cc_uint32 numCodewords[33]; /* number of codewords of bit length i */
+	cc_uint32 numFastCodewords; /* number of codewords with bit length <= CODEBOOK_FAST_BITS */
+	cc_int16 fast[1 << CODEBOOK_FAST_BITS]; /* Fast lookup table for short codewords */
 	/* vector quantisation values */
 	float minValue, deltaValue;
 	cc_uint32 sequenceP, lookupType, lookupValues;
@@ -314,6 +317,43 @@ static cc_bool Codebook_CalcCodewords(struct Codebook* c, cc_uint8* len) {
 	return true;
 }
 
+static cc_uint32 Codebook_ReverseBits(cc_uint32 n) {
+	n = ((n & 0xAAAAAAAA) >>  1) | ((n & 0x55555555) <<  1);
+	n = ((n & 0xCCCCCCCC) >>  2) | ((n & 0x33333333) <<  2);
+	n = ((n & 0xF0F0F0F0) >>  4) | ((n & 0x0F0F0F0F) <<  4);
+	n = ((n & 0xFF00FF00) >>  8) | ((n & 0x00FF00FF) <<  8);
+	return (n >> 16) | (n << 16);
+}
+
+static void Codebook_CalcFastTable(struct Codebook* c) {
+	cc_uint32 depth, i, j, offset = 0;
+	cc_uint32 index;
+	cc_int16 packed;
+	Mem_Set(c->fast, 0xFF, sizeof(c->fast));
+
+	/* Codewords are stored with first bit read in the highest bit, */
+	/*  so for example assume len = 3 and codeword = 110_00..00 */
+	/* - Bit reverse codeword, as bits are read from lowest bit first */
+	/* - Then, for all the indices from xxxxxxx_011 (i.e. all values of x) */
+	/*   - set fast value to specify an offset into values, and to skip 'len' bits */
+	for (depth = 1; depth <= CODEBOOK_FAST_BITS; depth++) {
+		for (i = 0; i < c->numCodewords[depth]; i++, offset++) {
+			/* only possible with corrupted over-specified trees */
+			if (offset >= (1 << CODEBOOK_FAST_BITS)) {
+				c->numFastCodewords = 0; return;
+			}
+
+			packed = (cc_int16)((depth << CODEBOOK_FAST_BITS) | offset);
+			index  = Codebook_ReverseBits(c->codewords[offset]);
+
+			for (j = index; j < (1 << CODEBOOK_FAST_BITS); j += (1 << depth)) {
+				c->fast[j] = packed;
+			}
+		}
+	}
+	c->numFastCodewords = offset;
+}
+
 static cc_result Codebook_DecodeSetup(struct VorbisState* ctx, struct Codebook* c) {
 	cc_uint32 sync;
 	cc_uint8* codewordLens;
@@ -365,6 +405,7 @@ static cc_result Codebook_DecodeSetup(struct VorbisState* ctx, struct Codebook*
 
 	c->totalCodewords = entry;
 	Codebook_CalcCodewords(c, codewordLens);
+	Codebook_CalcFastTable(c);
 	Mem_Free(codewordLens);
 
 	c->lookupType    = Vorbis_ReadBits(ctx, 4);
@@ -392,12 +433,39 @@ static cc_result Codebook_DecodeSetup(struct VorbisState* ctx, struct Codebook*
 }
 
 static cc_uint32 Codebook_DecodeScalar(struct VorbisState* ctx, struct Codebook* c) {
-	cc_uint32 codeword = 0, shift = 31, depth, i;
+	cc_uint32 codeword = 0, shift = 31, depth = 1, i;
 	cc_uint32* codewords = c->codewords;
 	cc_uint32* values    = c->values;
+	struct OggState* source = ctx->source;
+	int packed;
+
+	/* Buffer as many bits as possible, without going past the end of this packet */
+	while (ctx->NumBits <= 24 && source->left) {
+		Vorbis_PushByte(ctx, *source->cur);
+		source->cur++; source->left--;
+	}
+
+	/* Try fast accelerated table lookup */
+	if (ctx->NumBits >= CODEBOOK_FAST_BITS && c->numFastCodewords) {
+		packed = c->fast[Vorbis_PeekBits(ctx, CODEBOOK_FAST_BITS)];
+		if (packed >= 0) {
+			depth = packed >> CODEBOOK_FAST_BITS;
+			Vorbis_ConsumeBits(ctx, depth);
+			return values[packed & ((1 << CODEBOOK_FAST_BITS) - 1)];
+		}
+
+		/* Codeword must be longer than CODEBOOK_FAST_BITS, so skip past the shorter ones */
+		codeword = Codebook_ReverseBits(Vorbis_PeekBits(ctx, CODEBOOK_FAST_BITS));
+		Vorbis_ConsumeBits(ctx, CODEBOOK_FAST_BITS);
+
+		codewords += c->numFastCodewords;
+		values    += c->numFastCodewords;
+		depth  = CODEBOOK_FAST_BITS + 1;
+		shift -= CODEBOOK_FAST_BITS;
+	}
 
-	/* TODO: This is so massively slow */
-	for (depth = 1; depth <= 32; depth++, shift--) {
+	/* Slow, bit by bit lookup */
+	for (; depth <= 32; depth++, shift--) {
 		codeword |= Vorbis_ReadBit(ctx) << shift;
 
 		for (i = 0; i < c->numCodewords[depth]; i++) {
@@ -1471,6 +1539,11 @@ cc_result Vorbis_DecodeFrame(struct VorbisState* ctx) {
 
 	/* discard remaining bits at end of packet */
 	Vorbis_AlignBits(ctx);
+	/* give back whole bytes that were buffered ahead when decoding codebooks */
+	alignSkip = ctx->NumBits >> 3;
+	ctx->source->cur  -= alignSkip;
+	ctx->source->left += alignSkip;
+	ctx->Bits = 0; ctx->NumBits = 0;
 	return 0;
 }
 